@@ -0,0 +1,252 @@
+// benchmarks for the bgi_* operations
+//
+// build: gcc -O2 -o bigint_bench bigint_bench.c
+// usage: ./bigint_bench [--json] [--max-digits N] [--min-time SECONDS] [--op NAME]
+//
+// every operation is timed over operand sizes from 10 to 10^7 digits, the
+// quadratic ones stop at a smaller size by default. --json prints one object
+// per run that can be diffed between commits
+
+#define _POSIX_C_SOURCE 200809L // clock_gettime and the file API of bigint.h
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// allocations made by the library are counted by routing its calls through
+// these wrappers, stdlib.h is already included so only bigint.h is affected
+static size_t bench_allocs = 0;
+
+static void *bench_malloc(size_t size) {
+    bench_allocs++;
+    return malloc(size);
+}
+
+static void *bench_calloc(size_t n, size_t size) {
+    bench_allocs++;
+    return calloc(n, size);
+}
+
+static void *bench_realloc(void *ptr, size_t size) {
+    bench_allocs++;
+    return realloc(ptr, size);
+}
+
+static void *bench_aligned_alloc(size_t alignment, size_t size) {
+    bench_allocs++;
+    return aligned_alloc(alignment, size);
+}
+
+#define malloc bench_malloc
+#define calloc bench_calloc
+#define realloc bench_realloc
+#define aligned_alloc bench_aligned_alloc
+#include "../bigint.h"
+#undef malloc
+#undef calloc
+#undef realloc
+#undef aligned_alloc
+
+size_t sizes[] = {
+    10,
+    100,
+    1000,
+    10000,
+    100000,
+    1000000,
+    10000000,
+};
+
+typedef struct {
+    BigInt *bi1;
+    BigInt *bi2;
+    const char *text;
+    size_t digits;
+} BenchInput;
+
+typedef struct {
+    const char *name;
+    size_t max_digits; // default cap, the operation gets too slow above it
+    void (*run)(const BenchInput *in);
+} BenchOp;
+
+static void bench_init(const BenchInput *in) {
+    bgi_free(bgi_init(in->text));
+}
+
+static void bench_get_text(const BenchInput *in) {
+    bgi_free_text(bgi_get_text(in->bi1));
+}
+
+static void bench_cmp(const BenchInput *in) {
+    volatile int value = bgi_cmp(in->bi1, in->bi2);
+    (void)value;
+}
+
+static void bench_add(const BenchInput *in) {
+    bgi_free(bgi_add(in->bi1, in->bi2));
+}
+
+static void bench_sub(const BenchInput *in) {
+    bgi_free(bgi_sub(in->bi1, in->bi2));
+}
+
+static void bench_mult(const BenchInput *in) {
+    bgi_free(bgi_mult(in->bi1, in->bi2));
+}
+
+static void bench_div(const BenchInput *in) {
+    bgi_free(bgi_div(in->bi1, in->bi2, in->digits / 2));
+}
+
+static void bench_mul_ui(const BenchInput *in) {
+    bgi_free(bgi_mul_ui(in->bi1, 999999937u));
+}
+
+static void bench_divmod_ui(const BenchInput *in) {
+    uint64_t rem = 0;
+    bgi_free(bgi_divmod_ui(in->bi1, 999999937u, &rem));
+}
+
+static void bench_shift10(const BenchInput *in) {
+    bgi_free(bgi_shift10(in->bi1, -3));
+}
+
+static void bench_xor(const BenchInput *in) {
+    bgi_free(bgi_xor(in->bi1, in->bi2));
+}
+
+static void bench_clone(const BenchInput *in) {
+    bgi_free(bgi_clone(in->bi1));
+}
+
+BenchOp ops[] = {
+    {.name="bgi_init"     , .max_digits=10000000, .run=bench_init},
+    {.name="bgi_get_text" , .max_digits=10000000, .run=bench_get_text},
+    {.name="bgi_cmp"      , .max_digits=10000000, .run=bench_cmp},
+    {.name="bgi_clone"    , .max_digits=10000000, .run=bench_clone},
+    {.name="bgi_add"      , .max_digits=10000000, .run=bench_add},
+    {.name="bgi_sub"      , .max_digits=10000000, .run=bench_sub},
+    {.name="bgi_shift10"  , .max_digits=10000000, .run=bench_shift10},
+    {.name="bgi_mul_ui"   , .max_digits=10000000, .run=bench_mul_ui},
+    {.name="bgi_divmod_ui", .max_digits=10000000, .run=bench_divmod_ui},
+    {.name="bgi_xor"      , .max_digits=100000  , .run=bench_xor},
+    {.name="bgi_mult"     , .max_digits=100000  , .run=bench_mult},
+    {.name="bgi_div"      , .max_digits=10000   , .run=bench_div},
+};
+
+static double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// random digits with a non zero leading digit, the same seed gives the same text
+static char *bench_digits(size_t digits, uint64_t seed) {
+    char *text = (char*)malloc(digits + 1);
+    if (text == NULL) {
+        return NULL;
+    }
+    for (size_t i = 0; i < digits; i++) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        text[i] = '0' + (char)((seed >> 33) % 10);
+    }
+    if (text[0] == '0') {
+        text[0] = '1';
+    }
+    text[digits] = '\0';
+    return text;
+}
+
+int main(int argc, char **argv) {
+    bool json = false;
+    size_t max_digits = 10000000;
+    double min_time = 0.2;
+    const char *only = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (strcmp(argv[i], "--max-digits") == 0 && i + 1 < argc) {
+            max_digits = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            min_time = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--op") == 0 && i + 1 < argc) {
+            only = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--json] [--max-digits N] [--min-time SECONDS] [--op NAME]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (json) {
+        printf("{\"benchmarks\": [");
+    } else {
+        printf("%-14s %10s %12s %16s %14s %12s\n", "op", "digits", "iterations", "ns/op", "digits/sec", "allocs/op");
+    }
+
+    bool first = true;
+    for (size_t s = 0; s < sizeof(sizes)/sizeof(size_t); s++) {
+        size_t digits = sizes[s];
+        if (digits > max_digits) {
+            break;
+        }
+
+        char *text1 = bench_digits(digits, 1);
+        char *text2 = bench_digits(digits, 2);
+        if (text1 == NULL || text2 == NULL) {
+            fprintf(stderr, "operand allocation failed for %zu digits\n", digits);
+            return 1;
+        }
+        BenchInput in = {.bi1=bgi_init(text1), .bi2=bgi_init(text2), .text=text1, .digits=digits};
+
+        for (size_t o = 0; o < sizeof(ops)/sizeof(BenchOp); o++) {
+            BenchOp op = ops[o];
+            if (digits > op.max_digits || (only != NULL && strcmp(only, op.name) != 0)) {
+                continue;
+            }
+
+            // one warm up call, then batches that double until min_time is reached
+            op.run(&in);
+            size_t iterations = 0;
+            size_t batch = 1;
+            size_t allocs = bench_allocs;
+            double start = bench_now();
+            double elapsed = 0;
+            do {
+                for (size_t i = 0; i < batch; i++) {
+                    op.run(&in);
+                }
+                iterations += batch;
+                batch *= 2;
+                elapsed = bench_now() - start;
+            } while (elapsed < min_time);
+            allocs = bench_allocs - allocs;
+
+            double ns_per_op      = elapsed * 1e9 / iterations;
+            double digits_per_sec = digits * iterations / elapsed;
+            double allocs_per_op  = (double)allocs / iterations;
+
+            if (json) {
+                printf("%s\n  {\"op\": \"%s\", \"digits\": %zu, \"iterations\": %zu, \"ns_per_op\": %.1f, \"digits_per_sec\": %.1f, \"allocs_per_op\": %.2f}",
+                    first ? "" : ",", op.name, digits, iterations, ns_per_op, digits_per_sec, allocs_per_op);
+            } else {
+                printf("%-14s %10zu %12zu %16.1f %14.4g %12.2f\n", op.name, digits, iterations, ns_per_op, digits_per_sec, allocs_per_op);
+            }
+            fflush(stdout);
+            first = false;
+        }
+
+        bgi_free(in.bi1);
+        bgi_free(in.bi2);
+        free(text1);
+        free(text2);
+    }
+
+    if (json) {
+        printf("\n]}\n");
+    }
+
+    bgi_scratch_free();
+    return 0;
+}
@@ -0,0 +1,187 @@
+// threshold tuning for bgi_mult and bgi_div
+//
+// build: gcc -O2 -o bigint_tune bigint_tune.c
+// usage: ./bigint_tune [--min-time SECONDS] [--max-digits N] > bigint_thresholds.h
+//
+// every size of the sweep is multiplied once with schoolbook and once with a
+// single karatsuba level on top of schoolbook, the threshold is the first size
+// from which karatsuba keeps winning. divisions of 2*size by size digits are
+// timed the same way with schoolbook long division against newton. the header is written to stdout and the
+// measurements to stderr, the library picks the header up with
+// -DBIGINT_THRESHOLDS_FILE='"bigint_thresholds.h"'
+
+#define _POSIX_C_SOURCE 200809L // clock_gettime and the file API of bigint.h
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../bigint.h"
+
+size_t sizes[] = {
+    8,
+    12,
+    16,
+    24,
+    32,
+    48,
+    64,
+    96,
+    128,
+    192,
+    256,
+    384,
+    512,
+    768,
+    1024,
+    1536,
+    2048,
+    3072,
+    4096,
+};
+
+typedef struct {
+    const char *name;
+    const char *fast; // algorithm used from the threshold on
+    const char *macro;
+    BgiThreshold threshold;
+    bool square;
+    bool divide;
+} TuneKind;
+
+TuneKind kinds[] = {
+    {.name="mult", .fast="karatsuba", .macro="BGI_MULT_KARATSUBA_THRESHOLD", .threshold=BGI_THRESHOLD_MULT_KARATSUBA, .square=false, .divide=false},
+    {.name="sqr" , .fast="karatsuba", .macro="BGI_SQR_KARATSUBA_THRESHOLD" , .threshold=BGI_THRESHOLD_SQR_KARATSUBA , .square=true , .divide=false},
+    {.name="div" , .fast="newton"   , .macro="BGI_DIV_NEWTON_THRESHOLD"    , .threshold=BGI_THRESHOLD_DIV_NEWTON    , .square=false, .divide=true},
+};
+
+// the fast algorithm has to win this many sizes in a row, single wins are often noise
+#define TUNE_CONFIRM 2
+
+static double tune_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// random digits with a non zero leading digit, the same seed gives the same text
+static char *tune_digits(size_t digits, uint64_t seed) {
+    char *text = (char*)malloc(digits + 1);
+    if (text == NULL) {
+        return NULL;
+    }
+    for (size_t i = 0; i < digits; i++) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        text[i] = '0' + (char)((seed >> 33) % 10);
+    }
+    if (text[0] == '0') {
+        text[0] = '1';
+    }
+    text[digits] = '\0';
+    return text;
+}
+
+static BigInt *tune_run(const TuneKind *kind, const BigInt *bi1, const BigInt *bi2) {
+    return kind->divide ? bgi_div(bi1, bi2, 0) : bgi_mult(bi1, bi2);
+}
+
+// ns per operation with the given threshold, batches double until min_time is reached
+static double tune_time(const TuneKind *kind, size_t threshold, const BigInt *bi1, const BigInt *bi2, double min_time) {
+    bgi_set_threshold(kind->threshold, threshold);
+    bgi_free(tune_run(kind, bi1, bi2));
+
+    size_t iterations = 0;
+    size_t batch = 1;
+    double start = tune_now();
+    double elapsed = 0;
+    do {
+        for (size_t i = 0; i < batch; i++) {
+            bgi_free(tune_run(kind, bi1, bi2));
+        }
+        iterations += batch;
+        batch *= 2;
+        elapsed = tune_now() - start;
+    } while (elapsed < min_time);
+
+    return elapsed * 1e9 / iterations;
+}
+
+int main(int argc, char **argv) {
+    double min_time = 0.05;
+    size_t max_digits = 4096;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            min_time = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--max-digits") == 0 && i + 1 < argc) {
+            max_digits = strtoull(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr, "usage: %s [--min-time SECONDS] [--max-digits N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    size_t found[sizeof(kinds)/sizeof(TuneKind)] = {0};
+
+    for (size_t k = 0; k < sizeof(kinds)/sizeof(TuneKind); k++) {
+        TuneKind kind = kinds[k];
+        fprintf(stderr, "%-6s %10s %16s %13s ns\n", kind.name, "digits", "schoolbook ns", kind.fast);
+
+        size_t candidate = 0;
+        size_t wins = 0;
+        for (size_t s = 0; s < sizeof(sizes)/sizeof(size_t) && sizes[s] <= max_digits; s++) {
+            size_t digits = sizes[s];
+
+            // the dividend has twice the digits, so the quotient is as long as the divisor
+            char *text1 = tune_digits(kind.divide ? 2*digits : digits, 1);
+            char *text2 = tune_digits(digits, 2);
+            if (text1 == NULL || text2 == NULL) {
+                fprintf(stderr, "operand allocation failed for %zu digits\n", digits);
+                return 1;
+            }
+            BigInt *bi1 = bgi_init(text1);
+            BigInt *bi2 = kind.square ? bgi_clone(bi1) : bgi_init(text2);
+
+            // threshold digits+1 keeps schoolbook, threshold digits splits once
+            // and the halves fall back to schoolbook. newton is used for the
+            // whole division, its multiplications keep the tuned thresholds
+            double schoolbook = tune_time(&kinds[k], digits + 1, bi1, bi2, min_time);
+            double fast       = tune_time(&kinds[k], digits, bi1, bi2, min_time);
+            fprintf(stderr, "%-6s %10zu %16.1f %16.1f\n", kind.name, digits, schoolbook, fast);
+
+            if (fast < schoolbook) {
+                if (wins == 0) {
+                    candidate = digits;
+                }
+                wins++;
+            } else {
+                wins = 0;
+            }
+
+            bgi_free(bi1);
+            bgi_free(bi2);
+            free(text1);
+            free(text2);
+
+            if (wins >= TUNE_CONFIRM) {
+                break;
+            }
+        }
+
+        // the fast algorithm never won inside the sweep, keep schoolbook up to its end
+        found[k] = wins > 0 ? candidate : max_digits;
+        bgi_set_threshold(kind.threshold, found[k]);
+        fprintf(stderr, "\n");
+    }
+
+    printf("// generated by benchmarks/bigint_tune.c, min time %g seconds\n", min_time);
+    printf("#ifndef BIGINT_THRESHOLDS_H\n");
+    printf("#define BIGINT_THRESHOLDS_H\n\n");
+    for (size_t k = 0; k < sizeof(kinds)/sizeof(TuneKind); k++) {
+        printf("#define %s %zu\n", kinds[k].macro, found[k]);
+    }
+    printf("\n#endif\n");
+
+    bgi_scratch_free();
+    return 0;
+}
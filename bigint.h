@@ -1,11 +1,69 @@
 #ifndef _BIGINT_ 
 #define _BIGINT_
 
+// pread, pwrite, fileno and ftruncate of the file API are POSIX.1-2008 and
+// hidden by strict -std=c11 builds. this only takes effect when bigint.h is
+// included before any system header, otherwise define _POSIX_C_SOURCE=200809L
+// on the command line. the other order stops at the #error below
+#if !defined(_POSIX_C_SOURCE) && !defined(_XOPEN_SOURCE) && !defined(_GNU_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <limits.h>
 #include <string.h>
+#include <stdint.h>
+
+#ifdef BIGINT_THREADS_ENABLED
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#endif
+
+#ifdef BIGINT_STATS_ENABLED
+#include <time.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define BGI_POSIX_FILES
+#if (defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE < 200809L) || (defined(__GLIBC__) && !defined(__USE_XOPEN2K8))
+#error "bigint.h needs POSIX.1-2008, include it before any system header or define _POSIX_C_SOURCE=200809L"
+#endif
+#endif
+
+#ifdef BIGINT_TRACE_ENABLED
+#include <time.h>
+#if defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define BGI_TRACE_USDT
+#endif
+#endif
+#endif
+
+// algorithm crossover points in digits, a header generated by
+// benchmarks/bigint_tune.c is used with -DBIGINT_THRESHOLDS_FILE='"bigint_thresholds.h"'
+#ifdef BIGINT_THRESHOLDS_FILE
+#include BIGINT_THRESHOLDS_FILE
+#endif
+
+#ifndef BGI_MULT_KARATSUBA_THRESHOLD
+#define BGI_MULT_KARATSUBA_THRESHOLD 48
+#endif
+
+#ifndef BGI_SQR_KARATSUBA_THRESHOLD
+#define BGI_SQR_KARATSUBA_THRESHOLD 32
+#endif
+
+#ifndef BGI_DIV_NEWTON_THRESHOLD
+#define BGI_DIV_NEWTON_THRESHOLD 128
+#endif
 
 
 // assertion
@@ -23,6 +81,623 @@ do {
 #define bgi_assert(c, m)
 #endif
 
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define BGI_THREAD_LOCAL _Thread_local
+#else
+#define BGI_THREAD_LOCAL __thread
+#endif
+
+
+// statistics
+//
+// with BIGINT_STATS_ENABLED the library counts calls, operand sizes, time and
+// allocations. every thread counts into its own BgiStats without locking and
+// bgi_stats_snapshot merges them. without the flag the hooks compile to nothing
+// and the snapshot stays zero. the hooks need the gcc/clang cleanup attribute
+
+#define BGI_STATS_OPS(X) \
+    X(BGI_STATS_INIT, "bgi_init") \
+    X(BGI_STATS_GET_TEXT, "bgi_get_text") \
+    X(BGI_STATS_CLONE, "bgi_clone") \
+    X(BGI_STATS_CMP, "bgi_cmp") \
+    X(BGI_STATS_ADD, "bgi_add") \
+    X(BGI_STATS_SUB, "bgi_sub") \
+    X(BGI_STATS_MULT, "bgi_mult") \
+    X(BGI_STATS_DIV, "bgi_div") \
+    X(BGI_STATS_MUL_UI, "bgi_mul_ui") \
+    X(BGI_STATS_DIVMOD_UI, "bgi_divmod_ui") \
+    X(BGI_STATS_SHIFT10, "bgi_shift10") \
+
+typedef enum {
+#define X(name, label) name,
+    BGI_STATS_OPS(X)
+#undef X
+    BGI_STATS_OP_COUNT,
+} BgiStatsOp;
+
+// operand sizes are counted per power of ten, the last bucket takes the rest
+#define BGI_STATS_BUCKETS 8
+
+typedef struct {
+    uint64_t calls;
+    uint64_t cycles;                     // inclusive, nested calls are counted twice
+    uint64_t digits[BGI_STATS_BUCKETS];  // digits[k] counts operands below 10^(k+1) digits
+} BgiStatsOpCounters;
+
+// only holds uint64_t counters, they are merged as one array
+typedef struct {
+    BgiStatsOpCounters ops[BGI_STATS_OP_COUNT];
+    uint64_t allocs;          // list buffers, digits structs, scratch blocks and texts
+    uint64_t bytes_allocated;
+    uint64_t list_reallocs;   // buffer growth of list_append and friends
+} BgiStats;
+
+const char *bgi_stats_op_name(BgiStatsOp op);
+void bgi_stats_snapshot(BgiStats *stats);
+void bgi_stats_reset(void);
+
+const char *bgi_stats_op_name(BgiStatsOp op) {
+#define X(name, label) case name: return label;
+    switch (op) {
+        BGI_STATS_OPS(X)
+        default:
+            return "unknown";
+    }
+#undef X
+}
+
+#ifdef BIGINT_STATS_ENABLED
+
+#define BGI_STATS_COUNTERS (sizeof(BgiStats) / sizeof(uint64_t))
+
+static BgiStats bgi_stats_exited;  // threads that are gone, the only counters without threads
+static BgiStats bgi_stats_base;    // totals at the last bgi_stats_reset
+
+#ifdef BIGINT_THREADS_ENABLED
+typedef struct BgiStatsThread {
+    BgiStats stats;
+    struct BgiStatsThread *next;
+} BgiStatsThread;
+
+static pthread_mutex_t bgi_stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t   bgi_stats_key;
+static pthread_once_t  bgi_stats_key_once = PTHREAD_ONCE_INIT;
+static BgiStatsThread *bgi_stats_threads  = NULL;
+static BGI_THREAD_LOCAL BgiStatsThread *bgi_stats_self = NULL;
+
+// folds the counters of an exiting thread into bgi_stats_exited
+static void bgi_stats_thread_exit(void *arg) {
+    BgiStatsThread *self = (BgiStatsThread*)arg;
+    pthread_mutex_lock(&bgi_stats_lock);
+    uint64_t *from = (uint64_t*)&self->stats;
+    uint64_t *into = (uint64_t*)&bgi_stats_exited;
+    for (size_t i = 0; i < BGI_STATS_COUNTERS; i++) {
+        into[i] += __atomic_load_n(&from[i], __ATOMIC_RELAXED);
+    }
+    for (BgiStatsThread **link = &bgi_stats_threads; *link != NULL; link = &(*link)->next) {
+        if (*link == self) {
+            *link = self->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&bgi_stats_lock);
+    bgi_stats_self = NULL;
+    free(self);
+}
+
+static void bgi_stats_make_key(void) {
+    pthread_key_create(&bgi_stats_key, bgi_stats_thread_exit);
+}
+#endif
+
+static BgiStats *bgi_stats_local(void) {
+#ifdef BIGINT_THREADS_ENABLED
+    if (bgi_stats_self == NULL) {
+        BgiStatsThread *self = (BgiStatsThread*)calloc(1, sizeof(BgiStatsThread));
+        if (self == NULL) {
+            return NULL;
+        }
+        pthread_once(&bgi_stats_key_once, bgi_stats_make_key);
+        pthread_mutex_lock(&bgi_stats_lock);
+        self->next = bgi_stats_threads;
+        bgi_stats_threads = self;
+        pthread_mutex_unlock(&bgi_stats_lock);
+        pthread_setspecific(bgi_stats_key, self);
+        bgi_stats_self = self;
+    }
+    return &bgi_stats_self->stats;
+#else
+    return &bgi_stats_exited;
+#endif
+}
+
+// only the owning thread writes its counters, readers merge them under bgi_stats_lock
+static inline void bgi_stats_count(uint64_t *counter, uint64_t value) {
+#ifdef BIGINT_THREADS_ENABLED
+    __atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + value, __ATOMIC_RELAXED);
+#else
+    *counter += value;
+#endif
+}
+
+static inline uint64_t bgi_stats_clock(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+typedef struct {
+    BgiStatsOp op;
+    uint64_t start;
+} BgiStatsScope;
+
+static inline BgiStatsScope bgi_stats_begin(BgiStatsOp op, size_t digits) {
+    BgiStats *stats = bgi_stats_local();
+    if (stats != NULL) {
+        size_t bucket = 0;
+        for (size_t limit = 10; bucket < BGI_STATS_BUCKETS - 1 && digits >= limit; limit *= 10) {
+            bucket++;
+        }
+        bgi_stats_count(&stats->ops[op].calls, 1);
+        bgi_stats_count(&stats->ops[op].digits[bucket], 1);
+    }
+    BgiStatsScope scope = {op, bgi_stats_clock()};
+    return scope;
+}
+
+static inline void bgi_stats_end(BgiStatsScope *scope) {
+    BgiStats *stats = bgi_stats_local();
+    if (stats != NULL) {
+        bgi_stats_count(&stats->ops[scope->op].cycles, bgi_stats_clock() - scope->start);
+    }
+}
+
+static inline void bgi_stats_alloc(size_t bytes, bool realloced) {
+    BgiStats *stats = bgi_stats_local();
+    if (stats != NULL) {
+        bgi_stats_count(&stats->allocs, 1);
+        bgi_stats_count(&stats->bytes_allocated, bytes);
+        if (realloced) {
+            bgi_stats_count(&stats->list_reallocs, 1);
+        }
+    }
+}
+
+// counts the call until the enclosing function returns
+#define BGI_STATS_SCOPE(op, digits) \
+    BgiStatsScope bgi_stats_scope __attribute__((cleanup(bgi_stats_end))) = bgi_stats_begin(op, digits)
+#define BGI_STATS_ALLOC(bytes)   bgi_stats_alloc(bytes, false)
+#define BGI_STATS_REALLOC(bytes) bgi_stats_alloc(bytes, true)
+
+// counters of all threads since the start, callers hold bgi_stats_lock
+static void bgi_stats_totals(BgiStats *stats) {
+    memcpy(stats, &bgi_stats_exited, sizeof(BgiStats));
+#ifdef BIGINT_THREADS_ENABLED
+    uint64_t *into = (uint64_t*)stats;
+    for (BgiStatsThread *thread = bgi_stats_threads; thread != NULL; thread = thread->next) {
+        uint64_t *from = (uint64_t*)&thread->stats;
+        for (size_t i = 0; i < BGI_STATS_COUNTERS; i++) {
+            into[i] += __atomic_load_n(&from[i], __ATOMIC_RELAXED);
+        }
+    }
+#endif
+}
+
+#else
+
+#define BGI_STATS_SCOPE(op, digits) do {} while (0)
+#define BGI_STATS_ALLOC(bytes)      do {} while (0)
+#define BGI_STATS_REALLOC(bytes)    do {} while (0)
+
+#endif
+
+// counters of all threads since the last bgi_stats_reset
+void bgi_stats_snapshot(BgiStats *stats) {
+    bgi_assert(stats != NULL, "stats cannot be NULL");
+
+    if (stats == NULL) {
+        return;
+    }
+
+    memset(stats, 0, sizeof(BgiStats));
+#ifdef BIGINT_STATS_ENABLED
+#ifdef BIGINT_THREADS_ENABLED
+    pthread_mutex_lock(&bgi_stats_lock);
+#endif
+    bgi_stats_totals(stats);
+    uint64_t *into = (uint64_t*)stats;
+    const uint64_t *base = (const uint64_t*)&bgi_stats_base;
+    for (size_t i = 0; i < BGI_STATS_COUNTERS; i++) {
+        into[i] -= base[i];
+    }
+#ifdef BIGINT_THREADS_ENABLED
+    pthread_mutex_unlock(&bgi_stats_lock);
+#endif
+#endif
+}
+
+// threads keep counting, the reset moves the baseline the snapshot subtracts
+void bgi_stats_reset(void) {
+#ifdef BIGINT_STATS_ENABLED
+#ifdef BIGINT_THREADS_ENABLED
+    pthread_mutex_lock(&bgi_stats_lock);
+#endif
+    bgi_stats_totals(&bgi_stats_base);
+#ifdef BIGINT_THREADS_ENABLED
+    pthread_mutex_unlock(&bgi_stats_lock);
+#endif
+#endif
+}
+
+
+// tracing
+//
+// with BIGINT_TRACE_ENABLED the operations of BGI_STATS_OPS report their entry
+// and exit to a hook installed with bgi_trace_set_hook, and to the
+// bigint:op__entry and bigint:op__return usdt probes when sys/sdt.h exists.
+// while no hook is installed a probe costs one branch. bgi_trace_chrome_open
+// installs a hook that writes a chrome trace json file
+
+typedef enum {
+    BGI_TRACE_BEGIN,
+    BGI_TRACE_END,
+} BgiTracePhase;
+
+// the algorithm an operation used, only known at its end
+typedef enum {
+    BGI_TRACE_TIER_NONE,
+    BGI_TRACE_TIER_SCHOOLBOOK,
+    BGI_TRACE_TIER_KARATSUBA,
+    BGI_TRACE_TIER_KARATSUBA_SQR,
+    BGI_TRACE_TIER_NEWTON,
+} BgiTraceTier;
+
+typedef struct {
+    BgiStatsOp op;
+    BgiTracePhase phase;
+    BgiTraceTier tier;
+    size_t len1;       // digits of the operands, 0 when there is no second one
+    size_t len2;
+    uint64_t time_ns;  // monotonic clock
+} BgiTraceEvent;
+
+typedef void (*BgiTraceHook)(const BgiTraceEvent *event, void *data);
+
+const char *bgi_trace_tier_name(BgiTraceTier tier);
+void bgi_trace_set_hook(BgiTraceHook hook, void *data);
+bool bgi_trace_chrome_open(const char *path);
+void bgi_trace_chrome_close(void);
+
+const char *bgi_trace_tier_name(BgiTraceTier tier) {
+    switch (tier) {
+        case BGI_TRACE_TIER_NONE:          return "none";
+        case BGI_TRACE_TIER_SCHOOLBOOK:    return "schoolbook";
+        case BGI_TRACE_TIER_KARATSUBA:     return "karatsuba";
+        case BGI_TRACE_TIER_KARATSUBA_SQR: return "karatsuba_sqr";
+        case BGI_TRACE_TIER_NEWTON:        return "newton";
+        default:
+            return "unknown";
+    }
+}
+
+#ifdef BIGINT_TRACE_ENABLED
+
+// the hook and its data are published together through one pointer so a
+// reader never pairs a new hook with the old data. targets are immutable once
+// published and never freed, a reader may still be copying a replaced one
+typedef struct BgiTraceTarget {
+    BgiTraceHook hook;
+    void *data;
+    struct BgiTraceTarget *next; // replaced targets, reused when set again
+} BgiTraceTarget;
+
+static BgiTraceTarget *bgi_trace_target  = NULL;
+static BgiTraceTarget *bgi_trace_retired = NULL;
+#ifdef BIGINT_THREADS_ENABLED
+static pthread_mutex_t bgi_trace_target_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+typedef struct {
+    BgiTraceHook hook; // target seen at the entry, the exit goes to the same one
+    void *data;
+    BgiStatsOp op;
+    BgiTraceTier tier;
+    size_t len1;
+    size_t len2;
+} BgiTraceScope;
+
+static inline uint64_t bgi_trace_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void bgi_trace_emit(const BgiTraceScope *scope, BgiTracePhase phase) {
+    BgiTraceEvent event = {scope->op, phase, scope->tier, scope->len1, scope->len2, bgi_trace_now()};
+    scope->hook(&event, scope->data);
+}
+
+static inline BgiTraceScope bgi_trace_begin(BgiStatsOp op, size_t len1, size_t len2) {
+#ifdef BIGINT_THREADS_ENABLED
+    const BgiTraceTarget *target = __atomic_load_n(&bgi_trace_target, __ATOMIC_ACQUIRE);
+#else
+    const BgiTraceTarget *target = bgi_trace_target;
+#endif
+    BgiTraceScope scope = {NULL, NULL, op, BGI_TRACE_TIER_NONE, len1, len2};
+    if (__builtin_expect(target != NULL, 0)) {
+        scope.hook = target->hook;
+        scope.data = target->data;
+    }
+#ifdef BGI_TRACE_USDT
+    DTRACE_PROBE3(bigint, op__entry, (int)op, len1, len2);
+#endif
+    if (__builtin_expect(scope.hook != NULL, 0)) {
+        bgi_trace_emit(&scope, BGI_TRACE_BEGIN);
+    }
+    return scope;
+}
+
+static inline void bgi_trace_end(BgiTraceScope *scope) {
+#ifdef BGI_TRACE_USDT
+    DTRACE_PROBE2(bigint, op__return, (int)scope->op, (int)scope->tier);
+#endif
+    if (__builtin_expect(scope->hook != NULL, 0)) {
+        bgi_trace_emit(scope, BGI_TRACE_END);
+    }
+}
+
+// traces the call until the enclosing function returns, the operand lengths
+// are only computed by the caller's expression when tracing is compiled in
+#define BGI_TRACE_SCOPE(op, len1, len2) \
+    BgiTraceScope bgi_trace_scope __attribute__((cleanup(bgi_trace_end))) = bgi_trace_begin(op, len1, len2)
+#define BGI_TRACE_TIER(t) (bgi_trace_scope.tier = (t))
+
+#else
+
+#define BGI_TRACE_SCOPE(op, len1, len2) do {} while (0)
+#define BGI_TRACE_TIER(t)               do {} while (0)
+
+#endif
+
+// the hook is called on the thread that runs the operation, data is passed
+// through. NULL removes the hook
+void bgi_trace_set_hook(BgiTraceHook hook, void *data) {
+#ifdef BIGINT_TRACE_ENABLED
+#ifdef BIGINT_THREADS_ENABLED
+    pthread_mutex_lock(&bgi_trace_target_lock);
+#endif
+    BgiTraceTarget *target = NULL;
+    if (hook != NULL) {
+        BgiTraceTarget **link = &bgi_trace_retired;
+        while (*link != NULL && ((*link)->hook != hook || (*link)->data != data)) {
+            link = &(*link)->next;
+        }
+        if (*link != NULL) {
+            target = *link;
+            *link  = target->next;
+        } else {
+            target = malloc(sizeof(BgiTraceTarget));
+            bgi_assert(target != NULL, "trace target allocation failed");
+            if (target == NULL) {
+#ifdef BIGINT_THREADS_ENABLED
+                pthread_mutex_unlock(&bgi_trace_target_lock);
+#endif
+                return;
+            }
+            target->hook = hook;
+            target->data = data;
+        }
+        target->next = NULL;
+    }
+
+    BgiTraceTarget *old = bgi_trace_target;
+#ifdef BIGINT_THREADS_ENABLED
+    __atomic_store_n(&bgi_trace_target, target, __ATOMIC_RELEASE);
+#else
+    bgi_trace_target = target;
+#endif
+    if (old != NULL) {
+        old->next = bgi_trace_retired;
+        bgi_trace_retired = old;
+    }
+#ifdef BIGINT_THREADS_ENABLED
+    pthread_mutex_unlock(&bgi_trace_target_lock);
+#endif
+#else
+    (void)hook;
+    (void)data;
+#endif
+}
+
+// chrome trace
+//
+// events are written as they happen in the json array format, which
+// chrome://tracing and perfetto read even while the array is unterminated
+
+#ifdef BIGINT_TRACE_ENABLED
+static FILE    *bgi_trace_file  = NULL;
+static bool     bgi_trace_first = true;
+static uint64_t bgi_trace_start = 0;
+static uint32_t bgi_trace_next_tid = 0;
+static BGI_THREAD_LOCAL uint32_t bgi_trace_tid = 0;
+#ifdef BIGINT_THREADS_ENABLED
+static pthread_mutex_t bgi_trace_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+static void bgi_trace_chrome_hook(const BgiTraceEvent *event, void *data) {
+    (void)data;
+    if (bgi_trace_tid == 0) {
+#ifdef BIGINT_THREADS_ENABLED
+        bgi_trace_tid = __atomic_add_fetch(&bgi_trace_next_tid, 1, __ATOMIC_RELAXED);
+#else
+        bgi_trace_tid = ++bgi_trace_next_tid;
+#endif
+    }
+
+#ifdef BIGINT_THREADS_ENABLED
+    pthread_mutex_lock(&bgi_trace_lock);
+#endif
+    if (bgi_trace_file != NULL) {
+        double ts = (double)(event->time_ns - bgi_trace_start) / 1000.0;
+        fprintf(bgi_trace_file, "%s\n{\"name\":\"%s\",\"cat\":\"bigint\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,",
+            bgi_trace_first ? "" : ",", bgi_stats_op_name(event->op), event->phase == BGI_TRACE_BEGIN ? "B" : "E", ts, bgi_trace_tid);
+        if (event->phase == BGI_TRACE_BEGIN) {
+            fprintf(bgi_trace_file, "\"args\":{\"len1\":%zu,\"len2\":%zu}}", event->len1, event->len2);
+        } else {
+            fprintf(bgi_trace_file, "\"args\":{\"tier\":\"%s\"}}", bgi_trace_tier_name(event->tier));
+        }
+        bgi_trace_first = false;
+    }
+#ifdef BIGINT_THREADS_ENABLED
+    pthread_mutex_unlock(&bgi_trace_lock);
+#endif
+}
+#endif
+
+// replaces the installed hook, false when the file cannot be opened or
+// tracing is not compiled in
+bool bgi_trace_chrome_open(const char *path) {
+    bgi_assert(path != NULL, "path cannot be NULL");
+
+#ifdef BIGINT_TRACE_ENABLED
+    if (path == NULL) {
+        return false;
+    }
+
+    bgi_trace_chrome_close();
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        return false;
+    }
+    fprintf(file, "[");
+
+#ifdef BIGINT_THREADS_ENABLED
+    pthread_mutex_lock(&bgi_trace_lock);
+#endif
+    bgi_trace_file  = file;
+    bgi_trace_first = true;
+    bgi_trace_start = bgi_trace_now();
+#ifdef BIGINT_THREADS_ENABLED
+    pthread_mutex_unlock(&bgi_trace_lock);
+#endif
+
+    bgi_trace_set_hook(bgi_trace_chrome_hook, NULL);
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+// removes the hook and terminates the json array, operations that already
+// took the hook only write while the file is still open
+void bgi_trace_chrome_close(void) {
+#ifdef BIGINT_TRACE_ENABLED
+    bgi_trace_set_hook(NULL, NULL);
+
+#ifdef BIGINT_THREADS_ENABLED
+    pthread_mutex_lock(&bgi_trace_lock);
+#endif
+    if (bgi_trace_file != NULL) {
+        fprintf(bgi_trace_file, "\n]\n");
+        fclose(bgi_trace_file);
+        bgi_trace_file = NULL;
+    }
+#ifdef BIGINT_THREADS_ENABLED
+    pthread_mutex_unlock(&bgi_trace_lock);
+#endif
+#endif
+}
+
+
+// allocator
+//
+// list buffers, BigInt structs, scratch blocks and texts are allocated through
+// a BgiAllocator. bgi_set_allocator replaces the process wide one and
+// bgi_set_thread_allocator overrides it for the calling thread. every object
+// remembers the allocator it came from and is freed through it on any thread,
+// so an allocator must stay valid until its last object is freed
+
+typedef struct {
+    void *(*alloc)(size_t size, void *data);
+    void *(*realloc)(void *ptr, size_t old_size, size_t new_size, void *data);
+    void  (*free)(void *ptr, size_t size, void *data);
+    void *data; // passed to every call
+} BgiAllocator;
+
+void bgi_set_allocator(const BgiAllocator *allocator);
+void bgi_set_thread_allocator(const BgiAllocator *allocator);
+const BgiAllocator *bgi_get_allocator(void);
+
+static void *bgi_c_alloc(size_t size, void *data) {
+    (void)data;
+    return malloc(size);
+}
+
+static void *bgi_c_realloc(void *ptr, size_t old_size, size_t new_size, void *data) {
+    (void)old_size;
+    (void)data;
+    return realloc(ptr, new_size);
+}
+
+static void bgi_c_free(void *ptr, size_t size, void *data) {
+    (void)size;
+    (void)data;
+    free(ptr);
+}
+
+static const BgiAllocator bgi_c_allocator = {bgi_c_alloc, bgi_c_realloc, bgi_c_free, NULL};
+
+static const BgiAllocator *bgi_global_allocator = &bgi_c_allocator;
+static BGI_THREAD_LOCAL const BgiAllocator *bgi_thread_allocator = NULL;
+
+// NULL restores the C allocator
+void bgi_set_allocator(const BgiAllocator *allocator) {
+    if (allocator == NULL) {
+        allocator = &bgi_c_allocator;
+    }
+#ifdef BIGINT_THREADS_ENABLED
+    __atomic_store_n(&bgi_global_allocator, allocator, __ATOMIC_RELEASE);
+#else
+    bgi_global_allocator = allocator;
+#endif
+}
+
+// NULL makes the calling thread use the process wide allocator again
+void bgi_set_thread_allocator(const BgiAllocator *allocator) {
+    bgi_thread_allocator = allocator;
+}
+
+// allocator of new objects on the calling thread
+const BgiAllocator *bgi_get_allocator(void) {
+    if (bgi_thread_allocator != NULL) {
+        return bgi_thread_allocator;
+    }
+#ifdef BIGINT_THREADS_ENABLED
+    return __atomic_load_n(&bgi_global_allocator, __ATOMIC_ACQUIRE);
+#else
+    return bgi_global_allocator;
+#endif
+}
+
+static inline void *bgi_mem_alloc(const BgiAllocator *allocator, size_t size) {
+    return allocator->alloc(size, allocator->data);
+}
+
+static inline void *bgi_mem_realloc(const BgiAllocator *allocator, void *ptr, size_t old_size, size_t new_size) {
+    return allocator->realloc(ptr, old_size, new_size, allocator->data);
+}
+
+static inline void bgi_mem_free(const BgiAllocator *allocator, void *ptr, size_t size) {
+    if (ptr != NULL) {
+        allocator->free(ptr, size, allocator->data);
+    }
+}
+
 
 typedef char int8; 
 
@@ -44,21 +719,37 @@ typedef struct {
     size_t bufsize;
     void*  buf;
     ListStatusCode status_code;
+    size_t refcount; // owners of the list, list_free only frees the last one
+    const BgiAllocator *allocator; // allocator of the list and its buffer
 } List;
 
-const char *list_get_status_msg(List *l);
+// raw view of a list, valid until the list is modified
+typedef struct {
+    const int8 *data;
+    size_t len;
+} ListSpan;
+
+const char *list_get_status_msg(const List *l);
 List *list_init(void);
-size_t list_len(List *l);
-size_t list_size(List *l);
+size_t list_len(const List *l);
+size_t list_size(const List *l);
 void list_append(List *l, int8 value);
-void list_print(List *l);
+void list_reserve(List *l, size_t size);
+void list_resize(List *l, size_t len);
+void list_append_n(List *l, const int8 *values, size_t n);
+void list_fill(List *l, int8 value, size_t n);
+void list_shrink_to_fit(List *l);
+void list_print(const List *l);
 int8 list_get(List *l, size_t index);
 void list_set(List *l, size_t index, int8 value);
 void list_reverse(List *l);
-List *list_clone(List *l);
+List *list_clone(const List *l);
+List *list_retain(List *l);
+List *list_unshare(List *l);
 void list_free(List *l);
+static bool list_is_mapped(const List *l);
 
-const char *list_get_status_msg(List *l) {
+const char *list_get_status_msg(const List *l) {
     bgi_assert(l != NULL, "list cannot be NULL");
     bgi_assert(l->buf != NULL, "l->buf cannot be NULL");
 
@@ -72,17 +763,21 @@ const char *list_get_status_msg(List *l) {
 }
 
 List *list_init(void) {
-    List* l = (List*)malloc(sizeof(List));
+    const BgiAllocator *allocator = bgi_get_allocator();
+    List* l = (List*)bgi_mem_alloc(allocator, sizeof(List));
 
     bgi_assert(l != NULL, "list allocation failed: malloc failed");
     if (l == NULL) {
         return NULL;
     }
 
-    l->index   = 0;
-    l->bufsize = 4;
-    l->buf     = malloc(sizeof(int8) * l->bufsize);
+    l->index    = 0;
+    l->bufsize  = 4;
+    l->buf      = bgi_mem_alloc(allocator, sizeof(int8) * l->bufsize);
+    l->refcount = 1;
     l->status_code = LIST_OK;
+    l->allocator   = allocator;
+    BGI_STATS_ALLOC(sizeof(List) + sizeof(int8) * l->bufsize);
 
     bgi_assert(l != NULL, "l->buf allocation failed: malloc failed");
     if (l->buf == NULL) {
@@ -92,100 +787,221 @@ List *list_init(void) {
     return l;
 }
 
-size_t list_len(List *l) {
+size_t list_len(const List *l) {
     bgi_assert(l != NULL, "list cannot be NULL");
     bgi_assert(l->buf != NULL, "l->buf cannot be NULL");
     return l->index;
 }
 
-size_t list_size(List *l) {
+size_t list_size(const List *l) {
     bgi_assert(l != NULL, "list cannot be NULL");
     bgi_assert(l->buf != NULL, "l->buf cannot be NULL");
     return l->bufsize;
 }
 
-void list_append(List *l, int8 value) {
+static inline int8 *list_data(List *l) {
     bgi_assert(l != NULL, "list cannot be NULL");
-    bgi_assert(l->buf != NULL, "l->buf cannot be NULL");
+    return (int8*)l->buf;
+}
+
+static inline ListSpan list_span(const List *l) {
+    bgi_assert(l != NULL, "list cannot be NULL");
+    ListSpan span = {(const int8*)l->buf, l->index};
+    return span;
+}
 
-    if (l->index + 1 >= l->bufsize) {
-        l->bufsize *= 2;
-        void *newbuf = realloc(l->buf, sizeof(int8) * l->bufsize);
+// unchecked element access, bounds are only checked in BIGINT_ASSERT_ENABLED builds
+static inline int8 list_at(const List *l, size_t index) {
+    bgi_assert(index < l->index, "index is outbound");
+    return ((int8*)l->buf)[index];
+}
 
-        bgi_assert(l != NULL, "l->buf reallocation failed: realloc failed");
-        if (newbuf == NULL) {
-            l->status_code = LIST_BUF_REALLOC_FAIL;
-            return;
-        }
+static inline void list_put(List *l, size_t index, int8 value) {
+    bgi_assert(index < l->index, "index is outbound");
+    bgi_assert(l->refcount == 1, "shared list cannot be modified, use list_unshare");
+    ((int8*)l->buf)[index] = value;
+}
 
-        l->buf = newbuf;
+// grows l->buf geometrically until it can hold size elements
+static bool list_grow(List *l, size_t size) {
+    if (size <= l->bufsize) {
+        return true;
     }
 
-    *((int8*)l->buf + l->index++) = value;
-    return;
-}
+    size_t bufsize = l->bufsize > 0 ? l->bufsize : 4;
+    while (bufsize < size) {
+        bufsize *= 2;
+    }
 
-void list_print(List *l) {
-    bgi_assert(l != NULL, "list cannot be NULL");
-    bgi_assert(l->buf != NULL, "l->buf cannot be NULL");
+    void *newbuf = bgi_mem_realloc(l->allocator, l->buf, sizeof(int8) * l->bufsize, sizeof(int8) * bufsize);
 
-    printf("[");
-    for (size_t i = 0; i < l->index; i++) {
-        if (i == l->index-1) {
-            printf("%d", *((int8*)l->buf + i));
-        } else {
-            printf("%d, ", *((int8*)l->buf + i));
-        }
+    bgi_assert(newbuf != NULL, "l->buf reallocation failed: realloc failed");
+    if (newbuf == NULL) {
+        l->status_code = LIST_BUF_REALLOC_FAIL;
+        return false;
     }
-    printf("]\n");
+
+    l->buf     = newbuf;
+    l->bufsize = bufsize;
+    BGI_STATS_REALLOC(sizeof(int8) * bufsize);
+    return true;
 }
 
-int8 list_get(List *l, size_t index) {
+void list_append(List *l, int8 value) {
     bgi_assert(l != NULL, "list cannot be NULL");
     bgi_assert(l->buf != NULL, "l->buf cannot be NULL");
+    bgi_assert(l->refcount == 1, "shared list cannot be modified, use list_unshare");
 
-    if (index >= l->index) {
-        l->status_code = LIST_INDEX_OUTBOUND;
-        return 0;
+    if (l->index >= l->bufsize && !list_grow(l, l->index + 1)) {
+        return;
     }
 
-    return *((int8*)l->buf + index);
+    *((int8*)l->buf + l->index++) = value;
+    return;
 }
 
-void list_set(List *l, size_t index, int8 value) {
+// makes room for size elements without changing the length
+void list_reserve(List *l, size_t size) {
     bgi_assert(l != NULL, "list cannot be NULL");
     bgi_assert(l->buf != NULL, "l->buf cannot be NULL");
+    bgi_assert(l->refcount == 1, "shared list cannot be modified, use list_unshare");
 
-    if (index >= l->index) {
-        l->status_code = LIST_INDEX_OUTBOUND;
+    if (size <= l->bufsize) {
         return;
     }
 
-    *((int8*)l->buf + index) = value;
+    void *newbuf = bgi_mem_realloc(l->allocator, l->buf, sizeof(int8) * l->bufsize, sizeof(int8) * size);
+
+    bgi_assert(newbuf != NULL, "l->buf reallocation failed: realloc failed");
+    if (newbuf == NULL) {
+        l->status_code = LIST_BUF_REALLOC_FAIL;
+        return;
+    }
+
+    l->buf     = newbuf;
+    l->bufsize = size;
+    BGI_STATS_REALLOC(sizeof(int8) * size);
 }
 
-void list_reverse(List *l) {
+// new elements are set to zero
+void list_resize(List *l, size_t len) {
     bgi_assert(l != NULL, "list cannot be NULL");
     bgi_assert(l->buf != NULL, "l->buf cannot be NULL");
+    bgi_assert(l->refcount == 1, "shared list cannot be modified, use list_unshare");
 
-    for (size_t i = 0; i < list_len(l)/2; i++) {
-        int8 front_value = list_get(l, i); 
-        int8 back_value  = list_get(l, list_len(l)-i-1); 
-
-        if (l->status_code != LIST_OK) {
+    if (len > l->index) {
+        if (!list_grow(l, len)) {
             return;
         }
+        memset((int8*)l->buf + l->index, 0, len - l->index);
+    }
 
-        list_set(l, i, back_value);
-        list_set(l, list_len(l)-i-1, front_value);
+    l->index = len;
+}
 
-        if (l->status_code != LIST_OK) {
-            return;
-        }
+void list_append_n(List *l, const int8 *values, size_t n) {
+    bgi_assert(l != NULL, "list cannot be NULL");
+    bgi_assert(l->buf != NULL, "l->buf cannot be NULL");
+    bgi_assert(l->refcount == 1, "shared list cannot be modified, use list_unshare");
+
+    if (n == 0 || !list_grow(l, l->index + n)) {
+        return;
     }
+
+    memcpy((int8*)l->buf + l->index, values, n);
+    l->index += n;
 }
 
-List *list_clone(List *l) {
+// appends n copies of value
+void list_fill(List *l, int8 value, size_t n) {
+    bgi_assert(l != NULL, "list cannot be NULL");
+    bgi_assert(l->buf != NULL, "l->buf cannot be NULL");
+    bgi_assert(l->refcount == 1, "shared list cannot be modified, use list_unshare");
+
+    if (n == 0 || !list_grow(l, l->index + n)) {
+        return;
+    }
+
+    memset((int8*)l->buf + l->index, value, n);
+    l->index += n;
+}
+
+void list_shrink_to_fit(List *l) {
+    bgi_assert(l != NULL, "list cannot be NULL");
+    bgi_assert(l->buf != NULL, "l->buf cannot be NULL");
+    bgi_assert(l->refcount == 1, "shared list cannot be modified, use list_unshare");
+
+    // keep at least one element so l->buf never becomes a zero sized block
+    size_t bufsize = l->index > 0 ? l->index : 1;
+    if (bufsize == l->bufsize) {
+        return;
+    }
+
+    void *newbuf = bgi_mem_realloc(l->allocator, l->buf, sizeof(int8) * l->bufsize, sizeof(int8) * bufsize);
+    if (newbuf == NULL) {
+        // the old block is still valid, so shrinking is only skipped
+        return;
+    }
+
+    l->buf     = newbuf;
+    l->bufsize = bufsize;
+}
+
+void list_print(const List *l) {
+    bgi_assert(l != NULL, "list cannot be NULL");
+    bgi_assert(l->buf != NULL, "l->buf cannot be NULL");
+
+    printf("[");
+    for (size_t i = 0; i < l->index; i++) {
+        if (i == l->index-1) {
+            printf("%d", *((int8*)l->buf + i));
+        } else {
+            printf("%d, ", *((int8*)l->buf + i));
+        }
+    }
+    printf("]\n");
+}
+
+int8 list_get(List *l, size_t index) {
+    bgi_assert(l != NULL, "list cannot be NULL");
+    bgi_assert(l->buf != NULL, "l->buf cannot be NULL");
+
+    if (index >= l->index) {
+        l->status_code = LIST_INDEX_OUTBOUND;
+        return 0;
+    }
+
+    return *((int8*)l->buf + index);
+}
+
+void list_set(List *l, size_t index, int8 value) {
+    bgi_assert(l != NULL, "list cannot be NULL");
+    bgi_assert(l->buf != NULL, "l->buf cannot be NULL");
+    bgi_assert(l->refcount == 1, "shared list cannot be modified, use list_unshare");
+
+    if (index >= l->index) {
+        l->status_code = LIST_INDEX_OUTBOUND;
+        return;
+    }
+
+    *((int8*)l->buf + index) = value;
+}
+
+void list_reverse(List *l) {
+    bgi_assert(l != NULL, "list cannot be NULL");
+    bgi_assert(l->buf != NULL, "l->buf cannot be NULL");
+    bgi_assert(l->refcount == 1, "shared list cannot be modified, use list_unshare");
+
+    int8 *data = list_data(l);
+    size_t len = list_len(l);
+    for (size_t i = 0; i < len/2; i++) {
+        int8 front_value = data[i];
+        data[i] = data[len-i-1];
+        data[len-i-1] = front_value;
+    }
+}
+
+List *list_clone(const List *l) {
     bgi_assert(l != NULL, "list cannot be NULL");
     bgi_assert(l->buf != NULL, "l->buf cannot be NULL");
 
@@ -199,27 +1015,55 @@ List *list_clone(List *l) {
 
     l_copy->status_code = LIST_OK;
 
-    for (size_t i = 0; i < list_len(l); i++) {
-        int8 value = list_get(l, i);
-        if (l->status_code != LIST_OK) {
-            list_free(l_copy);
-            return NULL;
-        }
-        list_append(l_copy, value);
-        if (l_copy->status_code != LIST_OK) {
-            return l_copy;
-        }
+    list_append_n(l_copy, (const int8*)l->buf, list_len(l));
+    return l_copy;
+}
+
+// shares l with one more owner, the list must not be modified while it is shared
+List *list_retain(List *l) {
+    bgi_assert(l != NULL, "list cannot be NULL");
+#ifdef BIGINT_THREADS_ENABLED
+    __atomic_add_fetch(&l->refcount, 1, __ATOMIC_RELAXED);
+#else
+    l->refcount++;
+#endif
+    return l;
+}
+
+// copy on write: returns l itself when it has a single owner, otherwise a
+// private copy and l loses one owner (NULL and l is kept when copying fails).
+// a buffer mapped by bgi_map is read only and copied like a shared one
+List *list_unshare(List *l) {
+    bgi_assert(l != NULL, "list cannot be NULL");
+
+#ifdef BIGINT_THREADS_ENABLED
+    size_t refcount = __atomic_load_n(&l->refcount, __ATOMIC_ACQUIRE);
+#else
+    size_t refcount = l->refcount;
+#endif
+    if (refcount == 1 && !list_is_mapped(l)) {
+        return l;
     }
 
+    List *l_copy = list_clone(l);
+    if (l_copy == NULL || l_copy->status_code != LIST_OK) {
+        list_free(l_copy);
+        return NULL;
+    }
+    list_free(l);
     return l_copy;
 }
 
 void list_free(List *l) {
     if (l == NULL) return;
-    if (l->buf != NULL) {
-        free(l->buf);
-    }
-    free(l);
+#ifdef BIGINT_THREADS_ENABLED
+    if (__atomic_sub_fetch(&l->refcount, 1, __ATOMIC_ACQ_REL) > 0) return;
+#else
+    if (--l->refcount > 0) return;
+#endif
+    const BgiAllocator *allocator = l->allocator;
+    bgi_mem_free(allocator, l->buf, sizeof(int8) * l->bufsize);
+    bgi_mem_free(allocator, l, sizeof(List));
     return;
 }
 
@@ -231,7 +1075,14 @@ void list_free(List *l) {
     X(BGI_REALLOC_FAIL, "memory re-allocation fail") \
     X(BGI_NUMERIC_FAIL, "numeric list fail") \
     X(BGI_DECIMAL_FAIL, "decimal list fail") \
-    X(BGI_INVALID_TEXT_VALUE, "given text for bgi_init is invalid")
+    X(BGI_INVALID_TEXT_VALUE, "given text for bgi_init is invalid") \
+    X(BGI_NOT_INTEGER, "operation requires an integer value") \
+    X(BGI_DIVISION_BY_ZERO, "division by zero") \
+    X(BGI_CANCELLED, "operation was cancelled") \
+    X(BGI_INVALID_BINARY, "given buffer for bgi_import is invalid") \
+    X(BGI_MAP_FAIL, "given file for bgi_map cannot be mapped") \
+    X(BGI_FILE_FAIL, "file cannot be read or written") \
+    X(BGI_OUT_OF_RANGE, "argument is out of range")
 
 #define X(name, msg) name,
 typedef enum {
@@ -241,24 +1092,405 @@ typedef enum {
 
 typedef struct {
     bool sign;     // '+' - true, '-' - false
-    List *numeric;
-    List *decimal;
+    List *numeric; // integer digits, least significant first
+    List *decimal; // fraction digits, most significant first
     BigIntStatusCode status_code;
+    const BgiAllocator *allocator; // allocator of the struct itself
 } BigInt;
 
-const char* bgi_get_status_msg(BigInt *bi);
+// S = sum_{n=0}^{terms-1} a(n)/b(n) * prod_{j=0}^{n} p(j)/q(j), a NULL term is 1
+typedef struct {
+    BigInt *(*a)(uint64_t n, void *data);
+    BigInt *(*b)(uint64_t n, void *data);
+    BigInt *(*p)(uint64_t n, void *data);
+    BigInt *(*q)(uint64_t n, void *data);
+    void *data;
+} BgiSeries;
+
+#define BGI_CACHE_LINE 64
+
+// positive and negative partial sums of one accumulator stripe, padded so
+// stripes never share a cache line
+typedef struct {
+    bool locked;
+    BigInt *positive;
+    BigInt *negative;
+    char padding[BGI_CACHE_LINE - 3*sizeof(void*)];
+} BgiAccumulatorStripe;
+
+typedef enum {
+    BGI_THRESHOLD_MULT_KARATSUBA, // both operands have at least this many digits
+    BGI_THRESHOLD_SQR_KARATSUBA,  // squaring, bi1 and bi2 share their digits
+    BGI_THRESHOLD_DIV_NEWTON,     // divisor has at least this many digits
+    BGI_THRESHOLD_COUNT,
+} BgiThreshold;
+
+typedef enum {
+    BGI_TASK_MULT,
+    BGI_TASK_DIV,
+} BgiTaskOp;
+
+// handle of an operation running on the executor, the operands are shared
+// with the caller through refcounted digit lists
+typedef struct BgiTask {
+    BgiTaskOp op;
+    BigInt *bi1;
+    BigInt *bi2;
+    size_t digits;
+    BigInt *result;
+    bool done;            // guarded by the executor lock
+    bool cancelled;
+    uint32_t progress;    // parts of BGI_TASK_PROGRESS_SCALE
+    struct BgiTask *next; // executor queue
+} BgiTask;
+
+#define BGI_EXPR_NONE SIZE_MAX
+
+typedef enum {
+    BGI_EXPR_VALUE,
+    BGI_EXPR_ADD,
+    BGI_EXPR_SUB,
+    BGI_EXPR_MULT,
+} BgiExprOp;
+
+typedef struct {
+    BgiExprOp op;
+    size_t lhs;
+    size_t rhs;
+    BigInt *value; // leaf value, operation values only live during bgi_expr_eval
+} BgiExprNode;
+
+// DAG of recorded operations, nodes are referenced by their index
+typedef struct {
+    BgiExprNode *nodes;
+    size_t len;
+    size_t cap;
+    size_t *table; // hash-consing slots, node index + 1, 0 when empty
+    size_t table_cap;
+    BigIntStatusCode status_code;
+} BgiExpr;
+
+// running total that many threads add into, the stripes are merged on snapshot
+typedef struct {
+    BgiAccumulatorStripe *stripes;
+    size_t stripes_len;
+    BigIntStatusCode status_code;
+} BgiAccumulator;
+
+// bgi_init for text that arrives in chunks, see bgi_parser_feed
+typedef struct {
+    List *numeric; // most significant first until bgi_parser_finish
+    List *decimal;
+    size_t fed;    // characters accepted so far
+    bool sign;
+    bool in_decimal;
+    size_t part_len; // characters of the current part, the sign excluded
+    bool decimal_non_zero;
+    BigIntStatusCode status_code;
+} BgiParser;
+
+typedef enum {
+    BGI_FORMAT_PLAIN,      // every digit, like bgi_get_text
+    BGI_FORMAT_FIXED,      // precision fraction digits
+    BGI_FORMAT_SCIENTIFIC, // precision significant digits, ex: 1.2345e+999999
+} BgiFormatStyle;
+
+// options of bgi_format, a zeroed struct gives the text of bgi_get_text without the '+'
+typedef struct {
+    BgiFormatStyle style;
+    size_t precision;  // fraction digits of FIXED, significant digits of SCIENTIFIC
+    unsigned base;     // 2 to 36, 0 is 10. other bases need PLAIN and an integer
+    char group;        // separator between groups of integer digits, 0 for none
+    size_t group_size; // integer digits per group, 0 is 3
+    bool plus;         // '+' in front of values that are not negative
+} BgiFormat;
+
+const char* bgi_get_status_msg(const BigInt *bi);
 BigInt *bgi_init(const char* text);
-void bgi_print(BigInt *bi);
-const char *bgi_get_text(BigInt *bi);
-BigInt *bgi_clone(BigInt *bi);
-int bgi_cmp(BigInt *bi1, BigInt *bi2);
-int bgi_abs_cmp(BigInt *bi1, BigInt *bi2);
-BigInt *bgi_add(BigInt *bi1, BigInt *bi2);
-BigInt *bgi_sub(BigInt *bi1, BigInt *bi2);
-BigInt *bgi_mult(BigInt *bi1, BigInt *bi2);
+void bgi_print(const BigInt *bi);
+const char *bgi_get_text(const BigInt *bi);
+void bgi_free_text(const char *text);
+BigInt *bgi_clone(const BigInt *bi);
+void bgi_unshare(BigInt *bi);
+int bgi_cmp(const BigInt *bi1, const BigInt *bi2);
+int bgi_abs_cmp(const BigInt *bi1, const BigInt *bi2);
+BigInt *bgi_add(const BigInt *bi1, const BigInt *bi2);
+BigInt *bgi_sub(const BigInt *bi1, const BigInt *bi2);
+BigInt *bgi_mult(const BigInt *bi1, const BigInt *bi2);
+BigInt *bgi_and(const BigInt *bi1, const BigInt *bi2);
+BigInt *bgi_or(const BigInt *bi1, const BigInt *bi2);
+BigInt *bgi_xor(const BigInt *bi1, const BigInt *bi2);
+BigInt *bgi_not(const BigInt *bi);
+BigInt *bgi_shl(const BigInt *bi, size_t n);
+BigInt *bgi_shr(const BigInt *bi, size_t n);
+size_t bgi_popcount(const BigInt *bi);
+bool bgi_test_bit(const BigInt *bi, size_t n);
+BigInt *bgi_shift10(const BigInt *bi, int64_t k);
+BigInt *bgi_mul_pow10(const BigInt *bi, size_t k);
+BigInt *bgi_div_pow10(const BigInt *bi, size_t k);
+BigInt *bgi_init_ui(uint64_t value);
+BigInt *bgi_init_si(int64_t value);
+BigInt *bgi_add_ui(const BigInt *bi, uint64_t value);
+BigInt *bgi_add_si(const BigInt *bi, int64_t value);
+BigInt *bgi_mul_ui(const BigInt *bi, uint64_t value);
+BigInt *bgi_mul_si(const BigInt *bi, int64_t value);
+BigInt *bgi_divmod_ui(const BigInt *bi, uint64_t divisor, uint64_t *rem);
+BigInt *bgi_divmod_si(const BigInt *bi, int64_t divisor, int64_t *rem);
+BigInt *bgi_fac(uint32_t n);
+BigInt *bgi_fac_mt(uint32_t n, size_t nthreads);
+BigInt *bgi_binomial(uint32_t n, uint32_t k);
+BigInt *bgi_binomial_mt(uint32_t n, uint32_t k, size_t nthreads);
+BigInt *bgi_primorial(uint32_t n);
+BigInt *bgi_primorial_mt(uint32_t n, size_t nthreads);
+BigInt *bgi_div(const BigInt *bi1, const BigInt *bi2, size_t digits);
+BigInt *bgi_series_sum(const BgiSeries *series, uint64_t terms, size_t digits);
+BigInt *bgi_series_sum_mt(const BgiSeries *series, uint64_t terms, size_t digits, size_t nthreads);
+BigInt *bgi_const_e(size_t digits);
+BigInt *bgi_const_log2(size_t digits);
+BigInt *bgi_const_pi(size_t digits);
 void bgi_free(BigInt *bi);
+BgiAccumulator *bgi_accumulator_init(size_t stripes);
+void bgi_accumulator_add(BgiAccumulator *acc, const BigInt *bi);
+void bgi_accumulator_sub(BgiAccumulator *acc, const BigInt *bi);
+BigInt *bgi_accumulator_snapshot(BgiAccumulator *acc);
+void bgi_accumulator_free(BgiAccumulator *acc);
+size_t bgi_parse_many(const char **texts, size_t n, BigInt **out, size_t nthreads);
+char *bgi_format_many(BigInt *const *bis, size_t n, const char **out, size_t nthreads);
+BgiTask *bgi_async_mult(const BigInt *bi1, const BigInt *bi2);
+BgiTask *bgi_async_div(const BigInt *bi1, const BigInt *bi2, size_t digits);
+bool bgi_task_poll(const BgiTask *task);
+bool bgi_task_timed_wait(BgiTask *task, uint64_t timeout_ms);
+BigInt *bgi_task_wait(BgiTask *task);
+void bgi_task_cancel(BgiTask *task);
+double bgi_task_progress(const BgiTask *task);
+void bgi_task_free(BgiTask *task);
+void bgi_executor_shutdown(void);
+BgiExpr *bgi_expr_init(void);
+size_t bgi_expr_value(BgiExpr *expr, const BigInt *bi);
+size_t bgi_expr_add(BgiExpr *expr, size_t lhs, size_t rhs);
+size_t bgi_expr_sub(BgiExpr *expr, size_t lhs, size_t rhs);
+size_t bgi_expr_mult(BgiExpr *expr, size_t lhs, size_t rhs);
+BigInt *bgi_expr_eval(BgiExpr *expr, size_t root);
+void bgi_expr_free(BgiExpr *expr);
+void bgi_scratch_free(void);
+size_t bgi_scratch_size(void);
+void bgi_set_threshold(BgiThreshold which, size_t digits);
+size_t bgi_get_threshold(BgiThreshold which);
+size_t bgi_export(const BigInt *bi, uint8_t *buf, size_t cap);
+BigInt *bgi_import(const uint8_t *buf, size_t len, size_t *used);
+size_t bgi_export_many(BigInt *const *bis, size_t n, uint8_t *buf, size_t cap);
+size_t bgi_import_many(const uint8_t *buf, size_t len, BigInt **out, size_t n);
+bool bgi_save(const BigInt *bi, const char *path);
+BigInt *bgi_map(const char *path);
+BigIntStatusCode bgi_file_cmp(const char *path1, const char *path2, size_t budget, int *result);
+BigIntStatusCode bgi_file_add(const char *path1, const char *path2, const char *out, size_t budget);
+BigIntStatusCode bgi_file_sub(const char *path1, const char *path2, const char *out, size_t budget);
+BigIntStatusCode bgi_file_mult(const char *path1, const char *path2, const char *out, size_t budget);
+BgiParser *bgi_parser_new(void);
+BigIntStatusCode bgi_parser_feed(BgiParser *parser, const char *buf, size_t len);
+BigInt *bgi_parser_finish(BgiParser *parser);
+void bgi_parser_free(BgiParser *parser);
+const char *bgi_format(const BigInt *bi, const BgiFormat *format);
+
+// scratch space
+//
+// kernels take their temporary buffers from a per thread stack of blocks and
+// release them back to the mark taken on entry. blocks never move, so earlier
+// allocations stay valid while the stack grows, and once the blocks are big
+// enough temporaries need no heap allocation at all
+
+#define BGI_SCRATCH_ALIGN 16
+#define BGI_SCRATCH_MIN_BLOCK 4096
+
+typedef struct BgiScratchBlock {
+    struct BgiScratchBlock *next;
+    size_t size;
+    size_t top;
+    const BgiAllocator *allocator;
+} BgiScratchBlock;
+
+typedef struct {
+    BgiScratchBlock *block;
+    size_t top;
+} BgiScratchMark;
+
+// block data starts after the header, rounded up to the alignment
+#define BGI_SCRATCH_HEADER ((sizeof(BgiScratchBlock) + BGI_SCRATCH_ALIGN - 1) & ~(size_t)(BGI_SCRATCH_ALIGN - 1))
+
+static BGI_THREAD_LOCAL BgiScratchBlock *bgi_scratch_head    = NULL;
+static BGI_THREAD_LOCAL BgiScratchBlock *bgi_scratch_current = NULL;
+
+static void bgi_scratch_free_blocks(void *head) {
+    BgiScratchBlock *block = (BgiScratchBlock*)head;
+    while (block != NULL) {
+        BgiScratchBlock *next = block->next;
+        bgi_mem_free(block->allocator, block, BGI_SCRATCH_HEADER + block->size);
+        block = next;
+    }
+}
+
+#ifdef BIGINT_THREADS_ENABLED
+// frees the blocks of worker threads when they exit
+static pthread_key_t bgi_scratch_key;
+static pthread_once_t bgi_scratch_key_once = PTHREAD_ONCE_INIT;
+
+static void bgi_scratch_make_key(void) {
+    pthread_key_create(&bgi_scratch_key, bgi_scratch_free_blocks);
+}
+#endif
+
+static BgiScratchMark bgi_scratch_mark(void) {
+    BgiScratchMark mark = {bgi_scratch_current, bgi_scratch_current != NULL ? bgi_scratch_current->top : 0};
+    return mark;
+}
+
+static void bgi_scratch_release(BgiScratchMark mark) {
+    // blocks after the marked one only hold released allocations
+    BgiScratchBlock *block = mark.block != NULL ? mark.block->next : bgi_scratch_head;
+    for (; block != NULL; block = block->next) {
+        block->top = 0;
+    }
+    if (mark.block != NULL) {
+        mark.block->top = mark.top;
+    }
+    bgi_scratch_current = mark.block;
+}
+
+static void *bgi_scratch_alloc(size_t size) {
+    size = (size + BGI_SCRATCH_ALIGN - 1) & ~(size_t)(BGI_SCRATCH_ALIGN - 1);
+    if (size == 0) {
+        size = BGI_SCRATCH_ALIGN;
+    }
+
+    // blocks after the current one are empty, too small ones are skipped
+    BgiScratchBlock *block = bgi_scratch_current != NULL ? bgi_scratch_current : bgi_scratch_head;
+    BgiScratchBlock *last  = NULL;
+    while (block != NULL && block->size - block->top < size) {
+        last  = block;
+        block = block->next;
+    }
+
+    if (block == NULL) {
+        size_t block_size = last != NULL ? last->size * 2 : BGI_SCRATCH_MIN_BLOCK;
+        if (block_size < size) {
+            block_size = size;
+        }
+        if (block_size > SIZE_MAX - BGI_SCRATCH_HEADER) {
+            return NULL;
+        }
+
+        const BgiAllocator *allocator = bgi_get_allocator();
+        block = (BgiScratchBlock*)bgi_mem_alloc(allocator, BGI_SCRATCH_HEADER + block_size);
+        if (block == NULL) {
+            return NULL;
+        }
+        block->allocator = allocator;
+        block->next = NULL;
+        block->size = block_size;
+        block->top  = 0;
+        BGI_STATS_ALLOC(BGI_SCRATCH_HEADER + block_size);
+
+        if (last != NULL) {
+            last->next = block;
+        } else {
+            bgi_scratch_head = block;
+#ifdef BIGINT_THREADS_ENABLED
+            pthread_once(&bgi_scratch_key_once, bgi_scratch_make_key);
+            pthread_setspecific(bgi_scratch_key, block);
+#endif
+        }
+    }
+
+    void *ptr = (unsigned char*)block + BGI_SCRATCH_HEADER + block->top;
+    block->top += size;
+    bgi_scratch_current = block;
+    return ptr;
+}
+
+static void *bgi_scratch_calloc(size_t n, size_t size) {
+    if (size != 0 && n > SIZE_MAX / size) {
+        return NULL;
+    }
+    void *ptr = bgi_scratch_alloc(n * size);
+    if (ptr != NULL) {
+        memset(ptr, 0, n * size);
+    }
+    return ptr;
+}
+
+// must not be called while a kernel of the same thread is running
+void bgi_scratch_free(void) {
+    bgi_scratch_free_blocks(bgi_scratch_head);
+    bgi_scratch_head    = NULL;
+    bgi_scratch_current = NULL;
+#ifdef BIGINT_THREADS_ENABLED
+    pthread_once(&bgi_scratch_key_once, bgi_scratch_make_key);
+    pthread_setspecific(bgi_scratch_key, NULL);
+#endif
+}
+
+// bytes reserved by the scratch blocks of the calling thread
+size_t bgi_scratch_size(void) {
+    size_t size = 0;
+    for (BgiScratchBlock *block = bgi_scratch_head; block != NULL; block = block->next) {
+        size += block->size;
+    }
+    return size;
+}
+
+// async task hooks
+//
+// kernels that run for a task check for cancellation and report progress
+// between rows of their work, outside of a task the checks do nothing
+
+#define BGI_TASK_PROGRESS_SCALE 1000000u
+
+static BGI_THREAD_LOCAL BgiTask *bgi_current_task = NULL;
+
+static bool bgi_task_is_cancelled(const BgiTask *task) {
+#ifdef BIGINT_THREADS_ENABLED
+    return __atomic_load_n(&task->cancelled, __ATOMIC_RELAXED);
+#else
+    return task->cancelled;
+#endif
+}
+
+static void bgi_task_set_progress(BgiTask *task, uint32_t progress) {
+#ifdef BIGINT_THREADS_ENABLED
+    __atomic_store_n(&task->progress, progress, __ATOMIC_RELAXED);
+#else
+    task->progress = progress;
+#endif
+}
+
+// false when the current task was cancelled and the kernel should stop
+static bool bgi_task_checkpoint(size_t done, size_t total) {
+    BgiTask *task = bgi_current_task;
+    if (task == NULL) {
+        return true;
+    }
+    if (total > 0) {
+        bgi_task_set_progress(task, (uint32_t)((double)done / (double)total * BGI_TASK_PROGRESS_SCALE));
+    }
+    return !bgi_task_is_cancelled(task);
+}
+
+// digits of an operand for the statistics and traces, 0 for a missing one
+static inline size_t bgi_probe_len(const BigInt *bi) {
+    if (bi == NULL || bi->numeric == NULL || bi->decimal == NULL) {
+        return 0;
+    }
+    return list_len(bi->numeric) + list_len(bi->decimal);
+}
 
-const char* bgi_get_status_msg(BigInt *bi) {
+// digits of the larger operand, for the size histogram
+static inline size_t bgi_stats_digits(const BigInt *bi1, const BigInt *bi2) {
+    size_t len1 = bgi_probe_len(bi1);
+    size_t len2 = bgi_probe_len(bi2);
+    return len1 > len2 ? len1 : len2;
+}
+
+const char* bgi_get_status_msg(const BigInt *bi) {
 #define X(name, msg) case name: return msg;
     switch (bi->status_code) {
         BGI_STATUS_LIST(X)
@@ -268,13 +1500,17 @@ const char* bgi_get_status_msg(BigInt *bi) {
 #undef X
 }
 
-BigInt *bgi_init(const char* text) {
-    BigInt *bi = (BigInt*)malloc(sizeof(BigInt));
+// bgi_init without the statistics, the library builds its own results with it
+static BigInt *bgi_init_text(const char* text) {
+    const BgiAllocator *allocator = bgi_get_allocator();
+    BigInt *bi = (BigInt*)bgi_mem_alloc(allocator, sizeof(BigInt));
     bgi_assert(bi != NULL, "bi cannot be NULL");
 
     if (bi == NULL) {
         return NULL;
     }
+    BGI_STATS_ALLOC(sizeof(BigInt));
+    bi->allocator = allocator;
 
     bool is_numeric = true;
     bi->sign = true;
@@ -318,12 +1554,14 @@ BigInt *bgi_init(const char* text) {
     bool is_all_decimal_digits_are_zeros = true;
     size_t decimal_part_start_index = 0;
 
-    for (size_t i = index; i < strlen(text); i++) {
+    size_t numeric_part_end_index = len;
+    for (size_t i = index; i < len; i++) {
         if (text[i] == '.') {
             if (i == index) {
                 bi->status_code = BGI_INVALID_TEXT_VALUE;
                 return bi;
             }
+            numeric_part_end_index   = i;
             decimal_part_start_index = i+1;
             break;
         }
@@ -338,1308 +1576,5251 @@ BigInt *bgi_init(const char* text) {
     }
 
     if (!is_all_numeric_digits_are_zeros) {
-        for (size_t i = index; i < strlen(text); i++) {
-            if (text[i] == '.') {
-                break;
-            }
-            list_append(bi->numeric, text[i]-'0');
-            if (bi->numeric->status_code != LIST_OK) {
-                bi->status_code = BGI_NUMERIC_FAIL;
+        size_t start = index;
+        while (text[start] == '0') {
+            start++;
+        }
+
+        list_resize(bi->numeric, numeric_part_end_index - start);
+        if (bi->numeric->status_code != LIST_OK) {
+            bi->status_code = BGI_NUMERIC_FAIL;
+            return bi;
+        }
+        int8 *digits = list_data(bi->numeric);
+        for (size_t i = start; i < numeric_part_end_index; i++) {
+            digits[numeric_part_end_index - 1 - i] = text[i]-'0';
+        }
+    }
+
+    if (decimal_part_start_index > 0) {
+        if (decimal_part_start_index >= len) {
+            bi->status_code = BGI_INVALID_TEXT_VALUE;
+            return bi;
+        }
+        for (size_t i = decimal_part_start_index; i < len; i++) {
+            if (text[i] >= 48 && text[i] <= 57) {
+                if (text[i] != '0') {
+                    is_all_decimal_digits_are_zeros = false;
+                }
+            } else {
+                bi->status_code = BGI_INVALID_TEXT_VALUE;
                 return bi;
             }
         }
     }
 
-    if (decimal_part_start_index > 0) {
-        if (decimal_part_start_index >= strlen(text)) {
-            bi->status_code = BGI_INVALID_TEXT_VALUE;
-            return bi;
+    if (!is_all_decimal_digits_are_zeros) {
+        list_resize(bi->decimal, len - decimal_part_start_index);
+        if (bi->decimal->status_code != LIST_OK) {
+            bi->status_code = BGI_DECIMAL_FAIL;
+            return bi;
+        }
+        int8 *digits = list_data(bi->decimal);
+        for (size_t i = decimal_part_start_index; i < len; i++) {
+            digits[i - decimal_part_start_index] = text[i]-'0';
+        }
+    }
+
+    if (list_len(bi->numeric) == 0 && list_len(bi->decimal) == 0) {
+        bi->sign = true;
+    }
+
+    bi->status_code = BGI_OK;
+    return bi;
+}
+
+BigInt *bgi_init(const char* text) {
+    BGI_STATS_SCOPE(BGI_STATS_INIT, text != NULL ? strlen(text) : 0);
+    BGI_TRACE_SCOPE(BGI_STATS_INIT, text != NULL ? strlen(text) : 0, 0);
+    return bgi_init_text(text);
+}
+
+void bgi_print(const BigInt *bi) {
+    bgi_assert(bi != NULL, "bi cannot be NULL");
+    bgi_assert(bi->numeric != NULL, "bi->numeric cannot be NULL");
+    bgi_assert(bi->decimal != NULL, "bi->decimal cannot be NULL");
+
+    if (bi == NULL || bi->numeric == NULL || bi->decimal == NULL) {
+        return;
+    }
+
+    if (bi->status_code != BGI_OK || bi->numeric->status_code != LIST_OK || bi->decimal->status_code != LIST_OK) {
+        return;
+    }
+
+    printf("<BigInt %c", bi->sign ? '+' : '-');
+
+    if (list_len(bi->numeric) == 0) {
+        printf("0");
+    }
+
+    ListSpan numeric = list_span(bi->numeric);
+    for (size_t i = numeric.len; i-- > 0;) {
+        putchar(numeric.data[i] + '0');
+    }
+
+    if (list_len(bi->decimal) == 0) {
+        printf(">\n");
+    } else {
+        printf(".");
+        ListSpan decimal = list_span(bi->decimal);
+        for (size_t i = 0; i < decimal.len; i++) {
+            putchar(decimal.data[i] + '0');
+        }
+        printf(">\n");
+    }
+}
+
+// length of the text of bi without the null terminator
+static size_t bgi_text_len(const BigInt *bi) {
+    size_t numeric_len = list_len(bi->numeric);
+    size_t decimal_len = list_len(bi->decimal);
+
+    if (numeric_len == 0 && decimal_len == 0) {
+        return 2; // ex: +0
+    }
+    if (decimal_len == 0) {
+        return 1 + numeric_len; // ex: +23, -23
+    }
+    if (numeric_len == 0) {
+        return 3 + decimal_len; // ex: +0.23, -0.23
+    }
+    return 2 + numeric_len + decimal_len; // ex: +23.23, -23.23
+}
+
+// writes the bgi_text_len(bi) characters of the text of bi, without a null terminator
+static void bgi_write_text(const BigInt *bi, char *text) {
+    ListSpan numeric = list_span(bi->numeric);
+    ListSpan decimal = list_span(bi->decimal);
+
+    *text++ = bi->sign ? '+' : '-';
+
+    if (numeric.len == 0) {
+        *text++ = '0';
+    }
+    for (size_t i = 0; i < numeric.len; i++) {
+        *text++ = numeric.data[numeric.len-1-i] + '0';
+    }
+
+    if (decimal.len > 0) {
+        *text++ = '.';
+    }
+    for (size_t i = 0; i < decimal.len; i++) {
+        *text++ = decimal.data[i] + '0';
+    }
+}
+
+// texts start after a header that remembers their allocator, so
+// bgi_free_text frees them through it on any thread
+typedef struct {
+    const BgiAllocator *allocator;
+    size_t size;
+} BgiTextHeader;
+
+// room for size characters, the null terminator included
+static char *bgi_text_alloc(size_t size) {
+    if (size > SIZE_MAX - sizeof(BgiTextHeader)) {
+        return NULL;
+    }
+
+    const BgiAllocator *allocator = bgi_get_allocator();
+    BgiTextHeader *header = (BgiTextHeader*)bgi_mem_alloc(allocator, sizeof(BgiTextHeader) + size);
+    if (header == NULL) {
+        return NULL;
+    }
+    header->allocator = allocator;
+    header->size = sizeof(BgiTextHeader) + size;
+    BGI_STATS_ALLOC(header->size);
+    return (char*)(header + 1);
+}
+
+const char *bgi_get_text(const BigInt *bi) {
+    BGI_STATS_SCOPE(BGI_STATS_GET_TEXT, bgi_stats_digits(bi, NULL));
+    BGI_TRACE_SCOPE(BGI_STATS_GET_TEXT, bgi_probe_len(bi), bgi_probe_len(NULL));
+
+    bgi_assert(bi != NULL, "bi cannot be NULL");
+    bgi_assert(bi->numeric != NULL, "bi->numeric cannot be NULL");
+    bgi_assert(bi->decimal != NULL, "bi->decimal cannot be NULL");
+
+    if (bi == NULL || bi->numeric == NULL || bi->decimal == NULL) {
+        return NULL;
+    }
+
+    if (bi->status_code != BGI_OK || bi->numeric->status_code != LIST_OK || bi->decimal->status_code != LIST_OK) {
+        return NULL;
+    }
+
+    size_t length = bgi_text_len(bi);
+    char *text = bgi_text_alloc(length + 1); // +1 for the null terminator
+    if (text == NULL) {
+        return NULL;
+    }
+
+    bgi_write_text(bi, text);
+    text[length] = '\0';
+    return text;
+}
+
+// texts of bgi_get_text and bgi_format must be freed here, not with free()
+void bgi_free_text(const char *text) {
+    if (text == NULL) return;
+    BgiTextHeader *header = (BgiTextHeader*)text - 1;
+    bgi_mem_free(header->allocator, header, header->size);
+}
+
+BigInt *bgi_clone(const BigInt *bi) {
+    BGI_STATS_SCOPE(BGI_STATS_CLONE, bgi_stats_digits(bi, NULL));
+    BGI_TRACE_SCOPE(BGI_STATS_CLONE, bgi_probe_len(bi), bgi_probe_len(NULL));
+
+    bgi_assert(bi != NULL, "bi cannot be NULL");
+    bgi_assert(bi->numeric != NULL, "bi->numeric cannot be NULL");
+    bgi_assert(bi->decimal != NULL, "bi->decimal cannot be NULL");
+
+    if (bi == NULL || bi->numeric == NULL || bi->decimal == NULL) {
+        return NULL;
+    }
+
+    if (bi->status_code != BGI_OK || bi->numeric->status_code != LIST_OK || bi->decimal->status_code != LIST_OK) {
+        return NULL;
+    }
+
+    const BgiAllocator *allocator = bgi_get_allocator();
+    BigInt *bi_copy = (BigInt*)bgi_mem_alloc(allocator, sizeof(BigInt));
+    if (bi_copy == NULL) {
+        return NULL;
+    }
+    BGI_STATS_ALLOC(sizeof(BigInt));
+    bi_copy->allocator = allocator;
+
+    bi_copy->sign = bi->sign;
+    bi_copy->status_code = BGI_OK;
+
+    // digits are shared, bgi_unshare makes them private again before a modification
+    bi_copy->numeric = list_retain(bi->numeric);
+    bi_copy->decimal = list_retain(bi->decimal);
+
+    return bi_copy;
+}
+
+// gives bi its own digits, must be called before bi->numeric or bi->decimal
+// are modified in place
+void bgi_unshare(BigInt *bi) {
+    bgi_assert(bi != NULL, "bi cannot be NULL");
+    bgi_assert(bi->numeric != NULL, "bi->numeric cannot be NULL");
+    bgi_assert(bi->decimal != NULL, "bi->decimal cannot be NULL");
+
+    if (bi == NULL || bi->numeric == NULL || bi->decimal == NULL || bi->status_code != BGI_OK) {
+        return;
+    }
+
+    List *numeric = list_unshare(bi->numeric);
+    if (numeric == NULL) {
+        bi->status_code = BGI_NUMERIC_FAIL;
+        return;
+    }
+    bi->numeric = numeric;
+
+    List *decimal = list_unshare(bi->decimal);
+    if (decimal == NULL) {
+        bi->status_code = BGI_DECIMAL_FAIL;
+        return;
+    }
+    bi->decimal = decimal;
+}
+
+int bgi_cmp(const BigInt *bi1, const BigInt *bi2) {
+    BGI_STATS_SCOPE(BGI_STATS_CMP, bgi_stats_digits(bi1, bi2));
+    BGI_TRACE_SCOPE(BGI_STATS_CMP, bgi_probe_len(bi1), bgi_probe_len(bi2));
+
+    if (bi1->sign && !bi2->sign) {
+        return 1;
+    }
+
+    if (!bi1->sign && bi2->sign) {
+        return -1;
+    }
+
+    int value = bgi_abs_cmp(bi1, bi2);
+    return bi1->sign ? value : -value;
+}
+
+int bgi_abs_cmp(const BigInt *bi1, const BigInt *bi2) {
+    ListSpan n1 = list_span(bi1->numeric);
+    ListSpan n2 = list_span(bi2->numeric);
+
+    if (n1.len != n2.len) {
+        return n1.len > n2.len ? 1 : -1;
+    }
+
+    for (size_t i = n1.len; i-- > 0;) {
+        if (n1.data[i] != n2.data[i]) {
+            return n1.data[i] > n2.data[i] ? 1 : -1;
+        }
+    }
+
+    ListSpan d1 = list_span(bi1->decimal);
+    ListSpan d2 = list_span(bi2->decimal);
+
+    size_t len = d1.len < d2.len ? d1.len : d2.len;
+    int value = len > 0 ? memcmp(d1.data, d2.data, len) : 0;
+    if (value != 0) {
+        return value > 0 ? 1 : -1;
+    }
+
+    if (d1.len != d2.len) {
+        return d1.len > d2.len ? 1 : -1;
+    }
+
+    return 0;
+}
+
+static BigInt *bgi_init_with_status(BigIntStatusCode status_code) {
+    BigInt *bi = bgi_init_text("0");
+    if (bi == NULL) {
+        return NULL;
+    }
+    bi->status_code = status_code;
+    return bi;
+}
+
+// builds a BigInt from digit runs (numeric least significant first), the most
+// significant numeric zeros and the trailing decimal zeros are dropped
+static BigInt *bgi_from_digits(const int8 *numeric, size_t numeric_len, const int8 *decimal, size_t decimal_len, bool sign) {
+    BigInt *bi = bgi_init_text("0");
+    if (bi == NULL) {
+        return NULL;
+    }
+    if (bi->status_code != BGI_OK) {
+        return bi;
+    }
+
+    while (numeric_len > 0 && numeric[numeric_len-1] == 0) {
+        numeric_len--;
+    }
+
+    while (decimal_len > 0 && decimal[decimal_len-1] == 0) {
+        decimal_len--;
+    }
+
+    list_append_n(bi->numeric, numeric, numeric_len);
+    if (bi->numeric->status_code != LIST_OK) {
+        bi->status_code = BGI_NUMERIC_FAIL;
+        return bi;
+    }
+
+    list_append_n(bi->decimal, decimal, decimal_len);
+    if (bi->decimal->status_code != LIST_OK) {
+        bi->status_code = BGI_DECIMAL_FAIL;
+        return bi;
+    }
+
+    bi->sign = (numeric_len == 0 && decimal_len == 0) ? true : sign;
+    return bi;
+}
+
+// zero filled digits for a result that is written in place and finished with bgi_trim
+static BigInt *bgi_alloc_digits(size_t numeric_len, size_t decimal_len) {
+    BigInt *bi = bgi_init_text("0");
+    if (bi == NULL) {
+        return NULL;
+    }
+    if (bi->status_code != BGI_OK) {
+        return bi;
+    }
+
+    list_resize(bi->numeric, numeric_len);
+    if (bi->numeric->status_code != LIST_OK) {
+        bi->status_code = BGI_NUMERIC_FAIL;
+        return bi;
+    }
+
+    list_resize(bi->decimal, decimal_len);
+    if (bi->decimal->status_code != LIST_OK) {
+        bi->status_code = BGI_DECIMAL_FAIL;
+        return bi;
+    }
+
+    return bi;
+}
+
+// both lists end with their least significant digit away from the point, so
+// dropping zeros never moves any digits
+static BigInt *bgi_trim(BigInt *bi, bool sign) {
+    int8 *numeric = list_data(bi->numeric);
+    while (bi->numeric->index > 0 && numeric[bi->numeric->index-1] == 0) {
+        bi->numeric->index--;
+    }
+
+    int8 *decimal = list_data(bi->decimal);
+    while (bi->decimal->index > 0 && decimal[bi->decimal->index-1] == 0) {
+        bi->decimal->index--;
+    }
+
+    bi->sign = (list_len(bi->numeric) == 0 && list_len(bi->decimal) == 0) ? true : sign;
+    return bi;
+}
+
+// |bi1| + |bi2| or |bi1| - |bi2| (|bi1| >= |bi2| is required for the subtraction),
+// the result digits are written in place, from the last decimal digit outwards
+static BigInt *bgi_add_abs(const BigInt *bi1, const BigInt *bi2, bool subtract, bool sign) {
+    ListSpan n1 = list_span(bi1->numeric);
+    ListSpan d1 = list_span(bi1->decimal);
+    ListSpan n2 = list_span(bi2->numeric);
+    ListSpan d2 = list_span(bi2->decimal);
+
+    size_t numeric_len = (n1.len > n2.len ? n1.len : n2.len) + 1; // room for the last carrier
+    size_t decimal_len = d1.len > d2.len ? d1.len : d2.len;
+
+    BigInt *bi3 = bgi_alloc_digits(numeric_len, decimal_len);
+    if (bi3 == NULL || bi3->status_code != BGI_OK) {
+        return bi3;
+    }
+
+    int8 *numeric  = list_data(bi3->numeric);
+    int8 *decimal  = list_data(bi3->decimal);
+    int8 direction = subtract ? -1 : 1;
+    int8 carrier   = 0;
+
+    for (size_t i = decimal_len; i-- > 0;) {
+        int8 a = i < d1.len ? d1.data[i] : 0;
+        int8 b = i < d2.len ? d2.data[i] : 0;
+        int8 value = a + direction*(b + carrier);
+        carrier    = value < 0 || value >= 10;
+        decimal[i] = value - direction*10*carrier;
+    }
+
+    for (size_t i = 0; i < numeric_len; i++) {
+        int8 a = i < n1.len ? n1.data[i] : 0;
+        int8 b = i < n2.len ? n2.data[i] : 0;
+        int8 value = a + direction*(b + carrier);
+        carrier    = value < 0 || value >= 10;
+        numeric[i] = value - direction*10*carrier;
+    }
+
+    bgi_assert(carrier == 0, "carrier should be 0 (something went wrong)");
+    return bgi_trim(bi3, sign);
+}
+
+// |acc| += |bi| in place, once the lists of acc have grown to the operand
+// sizes no allocation is done
+static bool bgi_add_abs_into(BigInt *acc, const BigInt *bi) {
+    ListSpan n2 = list_span(bi->numeric);
+    ListSpan d2 = list_span(bi->decimal);
+
+    size_t numeric_len = (list_len(acc->numeric) > n2.len ? list_len(acc->numeric) : n2.len) + 1;
+    if (list_len(acc->decimal) < d2.len) {
+        list_resize(acc->decimal, d2.len);
+        if (acc->decimal->status_code != LIST_OK) {
+            return false;
+        }
+    }
+    list_resize(acc->numeric, numeric_len);
+    if (acc->numeric->status_code != LIST_OK) {
+        return false;
+    }
+
+    int8 *numeric = list_data(acc->numeric);
+    int8 *decimal = list_data(acc->decimal);
+    int8 carrier  = 0;
+
+    for (size_t i = d2.len; i-- > 0;) {
+        int8 value = decimal[i] + d2.data[i] + carrier;
+        carrier    = value >= 10;
+        decimal[i] = value - 10*carrier;
+    }
+
+    for (size_t i = 0; i < numeric_len && (i < n2.len || carrier != 0); i++) {
+        int8 value = numeric[i] + (i < n2.len ? n2.data[i] : 0) + carrier;
+        carrier    = value >= 10;
+        numeric[i] = value - 10*carrier;
+    }
+
+    bgi_assert(carrier == 0, "carrier should be 0 (something went wrong)");
+    bgi_trim(acc, true);
+    return true;
+}
+
+// bi1 + bi2 where bi2 is taken with sign2 instead of bi2->sign
+static BigInt *bgi_add_signed(const BigInt *bi1, const BigInt *bi2, bool sign2) {
+    if (bi1->sign == sign2) {
+        return bgi_add_abs(bi1, bi2, false, bi1->sign);
+    }
+
+    int val = bgi_abs_cmp(bi1, bi2);
+    if (val >= 0) {
+        return bgi_add_abs(bi1, bi2, true, bi1->sign);
+    }
+    return bgi_add_abs(bi2, bi1, true, sign2);
+}
+
+BigInt *bgi_add(const BigInt *bi1, const BigInt *bi2) {
+    BGI_STATS_SCOPE(BGI_STATS_ADD, bgi_stats_digits(bi1, bi2));
+    BGI_TRACE_SCOPE(BGI_STATS_ADD, bgi_probe_len(bi1), bgi_probe_len(bi2));
+
+    bgi_assert(bi1 != NULL, "bi1 cannot be NULL");
+    bgi_assert(bi1->numeric != NULL, "bi1->numeric cannot be NULL");
+    bgi_assert(bi1->decimal != NULL, "bi1->decimal cannot be NULL");
+
+    if (bi1 == NULL || bi1->numeric == NULL || bi1->decimal == NULL) {
+        return NULL;
+    }
+
+    if (bi1->status_code != BGI_OK || bi1->status_code != LIST_OK || bi1->status_code != LIST_OK) {
+        return NULL;
+    }
+
+    bgi_assert(bi2 != NULL, "bi2 cannot be NULL");
+    bgi_assert(bi2->numeric != NULL, "bi2->numeric cannot be NULL");
+    bgi_assert(bi2->decimal != NULL, "bi2->decimal cannot be NULL");
+
+    if (bi2 == NULL || bi2->numeric == NULL || bi2->decimal == NULL) {
+        return NULL;
+    }
+
+    if (bi2->status_code != BGI_OK || bi2->status_code != LIST_OK || bi2->status_code != LIST_OK) {
+        return NULL;
+    }
+
+    return bgi_add_signed(bi1, bi2, bi2->sign);
+}
+
+BigInt *bgi_sub(const BigInt *bi1, const BigInt *bi2) {
+    BGI_STATS_SCOPE(BGI_STATS_SUB, bgi_stats_digits(bi1, bi2));
+    BGI_TRACE_SCOPE(BGI_STATS_SUB, bgi_probe_len(bi1), bgi_probe_len(bi2));
+
+    bgi_assert(bi1 != NULL, "bi1 cannot be NULL");
+    bgi_assert(bi1->numeric != NULL, "bi1->numeric cannot be NULL");
+    bgi_assert(bi1->decimal != NULL, "bi1->decimal cannot be NULL");
+
+    if (bi1 == NULL || bi1->numeric == NULL || bi1->decimal == NULL) {
+        return NULL;
+    }
+
+    if (bi1->status_code != BGI_OK || bi1->status_code != LIST_OK || bi1->status_code != LIST_OK) {
+        return NULL;
+    }
+
+    bgi_assert(bi2 != NULL, "bi2 cannot be NULL");
+    bgi_assert(bi2->numeric != NULL, "bi2->numeric cannot be NULL");
+    bgi_assert(bi2->decimal != NULL, "bi2->decimal cannot be NULL");
+
+    if (bi2 == NULL || bi2->numeric == NULL || bi2->decimal == NULL) {
+        return NULL;
+    }
+
+    if (bi2->status_code != BGI_OK || bi2->status_code != LIST_OK || bi2->status_code != LIST_OK) {
+        return NULL;
+    }
+
+    return bgi_add_signed(bi1, bi2, !bi2->sign);
+}
+
+// multiplication and division thresholds
+//
+// the compiled in values can be replaced at runtime, 0 restores them
+
+#define BGI_KARATSUBA_MIN_THRESHOLD 4
+
+static const size_t bgi_default_thresholds[BGI_THRESHOLD_COUNT] = {
+    BGI_MULT_KARATSUBA_THRESHOLD,
+    BGI_SQR_KARATSUBA_THRESHOLD,
+    BGI_DIV_NEWTON_THRESHOLD,
+};
+
+static size_t bgi_thresholds[BGI_THRESHOLD_COUNT] = {
+    BGI_MULT_KARATSUBA_THRESHOLD,
+    BGI_SQR_KARATSUBA_THRESHOLD,
+    BGI_DIV_NEWTON_THRESHOLD,
+};
+
+void bgi_set_threshold(BgiThreshold which, size_t digits) {
+    bgi_assert(which < BGI_THRESHOLD_COUNT, "unknown threshold");
+    if (which >= BGI_THRESHOLD_COUNT) {
+        return;
+    }
+    if (digits == 0) {
+        digits = bgi_default_thresholds[which];
+    }
+    // karatsuba splits need a few digits on both halves, newton is only
+    // bounded by the same floor
+    if (digits < BGI_KARATSUBA_MIN_THRESHOLD) {
+        digits = BGI_KARATSUBA_MIN_THRESHOLD;
+    }
+#ifdef BIGINT_THREADS_ENABLED
+    __atomic_store_n(&bgi_thresholds[which], digits, __ATOMIC_RELAXED);
+#else
+    bgi_thresholds[which] = digits;
+#endif
+}
+
+size_t bgi_get_threshold(BgiThreshold which) {
+    bgi_assert(which < BGI_THRESHOLD_COUNT, "unknown threshold");
+    if (which >= BGI_THRESHOLD_COUNT) {
+        return SIZE_MAX;
+    }
+#ifdef BIGINT_THREADS_ENABLED
+    return __atomic_load_n(&bgi_thresholds[which], __ATOMIC_RELAXED);
+#else
+    return bgi_thresholds[which];
+#endif
+}
+
+// karatsuba
+//
+// works on polynomials with uint64 coefficients, carries are only resolved by
+// the caller. (a0+a1)(b0+b1) - a0b0 - a1b1 = a0b1 + a1b0 keeps every
+// coefficient non negative, and each level at most doubles the coefficient
+// bound, which stays far below 2^64 for any list that fits in memory
+
+// basecase products done and expected, for the progress of async tasks
+typedef struct {
+    size_t done;
+    size_t total;
+} BgiKaratsubaProgress;
+
+// basecase products of bgi_kmul for la x lb, la >= lb
+static size_t bgi_kmul_leaves(size_t la, size_t lb, size_t threshold) {
+    if (lb < threshold) {
+        return 1;
+    }
+    if (la >= 2*lb) {
+        size_t rest = la % lb;
+        return (la / lb) * bgi_kmul_leaves(lb, lb, threshold) + (rest > 0 ? bgi_kmul_leaves(lb, rest, threshold) : 0);
+    }
+    size_t m  = la/2;
+    size_t ha = la - m;
+    size_t hb = lb - m;
+    size_t sb = m > hb ? m : hb;
+    return bgi_kmul_leaves(m, m, threshold)
+        + (ha >= hb ? bgi_kmul_leaves(ha, hb, threshold) : bgi_kmul_leaves(hb, ha, threshold))
+        + (ha >= sb ? bgi_kmul_leaves(ha, sb, threshold) : bgi_kmul_leaves(sb, ha, threshold));
+}
+
+// basecase products of bgi_ksqr for la digits
+static size_t bgi_ksqr_leaves(size_t la, size_t threshold) {
+    if (la < threshold) {
+        return 1;
+    }
+    return bgi_ksqr_leaves(la/2, threshold) + 2*bgi_ksqr_leaves(la - la/2, threshold);
+}
+
+// out[0..la+lb-1) += a*b, la >= lb
+static bool bgi_kmul(const uint64_t *a, size_t la, const uint64_t *b, size_t lb, uint64_t *out, size_t threshold, BgiKaratsubaProgress *progress) {
+    if (lb < threshold) {
+        for (size_t i = 0; i < la; i++) {
+            uint64_t value = a[i];
+            if (value == 0) {
+                continue;
+            }
+            uint64_t *row = out + i;
+            for (size_t j = 0; j < lb; j++) {
+                row[j] += value * b[j];
+            }
+        }
+        progress->done++;
+        return bgi_task_checkpoint(progress->done, progress->total);
+    }
+
+    // unbalanced operands are cut into lb sized pieces of a
+    if (la >= 2*lb) {
+        for (size_t offset = 0; offset < la; offset += lb) {
+            size_t len = la - offset < lb ? la - offset : lb;
+            bool ok = len >= lb
+                ? bgi_kmul(a + offset, len, b, lb, out + offset, threshold, progress)
+                : bgi_kmul(b, lb, a + offset, len, out + offset, threshold, progress);
+            if (!ok) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // lb > la/2, so both operands have a high half
+    size_t m   = la/2;
+    size_t ha  = la - m;
+    size_t hb  = lb - m;
+    size_t sb  = m > hb ? m : hb;
+    size_t z1_len = ha + sb - 1;
+
+    BgiScratchMark mark = bgi_scratch_mark();
+    uint64_t *z0   = (uint64_t*)bgi_scratch_calloc(2*m - 1, sizeof(uint64_t));
+    uint64_t *z2   = (uint64_t*)bgi_scratch_calloc(ha + hb - 1, sizeof(uint64_t));
+    uint64_t *z1   = (uint64_t*)bgi_scratch_calloc(z1_len, sizeof(uint64_t));
+    uint64_t *sums = (uint64_t*)bgi_scratch_alloc((ha + sb) * sizeof(uint64_t));
+    if (z0 == NULL || z2 == NULL || z1 == NULL || sums == NULL) {
+        bgi_scratch_release(mark);
+        return false;
+    }
+
+    // a0+a1 has ha coefficients, b0+b1 has sb
+    uint64_t *sa = sums;
+    uint64_t *sbs = sums + ha;
+    for (size_t i = 0; i < ha; i++) {
+        sa[i] = a[m + i] + (i < m ? a[i] : 0);
+    }
+    for (size_t i = 0; i < sb; i++) {
+        sbs[i] = (i < m ? b[i] : 0) + (i < hb ? b[m + i] : 0);
+    }
+
+    bool ok = bgi_kmul(a, m, b, m, z0, threshold, progress)
+        && (ha >= hb ? bgi_kmul(a + m, ha, b + m, hb, z2, threshold, progress) : bgi_kmul(b + m, hb, a + m, ha, z2, threshold, progress))
+        && (ha >= sb ? bgi_kmul(sa, ha, sbs, sb, z1, threshold, progress) : bgi_kmul(sbs, sb, sa, ha, z1, threshold, progress));
+    if (!ok) {
+        bgi_scratch_release(mark);
+        return false;
+    }
+
+    for (size_t i = 0; i < 2*m - 1; i++) {
+        z1[i]  -= z0[i];
+        out[i] += z0[i];
+    }
+    for (size_t i = 0; i < ha + hb - 1; i++) {
+        z1[i]      -= z2[i];
+        out[2*m+i] += z2[i];
+    }
+    for (size_t i = 0; i < z1_len; i++) {
+        out[m+i] += z1[i];
+    }
+
+    bgi_scratch_release(mark);
+    return true;
+}
+
+// out[0..2*la-1) += a*a, the basecase only computes each cross product once
+static bool bgi_ksqr(const uint64_t *a, size_t la, uint64_t *out, size_t threshold, BgiKaratsubaProgress *progress) {
+    if (la < threshold) {
+        for (size_t i = 0; i < la; i++) {
+            uint64_t value = a[i];
+            if (value == 0) {
+                continue;
+            }
+            out[2*i] += value * value;
+            uint64_t twice = 2 * value;
+            uint64_t *row = out + i;
+            for (size_t j = i + 1; j < la; j++) {
+                row[j] += twice * a[j];
+            }
+        }
+        progress->done++;
+        return bgi_task_checkpoint(progress->done, progress->total);
+    }
+
+    size_t m  = la/2;
+    size_t ha = la - m;
+
+    BgiScratchMark mark = bgi_scratch_mark();
+    uint64_t *z0 = (uint64_t*)bgi_scratch_calloc(2*m - 1, sizeof(uint64_t));
+    uint64_t *z2 = (uint64_t*)bgi_scratch_calloc(2*ha - 1, sizeof(uint64_t));
+    uint64_t *z1 = (uint64_t*)bgi_scratch_calloc(2*ha - 1, sizeof(uint64_t));
+    uint64_t *sa = (uint64_t*)bgi_scratch_alloc(ha * sizeof(uint64_t));
+    if (z0 == NULL || z2 == NULL || z1 == NULL || sa == NULL) {
+        bgi_scratch_release(mark);
+        return false;
+    }
+
+    for (size_t i = 0; i < ha; i++) {
+        sa[i] = a[m + i] + (i < m ? a[i] : 0);
+    }
+
+    if (!bgi_ksqr(a, m, z0, threshold, progress) || !bgi_ksqr(a + m, ha, z2, threshold, progress) || !bgi_ksqr(sa, ha, z1, threshold, progress)) {
+        bgi_scratch_release(mark);
+        return false;
+    }
+
+    for (size_t i = 0; i < 2*m - 1; i++) {
+        z1[i]  -= z0[i];
+        out[i] += z0[i];
+    }
+    for (size_t i = 0; i < 2*ha - 1; i++) {
+        z1[i]      -= z2[i];
+        out[2*m+i] += z2[i];
+    }
+    for (size_t i = 0; i < 2*ha - 1; i++) {
+        out[m+i] += z1[i];
+    }
+
+    bgi_scratch_release(mark);
+    return true;
+}
+
+BigInt *bgi_mult(const BigInt *bi1, const BigInt *bi2) {
+    BGI_STATS_SCOPE(BGI_STATS_MULT, bgi_stats_digits(bi1, bi2));
+    BGI_TRACE_SCOPE(BGI_STATS_MULT, bgi_probe_len(bi1), bgi_probe_len(bi2));
+
+    bgi_assert(bi1 != NULL, "bi1 cannot be NULL");
+    bgi_assert(bi1->numeric != NULL, "bi1->numeric cannot be NULL");
+    bgi_assert(bi1->decimal != NULL, "bi1->decimal cannot be NULL");
+
+    if (bi1 == NULL || bi1->numeric == NULL || bi1->decimal == NULL) {
+        return NULL;
+    }
+
+    if (bi1->status_code != BGI_OK || bi1->status_code != LIST_OK || bi1->status_code != LIST_OK) {
+        return NULL;
+    }
+
+    bgi_assert(bi2 != NULL, "bi2 cannot be NULL");
+    bgi_assert(bi2->numeric != NULL, "bi2->numeric cannot be NULL");
+    bgi_assert(bi2->decimal != NULL, "bi2->decimal cannot be NULL");
+
+    if (bi2 == NULL || bi2->numeric == NULL || bi2->decimal == NULL) {
+        return NULL;
+    }
+
+    if (bi2->status_code != BGI_OK || bi2->status_code != LIST_OK || bi2->status_code != LIST_OK) {
+        return NULL;
+    }
+
+    ListSpan n1 = list_span(bi1->numeric);
+    ListSpan d1 = list_span(bi1->decimal);
+    ListSpan n2 = list_span(bi2->numeric);
+    ListSpan d2 = list_span(bi2->decimal);
+
+    size_t la = n1.len + d1.len;
+    size_t lb = n2.len + d2.len;
+    if (la == 0 || lb == 0) {
+        return bgi_from_digits(NULL, 0, NULL, 0, true);
+    }
+
+    // both operands are multiplied as little endian integers, the decimal
+    // point is placed afterwards
+    BgiScratchMark mark = bgi_scratch_mark();
+    uint64_t *columns = (uint64_t*)bgi_scratch_calloc(la + lb, sizeof(uint64_t));
+    int8 *a = (int8*)bgi_scratch_alloc(sizeof(int8) * (la + lb));
+    if (a == NULL || columns == NULL) {
+        bgi_scratch_release(mark);
+        return NULL;
+    }
+
+    int8 *b = a + la;
+    for (size_t i = 0; i < d1.len; i++) {
+        a[i] = d1.data[d1.len-1-i];
+    }
+    memcpy(a + d1.len, n1.data, n1.len);
+    for (size_t i = 0; i < d2.len; i++) {
+        b[i] = d2.data[d2.len-1-i];
+    }
+    memcpy(b + d2.len, n2.data, n2.len);
+
+    // squaring is detected by shared digits, clones of one value square too
+    bool square = bi1->numeric == bi2->numeric && bi1->decimal == bi2->decimal;
+    size_t threshold = bgi_get_threshold(square ? BGI_THRESHOLD_SQR_KARATSUBA : BGI_THRESHOLD_MULT_KARATSUBA);
+    if ((la < lb ? la : lb) >= threshold) {
+        BGI_TRACE_TIER(square ? BGI_TRACE_TIER_KARATSUBA_SQR : BGI_TRACE_TIER_KARATSUBA);
+
+        // karatsuba sums of digits do not fit int8, the operands are widened
+        uint64_t *wide = (uint64_t*)bgi_scratch_alloc((la + lb) * sizeof(uint64_t));
+        if (wide == NULL) {
+            bgi_scratch_release(mark);
+            return NULL;
+        }
+        for (size_t i = 0; i < la + lb; i++) {
+            wide[i] = (uint8_t)a[i];
+        }
+
+        // the leaves are only counted when a task reports progress
+        BgiKaratsubaProgress progress = {0, 0};
+        if (bgi_current_task != NULL) {
+            progress.total = square ? bgi_ksqr_leaves(la, threshold)
+                : la >= lb ? bgi_kmul_leaves(la, lb, threshold) : bgi_kmul_leaves(lb, la, threshold);
+        }
+
+        bool ok = square ? bgi_ksqr(wide, la, columns, threshold, &progress)
+            : la >= lb ? bgi_kmul(wide, la, wide + la, lb, columns, threshold, &progress)
+            : bgi_kmul(wide + la, lb, wide, la, columns, threshold, &progress);
+        if (!ok) {
+            bool cancelled = bgi_current_task != NULL && bgi_task_is_cancelled(bgi_current_task);
+            bgi_scratch_release(mark);
+            return cancelled ? bgi_init_with_status(BGI_CANCELLED) : NULL;
+        }
+        bgi_assert(progress.total == 0 || progress.done == progress.total, "karatsuba leaves were miscounted");
+    } else {
+        BGI_TRACE_TIER(BGI_TRACE_TIER_SCHOOLBOOK);
+
+        // column sums stay below 81 * min(la, lb), so carries are resolved in one pass at the end
+        for (size_t i = 0; i < la; i++) {
+            if (!bgi_task_checkpoint(i, la)) {
+                bgi_scratch_release(mark);
+                return bgi_init_with_status(BGI_CANCELLED);
+            }
+            uint64_t value = a[i];
+            if (value == 0) {
+                continue;
+            }
+            uint64_t *row = columns + i;
+            for (size_t j = 0; j < lb; j++) {
+                row[j] += value * b[j];
+            }
+        }
+    }
+
+    size_t decimal_points = d1.len + d2.len;
+    BigInt *bi3 = bgi_alloc_digits(la + lb - decimal_points, decimal_points);
+    if (bi3 != NULL && bi3->status_code == BGI_OK) {
+        int8 *numeric = list_data(bi3->numeric);
+        int8 *decimal = list_data(bi3->decimal);
+
+        uint64_t carrier = 0;
+        for (size_t i = 0; i < la + lb; i++) {
+            uint64_t value = columns[i] + carrier;
+            carrier = value / 10;
+            if (i < decimal_points) {
+                decimal[decimal_points-1-i] = value % 10;
+            } else {
+                numeric[i-decimal_points] = value % 10;
+            }
+        }
+        bgi_trim(bi3, bi1->sign == bi2->sign);
+    }
+
+    bgi_scratch_release(mark);
+    return bi3;
+}
+
+void bgi_free(BigInt *bi) {
+    if (bi == NULL) return;
+    if (bi->numeric) {
+        list_free(bi->numeric);
+    }
+    if (bi->decimal) {
+        list_free(bi->decimal);
+    }
+    bgi_mem_free(bi->allocator, bi, sizeof(BigInt));
+}
+
+// bitwise operations
+//
+// integers are converted to little-endian base 2^32 limbs, negative values use
+// two's complement with an infinite sign extension (same semantics as GMP)
+
+#define BGI_LIMB_DIGITS 9
+#define BGI_LIMB_DIGITS_BASE 1000000000u
+
+static size_t bgi_limbs_width(const BigInt *bi) {
+    // 9 decimal digits always fit in one 32 bit limb, +1 for the sign limb
+    return list_len(bi->numeric)/BGI_LIMB_DIGITS + 2;
+}
+
+static bool bgi_is_integer(const BigInt *bi) {
+    return list_len(bi->decimal) == 0;
+}
+
+// limbs are taken from the scratch space, the caller releases them
+static uint32_t *bgi_to_limbs(const BigInt *bi, size_t width, size_t *limbs_len) {
+    bgi_assert(width >= bgi_limbs_width(bi), "width is too small for bi");
+
+    uint32_t *limbs = (uint32_t*)bgi_scratch_calloc(width, sizeof(uint32_t));
+    if (limbs == NULL) {
+        return NULL;
+    }
+
+    ListSpan numeric = list_span(bi->numeric);
+    size_t chunk_len = numeric.len % BGI_LIMB_DIGITS;
+    if (chunk_len == 0) {
+        chunk_len = BGI_LIMB_DIGITS;
+    }
+
+    // chunks are taken from the most significant end
+    size_t len = 0;
+    for (size_t end = numeric.len; end > 0; end -= chunk_len, chunk_len = BGI_LIMB_DIGITS) {
+        uint32_t chunk = 0;
+        uint32_t mul   = 1;
+        for (size_t j = end; j-- > end - chunk_len;) {
+            chunk = chunk*10 + numeric.data[j];
+            mul  *= 10;
+        }
+
+        uint64_t carrier = chunk;
+        for (size_t j = 0; j < len; j++) {
+            uint64_t value = (uint64_t)limbs[j] * mul + carrier;
+            limbs[j] = (uint32_t)value;
+            carrier  = value >> 32;
+        }
+        if (carrier != 0) {
+            limbs[len++] = (uint32_t)carrier;
+        }
+    }
+
+    if (limbs_len != NULL) {
+        *limbs_len = len;
+    }
+    return limbs;
+}
+
+static void bgi_limbs_negate(uint32_t *limbs, size_t width) {
+    uint64_t carrier = 1;
+    for (size_t i = 0; i < width; i++) {
+        uint64_t value = (uint64_t)(uint32_t)~limbs[i] + carrier;
+        limbs[i] = (uint32_t)value;
+        carrier  = value >> 32;
+    }
+}
+
+// limbs are used as scratch space and are left zeroed
+static BigInt *bgi_from_limbs(uint32_t *limbs, size_t len, bool sign) {
+    BigInt *bi = bgi_init_text("0");
+    if (bi == NULL) {
+        return NULL;
+    }
+    if (bi->status_code != BGI_OK) {
+        return bi;
+    }
+
+    while (len > 0 && limbs[len-1] == 0) {
+        len--;
+    }
+
+    if (len == 0) {
+        return bi;
+    }
+
+    // a 32 bit limb holds at most 9.64 decimal digits
+    BgiScratchMark mark = bgi_scratch_mark();
+    uint32_t *chunks = (uint32_t*)bgi_scratch_alloc((len*10/9 + 2) * sizeof(uint32_t));
+    if (chunks == NULL) {
+        bi->status_code = BGI_ALLOC_FAIL;
+        return bi;
+    }
+
+    size_t chunks_len = 0;
+    while (len > 0) {
+        uint64_t rem = 0;
+        for (size_t j = len; j-- > 0;) {
+            uint64_t value = (rem << 32) | limbs[j];
+            limbs[j] = (uint32_t)(value / BGI_LIMB_DIGITS_BASE);
+            rem      = value % BGI_LIMB_DIGITS_BASE;
+        }
+        chunks[chunks_len++] = (uint32_t)rem;
+        while (len > 0 && limbs[len-1] == 0) {
+            len--;
+        }
+    }
+
+    for (size_t c = 0; c < chunks_len; c++) {
+        int8 digits[BGI_LIMB_DIGITS];
+        uint32_t value = chunks[c];
+        size_t n = 0;
+
+        // the most significant chunk is not padded with zeros
+        do {
+            digits[n++] = value % 10;
+            value /= 10;
+        } while (c < chunks_len-1 ? n < BGI_LIMB_DIGITS : value != 0);
+
+        list_append_n(bi->numeric, digits, n);
+        if (bi->numeric->status_code != LIST_OK) {
+            bi->status_code = BGI_NUMERIC_FAIL;
+            bgi_scratch_release(mark);
+            return bi;
+        }
+    }
+
+    bgi_scratch_release(mark);
+    bi->sign = sign;
+    return bi;
+}
+
+// two's complement limbs of bi, sign extended to width
+static uint32_t *bgi_to_twos(const BigInt *bi, size_t width) {
+    uint32_t *limbs = bgi_to_limbs(bi, width, NULL);
+    if (limbs == NULL) {
+        return NULL;
+    }
+    if (!bi->sign) {
+        bgi_limbs_negate(limbs, width);
+    }
+    return limbs;
+}
+
+static BigInt *bgi_from_twos(uint32_t *limbs, size_t width) {
+    bool sign = (limbs[width-1] >> 31) == 0;
+    if (!sign) {
+        bgi_limbs_negate(limbs, width);
+    }
+    return bgi_from_limbs(limbs, width, sign);
+}
+
+static BigInt *bgi_bitwise(const BigInt *bi1, const BigInt *bi2, char op) {
+    bgi_assert(bi1 != NULL, "bi1 cannot be NULL");
+    bgi_assert(bi1->numeric != NULL, "bi1->numeric cannot be NULL");
+    bgi_assert(bi1->decimal != NULL, "bi1->decimal cannot be NULL");
+
+    if (bi1 == NULL || bi1->numeric == NULL || bi1->decimal == NULL) {
+        return NULL;
+    }
+
+    if (bi1->status_code != BGI_OK || bi1->numeric->status_code != LIST_OK || bi1->decimal->status_code != LIST_OK) {
+        return NULL;
+    }
+
+    bgi_assert(bi2 != NULL, "bi2 cannot be NULL");
+    bgi_assert(bi2->numeric != NULL, "bi2->numeric cannot be NULL");
+    bgi_assert(bi2->decimal != NULL, "bi2->decimal cannot be NULL");
+
+    if (bi2 == NULL || bi2->numeric == NULL || bi2->decimal == NULL) {
+        return NULL;
+    }
+
+    if (bi2->status_code != BGI_OK || bi2->numeric->status_code != LIST_OK || bi2->decimal->status_code != LIST_OK) {
+        return NULL;
+    }
+
+    if (!bgi_is_integer(bi1) || !bgi_is_integer(bi2)) {
+        return bgi_init_with_status(BGI_NOT_INTEGER);
+    }
+
+    size_t width = bgi_limbs_width(bi1);
+    if (bgi_limbs_width(bi2) > width) {
+        width = bgi_limbs_width(bi2);
+    }
+
+    BgiScratchMark mark = bgi_scratch_mark();
+    uint32_t *limbs1 = bgi_to_twos(bi1, width);
+    uint32_t *limbs2 = bgi_to_twos(bi2, width);
+    if (limbs1 == NULL || limbs2 == NULL) {
+        bgi_scratch_release(mark);
+        return NULL;
+    }
+
+    switch (op) {
+        case '&':
+            for (size_t i = 0; i < width; i++) {
+                limbs1[i] &= limbs2[i];
+            }
+            break;
+        case '|':
+            for (size_t i = 0; i < width; i++) {
+                limbs1[i] |= limbs2[i];
+            }
+            break;
+        case '^':
+            for (size_t i = 0; i < width; i++) {
+                limbs1[i] ^= limbs2[i];
+            }
+            break;
+        default:
+            bgi_assert(false, "unknown bitwise operator");
+            break;
+    }
+
+    BigInt *bi3 = bgi_from_twos(limbs1, width);
+    bgi_scratch_release(mark);
+    return bi3;
+}
+
+BigInt *bgi_and(const BigInt *bi1, const BigInt *bi2) {
+    return bgi_bitwise(bi1, bi2, '&');
+}
+
+BigInt *bgi_or(const BigInt *bi1, const BigInt *bi2) {
+    return bgi_bitwise(bi1, bi2, '|');
+}
+
+BigInt *bgi_xor(const BigInt *bi1, const BigInt *bi2) {
+    return bgi_bitwise(bi1, bi2, '^');
+}
+
+BigInt *bgi_not(const BigInt *bi) {
+    bgi_assert(bi != NULL, "bi cannot be NULL");
+    bgi_assert(bi->numeric != NULL, "bi->numeric cannot be NULL");
+    bgi_assert(bi->decimal != NULL, "bi->decimal cannot be NULL");
+
+    if (bi == NULL || bi->numeric == NULL || bi->decimal == NULL) {
+        return NULL;
+    }
+
+    if (bi->status_code != BGI_OK || bi->numeric->status_code != LIST_OK || bi->decimal->status_code != LIST_OK) {
+        return NULL;
+    }
+
+    if (!bgi_is_integer(bi)) {
+        return bgi_init_with_status(BGI_NOT_INTEGER);
+    }
+
+    size_t width = bgi_limbs_width(bi);
+    BgiScratchMark mark = bgi_scratch_mark();
+    uint32_t *limbs = bgi_to_twos(bi, width);
+    if (limbs == NULL) {
+        bgi_scratch_release(mark);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < width; i++) {
+        limbs[i] = ~limbs[i];
+    }
+
+    BigInt *result = bgi_from_twos(limbs, width);
+    bgi_scratch_release(mark);
+    return result;
+}
+
+BigInt *bgi_shl(const BigInt *bi, size_t n) {
+    bgi_assert(bi != NULL, "bi cannot be NULL");
+    bgi_assert(bi->numeric != NULL, "bi->numeric cannot be NULL");
+    bgi_assert(bi->decimal != NULL, "bi->decimal cannot be NULL");
+
+    if (bi == NULL || bi->numeric == NULL || bi->decimal == NULL) {
+        return NULL;
+    }
+
+    if (bi->status_code != BGI_OK || bi->numeric->status_code != LIST_OK || bi->decimal->status_code != LIST_OK) {
+        return NULL;
+    }
+
+    if (!bgi_is_integer(bi)) {
+        return bgi_init_with_status(BGI_NOT_INTEGER);
+    }
+
+    // shifting left never changes the sign, so work on the magnitude
+    size_t limb_shift = n / 32;
+    size_t bit_shift  = n % 32;
+    size_t width      = bgi_limbs_width(bi) + limb_shift + 1;
+
+    BgiScratchMark mark = bgi_scratch_mark();
+    uint32_t *limbs = bgi_to_limbs(bi, width, NULL);
+    if (limbs == NULL) {
+        bgi_scratch_release(mark);
+        return NULL;
+    }
+
+    for (size_t i = width; i-- > limb_shift;) {
+        uint32_t value = limbs[i - limb_shift] << bit_shift;
+        if (bit_shift > 0 && i - limb_shift > 0) {
+            value |= limbs[i - limb_shift - 1] >> (32 - bit_shift);
+        }
+        limbs[i] = value;
+    }
+    for (size_t i = 0; i < limb_shift; i++) {
+        limbs[i] = 0;
+    }
+
+    BigInt *result = bgi_from_limbs(limbs, width, bi->sign);
+    bgi_scratch_release(mark);
+    return result;
+}
+
+// arithmetic shift, rounds towards negative infinity like GMP's mpz_fdiv_q_2exp
+BigInt *bgi_shr(const BigInt *bi, size_t n) {
+    bgi_assert(bi != NULL, "bi cannot be NULL");
+    bgi_assert(bi->numeric != NULL, "bi->numeric cannot be NULL");
+    bgi_assert(bi->decimal != NULL, "bi->decimal cannot be NULL");
+
+    if (bi == NULL || bi->numeric == NULL || bi->decimal == NULL) {
+        return NULL;
+    }
+
+    if (bi->status_code != BGI_OK || bi->numeric->status_code != LIST_OK || bi->decimal->status_code != LIST_OK) {
+        return NULL;
+    }
+
+    if (!bgi_is_integer(bi)) {
+        return bgi_init_with_status(BGI_NOT_INTEGER);
+    }
+
+    size_t width = bgi_limbs_width(bi);
+    BgiScratchMark mark = bgi_scratch_mark();
+    uint32_t *limbs = bgi_to_twos(bi, width);
+    if (limbs == NULL) {
+        bgi_scratch_release(mark);
+        return NULL;
+    }
+
+    uint32_t fill = bi->sign ? 0 : UINT32_MAX;
+    size_t limb_shift = n / 32;
+    size_t bit_shift  = n % 32;
+
+    for (size_t i = 0; i < width; i++) {
+        uint32_t low  = i + limb_shift < width ? limbs[i + limb_shift] : fill;
+        uint32_t high = i + limb_shift + 1 < width ? limbs[i + limb_shift + 1] : fill;
+        limbs[i] = bit_shift == 0 ? low : (low >> bit_shift) | (high << (32 - bit_shift));
+    }
+
+    BigInt *result = bgi_from_twos(limbs, width);
+    bgi_scratch_release(mark);
+    return result;
+}
+
+static size_t bgi_limb_popcount(uint32_t value) {
+#if defined(__GNUC__)
+    return (size_t)__builtin_popcount(value);
+#else
+    size_t count = 0;
+    while (value != 0) {
+        value &= value - 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+// negative values have infinitely many set bits, SIZE_MAX is returned for them
+size_t bgi_popcount(const BigInt *bi) {
+    bgi_assert(bi != NULL, "bi cannot be NULL");
+    bgi_assert(bi->numeric != NULL, "bi->numeric cannot be NULL");
+    bgi_assert(bi->decimal != NULL, "bi->decimal cannot be NULL");
+    bgi_assert(bgi_is_integer(bi), "bi should be an integer");
+
+    if (bi == NULL || bi->numeric == NULL || bi->decimal == NULL) {
+        return SIZE_MAX;
+    }
+
+    if (!bi->sign || !bgi_is_integer(bi)) {
+        return SIZE_MAX;
+    }
+
+    size_t len   = 0;
+    size_t width = bgi_limbs_width(bi);
+    BgiScratchMark mark = bgi_scratch_mark();
+    uint32_t *limbs = bgi_to_limbs(bi, width, &len);
+    if (limbs == NULL) {
+        bgi_scratch_release(mark);
+        return SIZE_MAX;
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < len; i++) {
+        count += bgi_limb_popcount(limbs[i]);
+    }
+
+    bgi_scratch_release(mark);
+    return count;
+}
+
+bool bgi_test_bit(const BigInt *bi, size_t n) {
+    bgi_assert(bi != NULL, "bi cannot be NULL");
+    bgi_assert(bi->numeric != NULL, "bi->numeric cannot be NULL");
+    bgi_assert(bi->decimal != NULL, "bi->decimal cannot be NULL");
+    bgi_assert(bgi_is_integer(bi), "bi should be an integer");
+
+    if (bi == NULL || bi->numeric == NULL || bi->decimal == NULL || !bgi_is_integer(bi)) {
+        return false;
+    }
+
+    size_t width = bgi_limbs_width(bi);
+    if (n / 32 >= width) {
+        return !bi->sign;
+    }
+
+    BgiScratchMark mark = bgi_scratch_mark();
+    uint32_t *limbs = bgi_to_twos(bi, width);
+    if (limbs == NULL) {
+        bgi_scratch_release(mark);
+        return false;
+    }
+
+    bool bit = (limbs[n / 32] >> (n % 32)) & 1;
+    bgi_scratch_release(mark);
+    return bit;
+}
+
+// power of ten scaling
+//
+// moves the decimal point k places to the right (k > 0) or left (k < 0), the
+// digits are copied once and no arithmetic is done
+
+// digit of 10^e, zero outside of the stored digits
+static inline int8 bgi_digit_at(ListSpan numeric, ListSpan decimal, int64_t e) {
+    if (e >= 0) {
+        return e < (int64_t)numeric.len ? numeric.data[e] : 0;
+    }
+    return -e-1 < (int64_t)decimal.len ? decimal.data[-e-1] : 0;
+}
+
+// shifts by k places to the left (up) or right, the exponents of both ends of
+// the result must fit in an int64_t or BGI_OUT_OF_RANGE is returned
+static BigInt *bgi_shift10_by(const BigInt *bi, uint64_t k, bool up) {
+    BGI_STATS_SCOPE(BGI_STATS_SHIFT10, bgi_stats_digits(bi, NULL));
+    BGI_TRACE_SCOPE(BGI_STATS_SHIFT10, bgi_probe_len(bi), bgi_probe_len(NULL));
+
+    bgi_assert(bi != NULL, "bi cannot be NULL");
+    bgi_assert(bi->numeric != NULL, "bi->numeric cannot be NULL");
+    bgi_assert(bi->decimal != NULL, "bi->decimal cannot be NULL");
+
+    if (bi == NULL || bi->numeric == NULL || bi->decimal == NULL) {
+        return NULL;
+    }
+
+    if (bi->status_code != BGI_OK || bi->numeric->status_code != LIST_OK || bi->decimal->status_code != LIST_OK) {
+        return NULL;
+    }
+
+    ListSpan numeric = list_span(bi->numeric);
+    ListSpan decimal = list_span(bi->decimal);
+    if (numeric.len == 0 && decimal.len == 0) {
+        return bgi_alloc_digits(0, 0);
+    }
+
+    size_t len = up ? numeric.len : decimal.len;
+    if ((uint64_t)len > (uint64_t)INT64_MAX || k > (uint64_t)INT64_MAX - len) {
+        return bgi_init_with_status(BGI_OUT_OF_RANGE);
+    }
+    int64_t shift = up ? (int64_t)k : -(int64_t)k;
+
+    // the digit of 10^e moves to 10^(e+shift), high is exclusive and low inclusive
+    int64_t high = (int64_t)numeric.len + shift;
+    int64_t low  = shift - (int64_t)decimal.len;
+
+    BigInt *bi2 = bgi_alloc_digits(high > 0 ? (size_t)high : 0, low < 0 ? (size_t)-low : 0);
+    if (bi2 == NULL || bi2->status_code != BGI_OK) {
+        return bi2;
+    }
+
+    int8 *numeric2 = list_data(bi2->numeric);
+    for (int64_t e = low > 0 ? low : 0; e < high; e++) {
+        numeric2[e] = bgi_digit_at(numeric, decimal, e - shift);
+    }
+
+    int8 *decimal2 = list_data(bi2->decimal);
+    for (int64_t e = high < 0 ? high : 0; e-- > low;) {
+        decimal2[-e-1] = bgi_digit_at(numeric, decimal, e - shift);
+    }
+
+    return bgi_trim(bi2, bi->sign);
+}
+
+BigInt *bgi_shift10(const BigInt *bi, int64_t k) {
+    // -(uint64_t)k is the magnitude of k, INT64_MIN included
+    return k >= 0 ? bgi_shift10_by(bi, (uint64_t)k, true) : bgi_shift10_by(bi, -(uint64_t)k, false);
+}
+
+BigInt *bgi_mul_pow10(const BigInt *bi, size_t k) {
+    return bgi_shift10_by(bi, k, true);
+}
+
+BigInt *bgi_div_pow10(const BigInt *bi, size_t k) {
+    return bgi_shift10_by(bi, k, false);
+}
+
+// single limb operations
+//
+// the second operand is a native integer, so no BigInt has to be parsed for it
+// and the digits of bi are visited once
+
+static uint64_t bgi_abs_si(int64_t value) {
+    return value < 0 ? (uint64_t)(-(value + 1)) + 1 : (uint64_t)value;
+}
+
+
+BigInt *bgi_init_ui(uint64_t value) {
+    int8 digits[20];
+    size_t len = 0;
+    do {
+        digits[len++] = value % 10;
+        value /= 10;
+    } while (value != 0);
+
+    return bgi_from_digits(digits, len, NULL, 0, true);
+}
+
+BigInt *bgi_init_si(int64_t value) {
+    BigInt *bi = bgi_init_ui(bgi_abs_si(value));
+    if (bi != NULL && bi->status_code == BGI_OK && value < 0) {
+        bi->sign = false;
+    }
+    return bi;
+}
+
+// bi + (negative ? -value : value)
+static BigInt *bgi_add_ui_signed(const BigInt *bi, uint64_t value, bool negative) {
+    bgi_assert(bi != NULL, "bi cannot be NULL");
+    bgi_assert(bi->numeric != NULL, "bi->numeric cannot be NULL");
+    bgi_assert(bi->decimal != NULL, "bi->decimal cannot be NULL");
+
+    if (bi == NULL || bi->numeric == NULL || bi->decimal == NULL) {
+        return NULL;
+    }
+
+    if (bi->status_code != BGI_OK || bi->numeric->status_code != LIST_OK || bi->decimal->status_code != LIST_OK) {
+        return NULL;
+    }
+
+    const int8 *numeric = list_data(bi->numeric);
+    const int8 *decimal = list_data(bi->decimal);
+    size_t numeric_len  = list_len(bi->numeric);
+    size_t decimal_len  = list_len(bi->decimal);
+
+    // 20 extra digits for the carrier of a 64 bit value
+    size_t len = numeric_len + 20;
+    BgiScratchMark mark = bgi_scratch_mark();
+    int8 *digits = (int8*)bgi_scratch_alloc(len);
+    if (digits == NULL) {
+        bgi_scratch_release(mark);
+        return NULL;
+    }
+
+    BigInt *result = NULL;
+
+    if (bi->sign != negative || value == 0) {
+        // same signs, add the magnitudes
+        uint64_t carrier = value;
+        size_t i = 0;
+        for (; i < numeric_len; i++) {
+            uint64_t low = numeric[i] + carrier % 10;
+            digits[i] = low % 10;
+            carrier = carrier / 10 + low / 10;
+        }
+        while (carrier != 0) {
+            digits[i++] = carrier % 10;
+            carrier /= 10;
+        }
+        result = bgi_from_digits(digits, i, decimal, decimal_len, bi->sign);
+        bgi_scratch_release(mark);
+        return result;
+    }
+
+    // different signs, find out which magnitude is bigger
+    bool is_bigger = false;
+    uint64_t numeric_value = 0;
+    for (size_t j = numeric_len; j-- > 0;) {
+        if (numeric_value > (UINT64_MAX - numeric[j]) / 10) {
+            is_bigger = true;
+            break;
+        }
+        numeric_value = numeric_value*10 + numeric[j];
+    }
+
+    if (is_bigger || numeric_value > value || (numeric_value == value && decimal_len > 0)) {
+        // |bi| - value, keeps the sign of bi
+        uint64_t borrow = value;
+        for (size_t i = 0; i < numeric_len; i++) {
+            int8 sub = borrow % 10;
+            int8 n1  = numeric[i];
+            borrow  /= 10;
+            if (n1 < sub) {
+                n1 += 10;
+                borrow++;
+            }
+            digits[i] = n1 - sub;
+        }
+        result = bgi_from_digits(digits, numeric_len, decimal, decimal_len, bi->sign);
+        bgi_scratch_release(mark);
+        return result;
+    }
+
+    // value - |bi|, flips the sign of bi
+    int8 *complement = NULL;
+    size_t complement_len = decimal_len;
+    while (complement_len > 0 && decimal[complement_len-1] == 0) {
+        complement_len--;
+    }
+
+    uint64_t difference = value - numeric_value;
+    if (complement_len > 0) {
+        // value - n - 0.f = (value - n - 1) + (1 - 0.f)
+        difference--;
+        complement = (int8*)bgi_scratch_alloc(complement_len);
+        if (complement == NULL) {
+            bgi_scratch_release(mark);
+            return NULL;
+        }
+        for (size_t j = 0; j < complement_len-1; j++) {
+            complement[j] = 9 - decimal[j];
+        }
+        complement[complement_len-1] = 10 - decimal[complement_len-1];
+    }
+
+    size_t i = 0;
+    do {
+        digits[i++] = difference % 10;
+        difference /= 10;
+    } while (difference != 0);
+
+    result = bgi_from_digits(digits, i, complement, complement_len, !bi->sign);
+    bgi_scratch_release(mark);
+    return result;
+}
+
+BigInt *bgi_add_ui(const BigInt *bi, uint64_t value) {
+    return bgi_add_ui_signed(bi, value, false);
+}
+
+BigInt *bgi_add_si(const BigInt *bi, int64_t value) {
+    return bgi_add_ui_signed(bi, bgi_abs_si(value), value < 0);
+}
+
+BigInt *bgi_mul_ui(const BigInt *bi, uint64_t value) {
+    BGI_STATS_SCOPE(BGI_STATS_MUL_UI, bgi_stats_digits(bi, NULL));
+    BGI_TRACE_SCOPE(BGI_STATS_MUL_UI, bgi_probe_len(bi), bgi_probe_len(NULL));
+
+    bgi_assert(bi != NULL, "bi cannot be NULL");
+    bgi_assert(bi->numeric != NULL, "bi->numeric cannot be NULL");
+    bgi_assert(bi->decimal != NULL, "bi->decimal cannot be NULL");
+
+    if (bi == NULL || bi->numeric == NULL || bi->decimal == NULL) {
+        return NULL;
+    }
+
+    if (bi->status_code != BGI_OK || bi->numeric->status_code != LIST_OK || bi->decimal->status_code != LIST_OK) {
+        return NULL;
+    }
+
+    if (value > UINT32_MAX) {
+        BigInt *multiplier = bgi_init_ui(value);
+        if (multiplier == NULL || multiplier->status_code != BGI_OK) {
+            return multiplier;
+        }
+        BigInt *result = bgi_mult(bi, multiplier);
+        bgi_free(multiplier);
+        return result;
+    }
+
+    const int8 *numeric = list_data(bi->numeric);
+    const int8 *decimal = list_data(bi->decimal);
+    size_t numeric_len  = list_len(bi->numeric);
+    size_t decimal_len  = list_len(bi->decimal);
+    size_t digits_len   = numeric_len + decimal_len;
+
+    // numeric and decimal digits are multiplied as one integer, 9 digits at
+    // a time, a 32 bit multiplier adds at most 10 digits
+    BigInt *result = bgi_alloc_digits(numeric_len + 10, decimal_len);
+    if (result == NULL || result->status_code != BGI_OK) {
+        return result;
+    }
+
+    int8 *numeric2 = list_data(result->numeric);
+    int8 *decimal2 = list_data(result->decimal);
+
+    // position p holds the digit of 10^(p - decimal_len)
+#define BGI_DIGIT(numeric, decimal, p) \
+    (*((p) < decimal_len ? &(decimal)[decimal_len-1-(p)] : &(numeric)[(p)-decimal_len]))
+
+    uint64_t carrier = 0;
+    size_t p = 0;
+    while (p < digits_len) {
+        size_t chunk_len = digits_len - p < BGI_LIMB_DIGITS ? digits_len - p : BGI_LIMB_DIGITS;
+        uint64_t chunk = 0;
+        for (size_t k = p + chunk_len; k-- > p;) {
+            chunk = chunk*10 + BGI_DIGIT(numeric, decimal, k);
+        }
+
+        uint64_t product = chunk * value + carrier;
+        for (size_t k = 0; k < chunk_len; k++, p++) {
+            BGI_DIGIT(numeric2, decimal2, p) = product % 10;
+            product /= 10;
+        }
+        carrier = product;
+    }
+    for (; carrier != 0; p++) {
+        BGI_DIGIT(numeric2, decimal2, p) = carrier % 10;
+        carrier /= 10;
+    }
+#undef BGI_DIGIT
+
+    return bgi_trim(result, bi->sign);
+}
+
+BigInt *bgi_mul_si(const BigInt *bi, int64_t value) {
+    BigInt *result = bgi_mul_ui(bi, bgi_abs_si(value));
+    if (result != NULL && result->status_code == BGI_OK && value < 0 && (list_len(result->numeric) > 0 || list_len(result->decimal) > 0)) {
+        result->sign = !result->sign;
+    }
+    return result;
+}
+
+// q = x / divisor for x < 2^64 using a precomputed reciprocal
+static uint64_t bgi_div_by_reciprocal(uint64_t x, uint64_t divisor, uint64_t reciprocal, uint64_t *rem) {
+#if defined(__SIZEOF_INT128__)
+    uint64_t q = (uint64_t)(((unsigned __int128)x * reciprocal) >> 64);
+    uint64_t r = x - q*divisor;
+    while (r >= divisor) {
+        q++;
+        r -= divisor;
+    }
+    *rem = r;
+    return q;
+#else
+    (void)reciprocal;
+    *rem = x % divisor;
+    return x / divisor;
+#endif
+}
+
+// truncates towards zero, rem gets the magnitude of the remainder
+BigInt *bgi_divmod_ui(const BigInt *bi, uint64_t divisor, uint64_t *rem) {
+    BGI_STATS_SCOPE(BGI_STATS_DIVMOD_UI, bgi_stats_digits(bi, NULL));
+    BGI_TRACE_SCOPE(BGI_STATS_DIVMOD_UI, bgi_probe_len(bi), bgi_probe_len(NULL));
+
+    bgi_assert(bi != NULL, "bi cannot be NULL");
+    bgi_assert(bi->numeric != NULL, "bi->numeric cannot be NULL");
+    bgi_assert(bi->decimal != NULL, "bi->decimal cannot be NULL");
+
+    if (bi == NULL || bi->numeric == NULL || bi->decimal == NULL) {
+        return NULL;
+    }
+
+    if (bi->status_code != BGI_OK || bi->numeric->status_code != LIST_OK || bi->decimal->status_code != LIST_OK) {
+        return NULL;
+    }
+
+    if (!bgi_is_integer(bi)) {
+        return bgi_init_with_status(BGI_NOT_INTEGER);
+    }
+
+    if (divisor == 0) {
+        return bgi_init_with_status(BGI_DIVISION_BY_ZERO);
+    }
+
+    const int8 *numeric = list_data(bi->numeric);
+    size_t numeric_len  = list_len(bi->numeric);
+
+    BigInt *result = bgi_alloc_digits(numeric_len, 0);
+    if (result == NULL || result->status_code != BGI_OK) {
+        return result;
+    }
+
+    // digits are consumed from the most significant end, i counts from there
+    int8 *digits = list_data(result->numeric);
+    size_t top   = numeric_len - 1;
+
+    uint64_t r = 0;
+    if (divisor <= UINT32_MAX) {
+        // r < divisor, so r*10^9 + chunk fits in 64 bits
+        uint64_t reciprocal = UINT64_MAX / divisor;
+        size_t chunk_len = numeric_len % BGI_LIMB_DIGITS;
+        if (chunk_len == 0) {
+            chunk_len = BGI_LIMB_DIGITS;
+        }
+        for (size_t i = 0; i < numeric_len; i += chunk_len, chunk_len = BGI_LIMB_DIGITS) {
+            uint64_t chunk = 0;
+            for (size_t k = i; k < i + chunk_len; k++) {
+                chunk = chunk*10 + numeric[top - k];
+            }
+            uint64_t q = bgi_div_by_reciprocal(r*BGI_LIMB_DIGITS_BASE + chunk, divisor, reciprocal, &r);
+            for (size_t k = i + chunk_len; k-- > i;) {
+                digits[top - k] = q % 10;
+                q /= 10;
+            }
+        }
+    } else {
+        // r*10 can overflow, so compute 10*r + digit modulo divisor step by step
+        for (size_t i = 0; i < numeric_len; i++) {
+            int8 q = 0;
+            uint64_t acc = 0;
+            for (int k = 0; k < 10; k++) {
+                if (acc >= divisor - r) {
+                    acc -= divisor - r;
+                    q++;
+                } else {
+                    acc += r;
+                }
+            }
+            if (acc >= divisor - (uint64_t)numeric[top - i]) {
+                acc -= divisor - (uint64_t)numeric[top - i];
+                q++;
+            } else {
+                acc += numeric[top - i];
+            }
+            digits[top - i] = q;
+            r = acc;
+        }
+    }
+
+    if (rem != NULL) {
+        *rem = r;
+    }
+
+    return bgi_trim(result, bi->sign);
+}
+
+// truncates towards zero, rem gets the sign of bi (same as C's / and %)
+BigInt *bgi_divmod_si(const BigInt *bi, int64_t divisor, int64_t *rem) {
+    uint64_t r = 0;
+    BigInt *result = bgi_divmod_ui(bi, bgi_abs_si(divisor), &r);
+    if (result == NULL || result->status_code != BGI_OK) {
+        return result;
+    }
+
+    if (divisor < 0 && (list_len(result->numeric) > 0 || list_len(result->decimal) > 0)) {
+        result->sign = !result->sign;
+    }
+
+    if (rem != NULL) {
+        *rem = bi->sign ? (int64_t)r : -(int64_t)r;
+    }
+    return result;
+}
+
+// factorial, binomial and primorial
+//
+// factors are packed into 32 bit words and multiplied with a balanced product
+// tree, the top levels of the tree can run on separate threads when
+// BIGINT_THREADS_ENABLED is defined
+
+#define BGI_PROD_LEAF_SIZE 16
+
+typedef struct {
+    uint32_t *words;
+    size_t len;
+    size_t cap;
+} BgiWords;
+
+static bool bgi_words_push(BgiWords *w, uint32_t value) {
+    if (w->len == w->cap) {
+        size_t cap = w->cap == 0 ? 64 : w->cap*2;
+        uint32_t *words = (uint32_t*)realloc(w->words, cap * sizeof(uint32_t));
+        if (words == NULL) {
+            return false;
+        }
+        w->words = words;
+        w->cap   = cap;
+    }
+    w->words[w->len++] = value;
+    return true;
+}
+
+// multiplies value into the last word while it fits in 32 bits
+static bool bgi_words_pack(BgiWords *w, uint32_t value) {
+    if (w->len > 0 && (uint64_t)w->words[w->len-1] * value <= UINT32_MAX) {
+        w->words[w->len-1] *= value;
+        return true;
+    }
+    return bgi_words_push(w, value);
+}
+
+static BigInt *bgi_prod_words(const uint32_t *words, size_t len, size_t nthreads);
+
+#ifdef BIGINT_THREADS_ENABLED
+typedef struct {
+    const uint32_t *words;
+    size_t len;
+    size_t nthreads;
+    BigInt *result;
+} BgiProdTask;
+
+static void *bgi_prod_words_thread(void *arg) {
+    BgiProdTask *task = (BgiProdTask*)arg;
+    task->result = bgi_prod_words(task->words, task->len, task->nthreads);
+    return NULL;
+}
+#endif
+
+static BigInt *bgi_prod_words(const uint32_t *words, size_t len, size_t nthreads) {
+    if (len <= BGI_PROD_LEAF_SIZE) {
+        BigInt *result = bgi_init_ui(1);
+        for (size_t i = 0; i < len && result != NULL && result->status_code == BGI_OK; i++) {
+            BigInt *next = bgi_mul_ui(result, words[i]);
+            bgi_free(result);
+            result = next;
+        }
+        return result;
+    }
+
+    size_t mid = len/2;
+    BigInt *left  = NULL;
+    BigInt *right = NULL;
+
+#ifdef BIGINT_THREADS_ENABLED
+    if (nthreads > 1) {
+        pthread_t thread;
+        BgiProdTask task = {.words=words, .len=mid, .nthreads=nthreads/2, .result=NULL};
+        if (pthread_create(&thread, NULL, bgi_prod_words_thread, &task) == 0) {
+            right = bgi_prod_words(words + mid, len - mid, nthreads - nthreads/2);
+            pthread_join(thread, NULL);
+            left = task.result;
+        }
+    }
+#else
+    (void)nthreads;
+#endif
+
+    if (left == NULL && right == NULL) {
+        left  = bgi_prod_words(words, mid, 1);
+        right = bgi_prod_words(words + mid, len - mid, 1);
+    }
+
+    if (left == NULL || left->status_code != BGI_OK) {
+        bgi_free(right);
+        return left;
+    }
+    if (right == NULL || right->status_code != BGI_OK) {
+        bgi_free(left);
+        return right;
+    }
+
+    BigInt *result = bgi_mult(left, right);
+    bgi_free(left);
+    bgi_free(right);
+    return result;
+}
+
+static BigInt *bgi_prod_words_free(BgiWords *w, size_t nthreads) {
+    BigInt *result = bgi_prod_words(w->words, w->len, nthreads);
+    free(w->words);
+    return result;
+}
+
+// is_composite[i] is true for every composite i <= n
+static bool *bgi_sieve(uint32_t n) {
+    bool *is_composite = (bool*)calloc((size_t)n + 1, sizeof(bool));
+    if (is_composite == NULL) {
+        return NULL;
+    }
+    for (uint64_t i = 2; i*i <= n; i++) {
+        if (is_composite[i]) {
+            continue;
+        }
+        for (uint64_t j = i*i; j <= n; j += i) {
+            is_composite[j] = true;
+        }
+    }
+    return is_composite;
+}
+
+BigInt *bgi_fac_mt(uint32_t n, size_t nthreads) {
+    BgiWords w = {0};
+    for (uint64_t i = 2; i <= n; i++) {
+        if (!bgi_words_pack(&w, (uint32_t)i)) {
+            free(w.words);
+            return NULL;
+        }
+    }
+    return bgi_prod_words_free(&w, nthreads);
+}
+
+BigInt *bgi_fac(uint32_t n) {
+    return bgi_fac_mt(n, 1);
+}
+
+// C(n, k) from the prime factorization n!/(k!(n-k)!), exponents by Legendre's formula
+BigInt *bgi_binomial_mt(uint32_t n, uint32_t k, size_t nthreads) {
+    if (k > n) {
+        return bgi_init_ui(0);
+    }
+
+    bool *is_composite = bgi_sieve(n);
+    if (is_composite == NULL) {
+        return NULL;
+    }
+
+    BgiWords w = {0};
+    for (uint64_t p = 2; p <= n; p++) {
+        if (is_composite[p]) {
+            continue;
+        }
+
+        size_t exponent = 0;
+        for (uint64_t power = p; power <= n; power *= p) {
+            exponent += n/power - k/power - (n-k)/power;
+        }
+
+        for (size_t i = 0; i < exponent; i++) {
+            if (!bgi_words_pack(&w, (uint32_t)p)) {
+                free(is_composite);
+                free(w.words);
+                return NULL;
+            }
+        }
+    }
+
+    free(is_composite);
+    return bgi_prod_words_free(&w, nthreads);
+}
+
+BigInt *bgi_binomial(uint32_t n, uint32_t k) {
+    return bgi_binomial_mt(n, k, 1);
+}
+
+BigInt *bgi_primorial_mt(uint32_t n, size_t nthreads) {
+    bool *is_composite = bgi_sieve(n);
+    if (is_composite == NULL) {
+        return NULL;
+    }
+
+    BgiWords w = {0};
+    for (uint64_t p = 2; p <= n; p++) {
+        if (!is_composite[p] && !bgi_words_pack(&w, (uint32_t)p)) {
+            free(is_composite);
+            free(w.words);
+            return NULL;
+        }
+    }
+
+    free(is_composite);
+    return bgi_prod_words_free(&w, nthreads);
+}
+
+BigInt *bgi_primorial(uint32_t n) {
+    return bgi_primorial_mt(n, 1);
+}
+
+// division
+//
+// the quotient is truncated to the given number of decimal digits, both
+// operands are scaled to integers and divided with schoolbook long division,
+// or with a newton reciprocal for long divisors
+
+// q = n / d for digit arrays, d has no leading zeros, q has n_len digits
+static BigIntStatusCode bgi_divide_digits(const int8 *n, size_t n_len, const int8 *d, size_t d_len, int8 *q) {
+    // remainder is always less than 10*d, so d_len+1 digits are enough
+    size_t r_len = d_len + 1;
+    BgiScratchMark mark = bgi_scratch_mark();
+    int8 *r = (int8*)bgi_scratch_calloc(r_len, sizeof(int8));
+    if (r == NULL) {
+        bgi_scratch_release(mark);
+        return BGI_ALLOC_FAIL;
+    }
+
+    for (size_t i = 0; i < n_len; i++) {
+        if (!bgi_task_checkpoint(i, n_len)) {
+            bgi_scratch_release(mark);
+            return BGI_CANCELLED;
+        }
+        memmove(r, r + 1, r_len - 1);
+        r[r_len-1] = n[i];
+
+        int8 digit = 0;
+        for (;;) {
+            // compare r with d (d has an implicit leading zero)
+            int cmp = r[0] > 0 ? 1 : 0;
+            for (size_t j = 0; cmp == 0 && j < d_len; j++) {
+                if (r[j+1] != d[j]) {
+                    cmp = r[j+1] > d[j] ? 1 : -1;
+                }
+            }
+            if (cmp < 0) {
+                break;
+            }
+
+            int borrow = 0;
+            for (size_t j = d_len; j-- > 0;) {
+                int value = r[j+1] - d[j] - borrow;
+                borrow = value < 0;
+                r[j+1] = value + (borrow ? 10 : 0);
+            }
+            r[0] -= borrow;
+            digit++;
+        }
+        q[i] = digit;
+    }
+
+    bgi_scratch_release(mark);
+    return BGI_OK;
+}
+
+// newton division
+//
+// from BGI_THRESHOLD_DIV_NEWTON divisor digits on, the quotient is taken as
+// n * (1/d). the reciprocal is refined with newton steps y += y*(1 - d*y) that
+// double its correct digits, so each step costs a bgi_mult at its precision
+// and the division a small multiple of one multiplication. the remainder of
+// the estimate then corrects its last digit
+
+static BigInt *bgi_truncate(BigInt *bi, size_t digits) {
+    if (bi == NULL || bi->status_code != BGI_OK) {
+        return bi;
+    }
+    BigInt *result = NULL;
+    if (list_len(bi->decimal) > digits) {
+        result = bgi_from_digits(list_data(bi->numeric), list_len(bi->numeric), list_data(bi->decimal), digits, bi->sign);
+    } else {
+        result = bgi_clone(bi);
+    }
+    bgi_free(bi);
+    return result;
+}
+
+// applies op to bi1 and bi2 and frees both, NULL when anything failed
+static BigInt *bgi_newton_apply(BigInt *(*op)(const BigInt*, const BigInt*), BigInt *bi1, BigInt *bi2) {
+    BigInt *result = NULL;
+    if (bi1 != NULL && bi2 != NULL && bi1->status_code == BGI_OK && bi2->status_code == BGI_OK) {
+        result = op(bi1, bi2);
+    }
+    bgi_free(bi1);
+    bgi_free(bi2);
+    if (result != NULL && result->status_code != BGI_OK) {
+        bgi_free(result);
+        return NULL;
+    }
+    return result;
+}
+
+// value of most significant first digits, int_len of them before the point
+static BigInt *bgi_newton_value(const int8 *digits, size_t int_len, size_t frac_len) {
+    BgiScratchMark mark = bgi_scratch_mark();
+    int8 *numeric = (int8*)bgi_scratch_alloc(int_len + 1);
+    if (numeric == NULL) {
+        bgi_scratch_release(mark);
+        return NULL;
+    }
+    for (size_t i = 0; i < int_len; i++) {
+        numeric[i] = digits[int_len-1-i];
+    }
+
+    BigInt *bi = bgi_from_digits(numeric, int_len, digits + int_len, frac_len, true);
+    bgi_scratch_release(mark);
+    if (bi != NULL && bi->status_code != BGI_OK) {
+        bgi_free(bi);
+        return NULL;
+    }
+    return bi;
+}
+
+// 1/d for d = 0.d[0]d[1]..., with an error below 10^-precision
+static BigInt *bgi_newton_reciprocal(const int8 *d, size_t d_len, size_t precision) {
+    // the start is correct to about 12 digits, d[0] > 0 keeps it below 10
+    double lead  = 0;
+    double scale = 1;
+    for (size_t i = 0; i < d_len && i < 17; i++) {
+        scale /= 10;
+        lead  += d[i] * scale;
+    }
+    BigInt *start = bgi_init_ui((uint64_t)(1e12 / lead));
+    BigInt *y = start != NULL && start->status_code == BGI_OK ? bgi_div_pow10(start, 12) : NULL;
+    bgi_free(start);
+
+    // guard digits absorb the truncations of a step
+    size_t correct = 10;
+    while (y != NULL && y->status_code == BGI_OK && correct < precision) {
+        correct = correct < precision / 2 ? correct * 2 : precision;
+        size_t width = correct + 4;
+
+        BigInt *dy = bgi_newton_apply(bgi_mult, bgi_newton_value(d, 0, d_len < width ? d_len : width), bgi_clone(y));
+        BigInt *e  = bgi_truncate(bgi_newton_apply(bgi_sub, bgi_init_ui(1), dy), width);
+        BigInt *ye = bgi_truncate(bgi_newton_apply(bgi_mult, bgi_clone(y), e), width);
+        y = bgi_newton_apply(bgi_add, y, ye);
+    }
+
+    if (y != NULL && y->status_code != BGI_OK) {
+        bgi_free(y);
+        return NULL;
+    }
+    return y;
+}
+
+// same contract as bgi_divide_digits
+static BigIntStatusCode bgi_divide_newton(const int8 *n, size_t n_len, const int8 *d, size_t d_len, int8 *q) {
+    memset(q, 0, n_len);
+    size_t skip = 0;
+    while (skip < n_len && n[skip] == 0) {
+        skip++;
+    }
+    if (n_len - skip < d_len) {
+        return BGI_OK;
+    }
+
+    // q = n' * y with n' = n/10^d_len below 10^(q_len-1), so y needs q_len+1
+    // correct fraction digits to keep the estimate within one of q
+    const int8 *digits = n + skip;
+    size_t len   = n_len - skip;
+    size_t q_len = len - d_len + 1;
+    size_t precision = q_len + 2;
+
+    BigInt *y  = bgi_newton_reciprocal(d, d_len, precision);
+    BigInt *nf = bgi_newton_value(digits, len - d_len, d_len < precision + 4 ? d_len : precision + 4);
+    BigInt *estimate = bgi_truncate(bgi_newton_apply(bgi_mult, nf, y), 0);
+    if (estimate != NULL && estimate->status_code != BGI_OK) {
+        bgi_free(estimate);
+        estimate = NULL;
+    }
+
+    // r = n - estimate*d moves the estimate onto the quotient
+    BigInt *divisor = bgi_newton_value(d, d_len, 0);
+    BigInt *r = NULL;
+    if (estimate != NULL && divisor != NULL) {
+        r = bgi_newton_apply(bgi_sub, bgi_newton_value(digits, len, 0), bgi_newton_apply(bgi_mult, bgi_clone(estimate), bgi_clone(divisor)));
+    }
+    while (r != NULL && estimate != NULL && !r->sign) {
+        estimate = bgi_newton_apply(bgi_sub, estimate, bgi_init_ui(1));
+        r = bgi_newton_apply(bgi_add, r, bgi_clone(divisor));
+    }
+    while (r != NULL && estimate != NULL && bgi_cmp(r, divisor) >= 0) {
+        estimate = bgi_newton_apply(bgi_add, estimate, bgi_init_ui(1));
+        r = bgi_newton_apply(bgi_sub, r, bgi_clone(divisor));
+    }
+
+    BigIntStatusCode status_code = BGI_OK;
+    if (r == NULL || estimate == NULL) {
+        bool cancelled = bgi_current_task != NULL && bgi_task_is_cancelled(bgi_current_task);
+        status_code = cancelled ? BGI_CANCELLED : BGI_ALLOC_FAIL;
+    } else {
+        ListSpan quotient = list_span(estimate->numeric);
+        for (size_t i = 0; i < quotient.len; i++) {
+            q[n_len-1-i] = quotient.data[i];
+        }
+    }
+
+    bgi_free(estimate);
+    bgi_free(divisor);
+    bgi_free(r);
+    return status_code;
+}
+
+BigInt *bgi_div(const BigInt *bi1, const BigInt *bi2, size_t digits) {
+    BGI_STATS_SCOPE(BGI_STATS_DIV, bgi_stats_digits(bi1, bi2));
+    BGI_TRACE_SCOPE(BGI_STATS_DIV, bgi_probe_len(bi1), bgi_probe_len(bi2));
+
+    bgi_assert(bi1 != NULL, "bi1 cannot be NULL");
+    bgi_assert(bi1->numeric != NULL, "bi1->numeric cannot be NULL");
+    bgi_assert(bi1->decimal != NULL, "bi1->decimal cannot be NULL");
+
+    if (bi1 == NULL || bi1->numeric == NULL || bi1->decimal == NULL) {
+        return NULL;
+    }
+
+    if (bi1->status_code != BGI_OK || bi1->numeric->status_code != LIST_OK || bi1->decimal->status_code != LIST_OK) {
+        return NULL;
+    }
+
+    bgi_assert(bi2 != NULL, "bi2 cannot be NULL");
+    bgi_assert(bi2->numeric != NULL, "bi2->numeric cannot be NULL");
+    bgi_assert(bi2->decimal != NULL, "bi2->decimal cannot be NULL");
+
+    if (bi2 == NULL || bi2->numeric == NULL || bi2->decimal == NULL) {
+        return NULL;
+    }
+
+    if (bi2->status_code != BGI_OK || bi2->numeric->status_code != LIST_OK || bi2->decimal->status_code != LIST_OK) {
+        return NULL;
+    }
+
+    if (list_len(bi2->numeric) == 0 && list_len(bi2->decimal) == 0) {
+        return bgi_init_with_status(BGI_DIVISION_BY_ZERO);
+    }
+
+    // bi1/bi2 = (n1/10^da) / (n2/10^db), so scale n1 by 10^(digits+db-da)
+    size_t la = list_len(bi1->numeric) + list_len(bi1->decimal);
+    size_t lb = list_len(bi2->numeric) + list_len(bi2->decimal);
+    int64_t e = (int64_t)digits + (int64_t)list_len(bi2->decimal) - (int64_t)list_len(bi1->decimal);
+
+    size_t n_len = e >= 0 ? la + (size_t)e : (la > (size_t)-e ? la - (size_t)-e : 0);
+    BgiScratchMark mark = bgi_scratch_mark();
+    int8 *n = (int8*)bgi_scratch_calloc(n_len + 1, sizeof(int8));
+    int8 *d = (int8*)bgi_scratch_alloc(lb);
+    int8 *q = (int8*)bgi_scratch_calloc(n_len + digits + 1, sizeof(int8));
+    if (n == NULL || d == NULL || q == NULL) {
+        bgi_scratch_release(mark);
+        return NULL;
+    }
+
+    // the long division works on most significant first digit arrays
+    ListSpan n1 = list_span(bi1->numeric);
+    ListSpan d1 = list_span(bi1->decimal);
+    ListSpan n2 = list_span(bi2->numeric);
+    ListSpan d2 = list_span(bi2->decimal);
+
+    for (size_t i = 0; i < la && i < n_len; i++) {
+        n[i] = i < n1.len ? n1.data[n1.len-1-i] : d1.data[i - n1.len];
+    }
+
+    size_t d_len = 0;
+    for (size_t i = 0; i < lb; i++) {
+        int8 value = i < n2.len ? n2.data[n2.len-1-i] : d2.data[i - n2.len];
+        if (d_len == 0 && value == 0) {
+            continue;
+        }
+        d[d_len++] = value;
+    }
+
+    BigIntStatusCode status_code = BGI_OK;
+    if (d_len >= bgi_get_threshold(BGI_THRESHOLD_DIV_NEWTON)) {
+        BGI_TRACE_TIER(BGI_TRACE_TIER_NEWTON);
+        status_code = bgi_divide_newton(n, n_len, d, d_len, q + digits);
+    } else {
+        BGI_TRACE_TIER(BGI_TRACE_TIER_SCHOOLBOOK);
+        status_code = bgi_divide_digits(n, n_len, d, d_len, q + digits);
+    }
+    if (status_code != BGI_OK) {
+        bgi_scratch_release(mark);
+        return status_code == BGI_CANCELLED ? bgi_init_with_status(BGI_CANCELLED) : NULL;
+    }
+
+    // q holds `digits` leading zeros so the decimal part can always be taken
+    // from its last `digits` digits
+    BigInt *bi3 = bgi_alloc_digits(n_len, digits);
+    if (bi3 != NULL && bi3->status_code == BGI_OK) {
+        int8 *numeric = list_data(bi3->numeric);
+        for (size_t i = 0; i < n_len; i++) {
+            numeric[i] = q[n_len-1-i];
+        }
+        memcpy(list_data(bi3->decimal), q + n_len, digits);
+        bgi_trim(bi3, bi1->sign == bi2->sign);
+    }
+
+    bgi_scratch_release(mark);
+    return bi3;
+}
+
+// binary splitting
+//
+// evaluates S = sum_{n=0}^{terms-1} a(n)/b(n) * prod_{j=0}^{n} p(j)/q(j) with
+// integer products over halves of the range and a single final division
+
+typedef struct {
+    BigInt *P;
+    BigInt *Q;
+    BigInt *B;
+    BigInt *T;
+} BgiSplit;
+
+static void bgi_split_free(BgiSplit *s) {
+    bgi_free(s->P);
+    bgi_free(s->Q);
+    bgi_free(s->B);
+    bgi_free(s->T);
+    s->P = s->Q = s->B = s->T = NULL;
+}
+
+static bool bgi_split_ok(BgiSplit *s) {
+    BigInt *parts[4] = {s->P, s->Q, s->B, s->T};
+    for (size_t i = 0; i < 4; i++) {
+        if (parts[i] == NULL || parts[i]->status_code != BGI_OK) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static BigInt *bgi_series_term(BigInt *(*fn)(uint64_t, void*), uint64_t n, void *data) {
+    return fn != NULL ? fn(n, data) : bgi_init_ui(1);
+}
+
+// multiplies and frees both operands
+static BigInt *bgi_mult_free(BigInt *bi1, BigInt *bi2) {
+    BigInt *result = NULL;
+    if (bi1 != NULL && bi2 != NULL && bi1->status_code == BGI_OK && bi2->status_code == BGI_OK) {
+        result = bgi_mult(bi1, bi2);
+    }
+    bgi_free(bi1);
+    bgi_free(bi2);
+    return result;
+}
+
+static bool bgi_split(const BgiSeries *series, uint64_t n1, uint64_t n2, size_t nthreads, BgiSplit *s);
+
+#ifdef BIGINT_THREADS_ENABLED
+typedef struct {
+    const BgiSeries *series;
+    uint64_t n1;
+    uint64_t n2;
+    size_t nthreads;
+    BgiSplit split;
+    bool ok;
+} BgiSplitTask;
+
+static void *bgi_split_thread(void *arg) {
+    BgiSplitTask *task = (BgiSplitTask*)arg;
+    task->ok = bgi_split(task->series, task->n1, task->n2, task->nthreads, &task->split);
+    return NULL;
+}
+#endif
+
+static bool bgi_split(const BgiSeries *series, uint64_t n1, uint64_t n2, size_t nthreads, BgiSplit *s) {
+    if (n2 - n1 == 1) {
+        s->P = bgi_series_term(series->p, n1, series->data);
+        s->Q = bgi_series_term(series->q, n1, series->data);
+        s->B = bgi_series_term(series->b, n1, series->data);
+        s->T = NULL;
+        BigInt *a = bgi_series_term(series->a, n1, series->data);
+        if (s->P != NULL && s->P->status_code == BGI_OK && a != NULL && a->status_code == BGI_OK) {
+            s->T = bgi_mult(a, s->P);
+        }
+        bgi_free(a);
+        if (!bgi_split_ok(s)) {
+            bgi_split_free(s);
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t m = n1 + (n2 - n1)/2;
+    BgiSplit l = {0};
+    BgiSplit r = {0};
+    bool l_ok = false;
+    bool r_ok = false;
+    bool done = false;
+
+#ifdef BIGINT_THREADS_ENABLED
+    if (nthreads > 1) {
+        pthread_t thread;
+        BgiSplitTask task = {.series=series, .n1=n1, .n2=m, .nthreads=nthreads/2};
+        if (pthread_create(&thread, NULL, bgi_split_thread, &task) == 0) {
+            r_ok = bgi_split(series, m, n2, nthreads - nthreads/2, &r);
+            pthread_join(thread, NULL);
+            l    = task.split;
+            l_ok = task.ok;
+            done = true;
+        }
+    }
+#else
+    (void)nthreads;
+#endif
+
+    if (!done) {
+        l_ok = bgi_split(series, n1, m, 1, &l);
+        r_ok = l_ok && bgi_split(series, m, n2, 1, &r);
+    }
+
+    if (!l_ok || !r_ok) {
+        bgi_split_free(&l);
+        bgi_split_free(&r);
+        return false;
+    }
+
+    // T = Br*Qr*Tl + Bl*Pl*Tr
+    BigInt *t1 = bgi_mult_free(bgi_mult(r.B, r.Q), bgi_clone(l.T));
+    BigInt *t2 = bgi_mult_free(bgi_mult(l.B, l.P), bgi_clone(r.T));
+    s->T = NULL;
+    if (t1 != NULL && t2 != NULL && t1->status_code == BGI_OK && t2->status_code == BGI_OK) {
+        s->T = bgi_add(t1, t2);
+    }
+    bgi_free(t1);
+    bgi_free(t2);
+
+    s->P = bgi_mult(l.P, r.P);
+    s->Q = bgi_mult(l.Q, r.Q);
+    s->B = bgi_mult(l.B, r.B);
+
+    bgi_split_free(&l);
+    bgi_split_free(&r);
+
+    if (!bgi_split_ok(s)) {
+        bgi_split_free(s);
+        return false;
+    }
+    return true;
+}
+
+BigInt *bgi_series_sum_mt(const BgiSeries *series, uint64_t terms, size_t digits, size_t nthreads) {
+    bgi_assert(series != NULL, "series cannot be NULL");
+    bgi_assert(terms > 0, "terms cannot be 0");
+
+    if (series == NULL) {
+        return NULL;
+    }
+
+    if (terms == 0) {
+        return bgi_init_ui(0);
+    }
+
+    BgiSplit s = {0};
+    if (!bgi_split(series, 0, terms, nthreads, &s)) {
+        return NULL;
+    }
+
+    BigInt *result = NULL;
+    BigInt *denominator = bgi_mult(s.B, s.Q);
+    if (denominator != NULL && denominator->status_code == BGI_OK) {
+        result = bgi_div(s.T, denominator, digits);
+    }
+
+    bgi_free(denominator);
+    bgi_split_free(&s);
+    return result;
+}
+
+BigInt *bgi_series_sum(const BgiSeries *series, uint64_t terms, size_t digits) {
+    return bgi_series_sum_mt(series, terms, digits, 1);
+}
+
+// constants
+//
+// evaluated with a few guard digits and truncated to the requested digits
+
+#define BGI_GUARD_DIGITS 10
+
+static BigInt *bgi_series_n_plus_1(uint64_t n, void *data) {
+    (void)data;
+    return bgi_init_ui(n + 1);
+}
+
+static BigInt *bgi_series_2(uint64_t n, void *data) {
+    (void)n;
+    (void)data;
+    return bgi_init_ui(2);
+}
+
+static BigInt *bgi_series_e_q(uint64_t n, void *data) {
+    (void)data;
+    return bgi_init_ui(n == 0 ? 1 : n);
+}
+
+// smallest n with x^n >= 10^digits
+static uint64_t bgi_series_terms_pow(uint64_t x, size_t digits) {
+    uint64_t n = 0;
+    size_t exponent = 0;
+    double mantissa = 1;
+    while (exponent < digits) {
+        mantissa *= (double)x;
+        while (mantissa >= 10) {
+            mantissa /= 10;
+            exponent++;
+        }
+        n++;
+    }
+    return n;
+}
+
+// smallest n with n! >= 10^digits
+static uint64_t bgi_series_terms_fac(size_t digits) {
+    uint64_t n = 0;
+    size_t exponent = 0;
+    double mantissa = 1;
+    while (exponent < digits) {
+        n++;
+        mantissa *= (double)n;
+        while (mantissa >= 10) {
+            mantissa /= 10;
+            exponent++;
+        }
+    }
+    return n;
+}
+
+// e = sum 1/n!
+BigInt *bgi_const_e(size_t digits) {
+    uint64_t terms = bgi_series_terms_fac(digits + BGI_GUARD_DIGITS) + 1;
+    BgiSeries series = {.a=NULL, .b=NULL, .p=NULL, .q=bgi_series_e_q, .data=NULL};
+    return bgi_truncate(bgi_series_sum(&series, terms, digits + BGI_GUARD_DIGITS), digits);
+}
+
+// log(2) = sum_{n>=0} 1/((n+1) 2^(n+1))
+BigInt *bgi_const_log2(size_t digits) {
+    uint64_t terms = bgi_series_terms_pow(2, digits + BGI_GUARD_DIGITS) + 1;
+    BgiSeries series = {.a=NULL, .b=bgi_series_n_plus_1, .p=NULL, .q=bgi_series_2, .data=NULL};
+    return bgi_truncate(bgi_series_sum(&series, terms, digits + BGI_GUARD_DIGITS), digits);
+}
+
+static BigInt *bgi_series_atan_b(uint64_t n, void *data) {
+    (void)data;
+    return bgi_init_ui(2*n + 1);
+}
+
+static BigInt *bgi_series_atan_p(uint64_t n, void *data) {
+    (void)data;
+    return bgi_init_si(n == 0 ? 1 : -1);
+}
+
+static BigInt *bgi_series_atan_q(uint64_t n, void *data) {
+    uint64_t x = *(uint64_t*)data;
+    return bgi_init_ui(n == 0 ? x : x*x);
+}
+
+// pi = 16 atan(1/5) - 4 atan(1/239), both series are combined into one
+// fraction before the division
+BigInt *bgi_const_pi(size_t digits) {
+    uint64_t x[2] = {5, 239};
+    int64_t  c[2] = {16, -4};
+    BgiSplit s[2] = {{0}};
+
+    for (size_t i = 0; i < 2; i++) {
+        uint64_t terms = bgi_series_terms_pow(x[i]*x[i], digits + BGI_GUARD_DIGITS) + 1;
+        BgiSeries series = {.a=NULL, .b=bgi_series_atan_b, .p=bgi_series_atan_p, .q=bgi_series_atan_q, .data=&x[i]};
+        if (!bgi_split(&series, 0, terms, 1, &s[i])) {
+            bgi_split_free(&s[0]);
+            return NULL;
+        }
+    }
+
+    // pi = (16 T0 D1 - 4 T1 D0) / (D0 D1) with Di = Bi Qi
+    BigInt *d0 = bgi_mult(s[0].B, s[0].Q);
+    BigInt *d1 = bgi_mult(s[1].B, s[1].Q);
+    BigInt *t0 = bgi_mult_free(bgi_mul_si(s[0].T, c[0]), bgi_clone(d1));
+    BigInt *t1 = bgi_mult_free(bgi_mul_si(s[1].T, c[1]), bgi_clone(d0));
+    BigInt *numerator   = NULL;
+    BigInt *denominator = NULL;
+    BigInt *result      = NULL;
+
+    if (t0 != NULL && t1 != NULL && t0->status_code == BGI_OK && t1->status_code == BGI_OK) {
+        numerator = bgi_add(t0, t1);
+    }
+    if (d0 != NULL && d1 != NULL && d0->status_code == BGI_OK && d1->status_code == BGI_OK) {
+        denominator = bgi_mult(d0, d1);
+    }
+    if (numerator != NULL && denominator != NULL && numerator->status_code == BGI_OK && denominator->status_code == BGI_OK) {
+        result = bgi_truncate(bgi_div(numerator, denominator, digits + BGI_GUARD_DIGITS), digits);
+    }
+
+    bgi_free(d0);
+    bgi_free(d1);
+    bgi_free(t0);
+    bgi_free(t1);
+    bgi_free(numerator);
+    bgi_free(denominator);
+    bgi_split_free(&s[0]);
+    bgi_split_free(&s[1]);
+    return result;
+}
+
+// concurrent accumulator
+//
+// every stripe keeps a positive and a negative partial sum that grow in place.
+// adders take the first stripe they can lock without waiting, starting from a
+// per thread hint, so threads spread over the stripes and the add path never
+// blocks on a busy stripe. snapshots merge the stripes one after another, adds
+// that run during a snapshot may or may not be part of it
+
+#define BGI_ACCUMULATOR_STRIPES 64
+
+static BGI_THREAD_LOCAL size_t bgi_accumulator_hint = 0;
+
+static bool bgi_accumulator_try_lock(BgiAccumulatorStripe *stripe) {
+#ifdef BIGINT_THREADS_ENABLED
+    return !__atomic_test_and_set(&stripe->locked, __ATOMIC_ACQUIRE);
+#else
+    if (stripe->locked) {
+        return false;
+    }
+    stripe->locked = true;
+    return true;
+#endif
+}
+
+static void bgi_accumulator_unlock(BgiAccumulatorStripe *stripe) {
+#ifdef BIGINT_THREADS_ENABLED
+    __atomic_clear(&stripe->locked, __ATOMIC_RELEASE);
+#else
+    stripe->locked = false;
+#endif
+}
+
+// backs off while stripes are held by other threads
+static void bgi_accumulator_relax(void) {
+#ifdef BIGINT_THREADS_ENABLED
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+    sched_yield();
+#endif
+}
+
+static BigIntStatusCode bgi_accumulator_status(const BgiAccumulator *acc) {
+#ifdef BIGINT_THREADS_ENABLED
+    return __atomic_load_n(&acc->status_code, __ATOMIC_RELAXED);
+#else
+    return acc->status_code;
+#endif
+}
+
+BgiAccumulator *bgi_accumulator_init(size_t stripes) {
+    if (stripes == 0) {
+        stripes = BGI_ACCUMULATOR_STRIPES;
+    }
+
+    BgiAccumulator *acc = (BgiAccumulator*)malloc(sizeof(BgiAccumulator));
+    bgi_assert(acc != NULL, "accumulator allocation failed: malloc failed");
+    if (acc == NULL) {
+        return NULL;
+    }
+
+    acc->stripes_len = stripes;
+    acc->status_code = BGI_OK;
+    acc->stripes     = (BgiAccumulatorStripe*)aligned_alloc(BGI_CACHE_LINE, stripes * sizeof(BgiAccumulatorStripe));
+    if (acc->stripes == NULL) {
+        acc->status_code = BGI_ALLOC_FAIL;
+        acc->stripes_len = 0;
+        return acc;
+    }
+
+    for (size_t i = 0; i < stripes; i++) {
+        BgiAccumulatorStripe *stripe = &acc->stripes[i];
+        stripe->locked   = false;
+        stripe->positive = bgi_init_text("0");
+        stripe->negative = bgi_init_text("0");
+        if (stripe->positive == NULL || stripe->negative == NULL
+            || stripe->positive->status_code != BGI_OK || stripe->negative->status_code != BGI_OK) {
+            acc->status_code = BGI_ALLOC_FAIL;
+        }
+    }
+
+    return acc;
+}
+
+static void bgi_accumulator_add_signed(BgiAccumulator *acc, const BigInt *bi, bool sign) {
+    bgi_assert(acc != NULL, "acc cannot be NULL");
+    bgi_assert(bi != NULL, "bi cannot be NULL");
+    bgi_assert(bi->numeric != NULL, "bi->numeric cannot be NULL");
+    bgi_assert(bi->decimal != NULL, "bi->decimal cannot be NULL");
+
+    if (acc == NULL || bgi_accumulator_status(acc) != BGI_OK) {
+        return;
+    }
+
+    if (bi == NULL || bi->numeric == NULL || bi->decimal == NULL) {
+        return;
+    }
+
+    if (bi->status_code != BGI_OK || bi->numeric->status_code != LIST_OK || bi->decimal->status_code != LIST_OK) {
+        return;
+    }
+
+    if (bgi_accumulator_hint == 0) {
+        // spread the threads by the address of their own hint
+        bgi_accumulator_hint = (size_t)(((uint64_t)(uintptr_t)&bgi_accumulator_hint * 0x9E3779B97F4A7C15ull) >> 32) + 1;
+    }
+
+    size_t i = bgi_accumulator_hint;
+    size_t tries = 0;
+    BgiAccumulatorStripe *stripe = &acc->stripes[i % acc->stripes_len];
+    while (!bgi_accumulator_try_lock(stripe)) {
+        // every stripe was busy, give the holders some time
+        if (++tries % acc->stripes_len == 0) {
+            bgi_accumulator_relax();
+        }
+        stripe = &acc->stripes[++i % acc->stripes_len];
+    }
+    bgi_accumulator_hint = i;
+
+    bool ok = bgi_add_abs_into(bi->sign == sign ? stripe->positive : stripe->negative, bi);
+    bgi_accumulator_unlock(stripe);
+
+    if (!ok) {
+#ifdef BIGINT_THREADS_ENABLED
+        __atomic_store_n(&acc->status_code, BGI_ALLOC_FAIL, __ATOMIC_RELAXED);
+#else
+        acc->status_code = BGI_ALLOC_FAIL;
+#endif
+    }
+}
+
+void bgi_accumulator_add(BgiAccumulator *acc, const BigInt *bi) {
+    bgi_accumulator_add_signed(acc, bi, true);
+}
+
+void bgi_accumulator_sub(BgiAccumulator *acc, const BigInt *bi) {
+    bgi_accumulator_add_signed(acc, bi, false);
+}
+
+BigInt *bgi_accumulator_snapshot(BgiAccumulator *acc) {
+    bgi_assert(acc != NULL, "acc cannot be NULL");
+
+    if (acc == NULL) {
+        return NULL;
+    }
+
+    if (bgi_accumulator_status(acc) != BGI_OK) {
+        return bgi_init_with_status(bgi_accumulator_status(acc));
+    }
+
+    // the stripes are summed in place, so a stripe is only held for its additions
+    BigInt *positive = bgi_init_text("0");
+    BigInt *negative = bgi_init_text("0");
+    bool ok = positive != NULL && negative != NULL && positive->status_code == BGI_OK && negative->status_code == BGI_OK;
+
+    for (size_t i = 0; ok && i < acc->stripes_len; i++) {
+        BgiAccumulatorStripe *stripe = &acc->stripes[i];
+        while (!bgi_accumulator_try_lock(stripe)) {
+            bgi_accumulator_relax();
+        }
+        ok = bgi_add_abs_into(positive, stripe->positive) && bgi_add_abs_into(negative, stripe->negative);
+        bgi_accumulator_unlock(stripe);
+    }
+
+    if (!ok) {
+        bgi_free(positive);
+        bgi_free(negative);
+        return NULL;
+    }
+
+    BigInt *result = bgi_sub(positive, negative);
+    bgi_free(positive);
+    bgi_free(negative);
+    return result;
+}
+
+void bgi_accumulator_free(BgiAccumulator *acc) {
+    if (acc == NULL) return;
+    for (size_t i = 0; i < acc->stripes_len; i++) {
+        bgi_free(acc->stripes[i].positive);
+        bgi_free(acc->stripes[i].negative);
+    }
+    free(acc->stripes);
+    free(acc);
+}
+
+// batch parsing and formatting
+//
+// the fields are split into contiguous ranges, one per thread, and the calling
+// thread works on the last range itself
+
+typedef struct {
+    const char **texts;
+    BigInt *const *bis;
+    BigInt **parsed;
+    const char **formatted;
+    char *arena;
+    const size_t *offsets;
+    size_t begin;
+    size_t end;
+    size_t ok;
+} BgiBatchTask;
+
+static void bgi_parse_range(BgiBatchTask *task) {
+    for (size_t i = task->begin; i < task->end; i++) {
+        const char *text = task->texts[i];
+        // empty fields are common in columnar files, they are invalid instead of an assertion
+        BigInt *bi = (text == NULL || text[0] == '\0') ? bgi_init_with_status(BGI_INVALID_TEXT_VALUE) : bgi_init(text);
+        task->parsed[i] = bi;
+        if (bi != NULL && bi->status_code == BGI_OK) {
+            task->ok++;
+        }
+    }
+}
+
+static void bgi_format_range(BgiBatchTask *task) {
+    for (size_t i = task->begin; i < task->end; i++) {
+        if (task->offsets[i] == task->offsets[i+1]) {
+            task->formatted[i] = NULL;
+            continue;
+        }
+        char *text = task->arena + task->offsets[i];
+        bgi_write_text(task->bis[i], text);
+        text[task->offsets[i+1] - task->offsets[i] - 1] = '\0';
+        task->formatted[i] = text;
+    }
+}
+
+#ifdef BIGINT_THREADS_ENABLED
+static void *bgi_parse_thread(void *arg) {
+    bgi_parse_range((BgiBatchTask*)arg);
+    return NULL;
+}
+
+static void *bgi_format_thread(void *arg) {
+    bgi_format_range((BgiBatchTask*)arg);
+    return NULL;
+}
+#endif
+
+// runs every range of the template task, returns the sum of the ok counters
+static size_t bgi_batch_run(const BgiBatchTask *base, size_t n, size_t nthreads, bool parse) {
+    if (nthreads == 0) {
+        nthreads = 1;
+    }
+    if (nthreads > n) {
+        nthreads = n > 0 ? n : 1;
+    }
+
+    BgiScratchMark mark = bgi_scratch_mark();
+    BgiBatchTask *tasks = (BgiBatchTask*)bgi_scratch_alloc(nthreads * sizeof(BgiBatchTask));
+    if (tasks == NULL) {
+        nthreads = 1;
+    }
+
+    BgiBatchTask single = *base;
+    size_t range = (n + nthreads - 1) / nthreads;
+    for (size_t t = 0; t < nthreads; t++) {
+        BgiBatchTask *task = tasks != NULL ? &tasks[t] : &single;
+        *task = *base;
+        task->begin = t*range < n ? t*range : n;
+        task->end   = (t+1)*range < n ? (t+1)*range : n;
+        task->ok    = 0;
+    }
+
+#ifdef BIGINT_THREADS_ENABLED
+    pthread_t *threads = (pthread_t*)bgi_scratch_alloc(nthreads * sizeof(pthread_t));
+    bool *started = (bool*)bgi_scratch_calloc(nthreads, sizeof(bool));
+    if (threads != NULL && started != NULL) {
+        for (size_t t = 0; t + 1 < nthreads; t++) {
+            started[t] = pthread_create(&threads[t], NULL, parse ? bgi_parse_thread : bgi_format_thread, &tasks[t]) == 0;
+        }
+    }
+#endif
+
+    size_t ok = 0;
+    for (size_t t = nthreads; t-- > 0;) {
+        BgiBatchTask *task = tasks != NULL ? &tasks[t] : &single;
+#ifdef BIGINT_THREADS_ENABLED
+        if (threads != NULL && started != NULL && started[t]) {
+            pthread_join(threads[t], NULL);
+            ok += task->ok;
+            continue;
+        }
+#endif
+        // the calling thread takes the last range and every range whose thread did not start
+        if (parse) {
+            bgi_parse_range(task);
+        } else {
+            bgi_format_range(task);
+        }
+        ok += task->ok;
+    }
+
+    bgi_scratch_release(mark);
+    return ok;
+}
+
+// out[i] is set for every text (invalid texts get their status code), returns
+// the number of values that were parsed successfully
+size_t bgi_parse_many(const char **texts, size_t n, BigInt **out, size_t nthreads) {
+    bgi_assert(texts != NULL || n == 0, "texts cannot be NULL");
+    bgi_assert(out != NULL || n == 0, "out cannot be NULL");
+
+    if (n == 0 || texts == NULL || out == NULL) {
+        return 0;
+    }
+
+    BgiBatchTask base = {.texts=texts, .parsed=out};
+    return bgi_batch_run(&base, n, nthreads, true);
+}
+
+// all texts are written into one arena that is returned and released with a
+// single free(), out[i] points into it or is NULL when bis[i] is not valid
+char *bgi_format_many(BigInt *const *bis, size_t n, const char **out, size_t nthreads) {
+    bgi_assert(bis != NULL || n == 0, "bis cannot be NULL");
+    bgi_assert(out != NULL || n == 0, "out cannot be NULL");
+
+    if (bis == NULL || out == NULL) {
+        return NULL;
+    }
+
+    BgiScratchMark mark = bgi_scratch_mark();
+    size_t *offsets = (size_t*)bgi_scratch_alloc((n + 1) * sizeof(size_t));
+    if (offsets == NULL) {
+        return NULL;
+    }
+
+    // lengths are known without formatting, so every thread writes to its final place
+    offsets[0] = 0;
+    for (size_t i = 0; i < n; i++) {
+        const BigInt *bi = bis[i];
+        bool valid = bi != NULL && bi->numeric != NULL && bi->decimal != NULL && bi->status_code == BGI_OK
+            && bi->numeric->status_code == LIST_OK && bi->decimal->status_code == LIST_OK;
+        offsets[i+1] = offsets[i] + (valid ? bgi_text_len(bi) + 1 : 0);
+    }
+
+    char *arena = (char*)malloc(offsets[n] > 0 ? offsets[n] : 1);
+    if (arena == NULL) {
+        bgi_scratch_release(mark);
+        return NULL;
+    }
+
+    BgiBatchTask base = {.bis=bis, .formatted=out, .arena=arena, .offsets=offsets};
+    bgi_batch_run(&base, n, nthreads, false);
+
+    bgi_scratch_release(mark);
+    return arena;
+}
+
+// async tasks
+//
+// operations are queued on a library managed pool of BGI_EXECUTOR_THREADS
+// workers that is started by the first submit. without BIGINT_THREADS_ENABLED
+// the operation runs inside the submit call and the handle is already done
+
+#ifndef BGI_EXECUTOR_THREADS
+#define BGI_EXECUTOR_THREADS 4
+#endif
+
+#ifdef BIGINT_THREADS_ENABLED
+static pthread_mutex_t bgi_executor_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  bgi_executor_work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  bgi_executor_done;
+static pthread_once_t  bgi_executor_done_once = PTHREAD_ONCE_INIT;
+static BgiTask  *bgi_executor_head = NULL;
+static BgiTask  *bgi_executor_tail = NULL;
+static bool      bgi_executor_started  = false;
+static bool      bgi_executor_stopping = false;
+static size_t    bgi_executor_workers  = 0;
+static pthread_t bgi_executor_threads[BGI_EXECUTOR_THREADS];
+
+// timed waits run on the monotonic clock, so changing the wall clock does
+// not move their deadlines
+static void bgi_executor_make_done(void) {
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&bgi_executor_done, &attr);
+    pthread_condattr_destroy(&attr);
+}
+#endif
+
+static void bgi_task_run(BgiTask *task) {
+    if (bgi_task_is_cancelled(task)) {
+        task->result = bgi_init_with_status(BGI_CANCELLED);
+        return;
+    }
+
+    bgi_current_task = task;
+    switch (task->op) {
+        case BGI_TASK_MULT:
+            task->result = bgi_mult(task->bi1, task->bi2);
+            break;
+        case BGI_TASK_DIV:
+            task->result = bgi_div(task->bi1, task->bi2, task->digits);
+            break;
+        default:
+            bgi_assert(false, "unknown task operation");
+            break;
+    }
+    bgi_current_task = NULL;
+
+    if (task->result != NULL && task->result->status_code == BGI_OK) {
+        bgi_task_set_progress(task, BGI_TASK_PROGRESS_SCALE);
+    }
+}
+
+#ifdef BIGINT_THREADS_ENABLED
+static void *bgi_executor_thread(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&bgi_executor_lock);
+    for (;;) {
+        while (bgi_executor_head == NULL && !bgi_executor_stopping) {
+            pthread_cond_wait(&bgi_executor_work, &bgi_executor_lock);
+        }
+        // queued tasks are still finished when the executor is shut down
+        if (bgi_executor_head == NULL) {
+            break;
+        }
+
+        BgiTask *task = bgi_executor_head;
+        bgi_executor_head = task->next;
+        if (bgi_executor_head == NULL) {
+            bgi_executor_tail = NULL;
+        }
+        pthread_mutex_unlock(&bgi_executor_lock);
+
+        bgi_task_run(task);
+
+        pthread_mutex_lock(&bgi_executor_lock);
+        task->done = true;
+        pthread_cond_broadcast(&bgi_executor_done);
+    }
+    pthread_mutex_unlock(&bgi_executor_lock);
+    return NULL;
+}
+#endif
+
+static BgiTask *bgi_task_submit(BgiTaskOp op, const BigInt *bi1, const BigInt *bi2, size_t digits) {
+    bgi_assert(bi1 != NULL, "bi1 cannot be NULL");
+    bgi_assert(bi2 != NULL, "bi2 cannot be NULL");
+
+    if (bi1 == NULL || bi2 == NULL) {
+        return NULL;
+    }
+
+    BgiTask *task = (BgiTask*)calloc(1, sizeof(BgiTask));
+    if (task == NULL) {
+        return NULL;
+    }
+
+    task->op     = op;
+    task->digits = digits;
+    task->bi1    = bgi_clone(bi1);
+    task->bi2    = bgi_clone(bi2);
+    if (task->bi1 == NULL || task->bi2 == NULL) {
+        bgi_free(task->bi1);
+        bgi_free(task->bi2);
+        free(task);
+        return NULL;
+    }
+
+#ifdef BIGINT_THREADS_ENABLED
+    pthread_once(&bgi_executor_done_once, bgi_executor_make_done);
+    pthread_mutex_lock(&bgi_executor_lock);
+    if (!bgi_executor_started) {
+        bgi_executor_stopping = false;
+        bgi_executor_workers  = 0;
+        for (size_t i = 0; i < BGI_EXECUTOR_THREADS; i++) {
+            if (pthread_create(&bgi_executor_threads[bgi_executor_workers], NULL, bgi_executor_thread, NULL) == 0) {
+                bgi_executor_workers++;
+            }
+        }
+        bgi_executor_started = bgi_executor_workers > 0;
+    }
+
+    if (bgi_executor_started) {
+        if (bgi_executor_tail != NULL) {
+            bgi_executor_tail->next = task;
+        } else {
+            bgi_executor_head = task;
+        }
+        bgi_executor_tail = task;
+        pthread_cond_signal(&bgi_executor_work);
+        pthread_mutex_unlock(&bgi_executor_lock);
+        return task;
+    }
+    pthread_mutex_unlock(&bgi_executor_lock);
+#endif
+
+    // no worker is available, run on the calling thread
+    bgi_task_run(task);
+    task->done = true;
+    return task;
+}
+
+BgiTask *bgi_async_mult(const BigInt *bi1, const BigInt *bi2) {
+    return bgi_task_submit(BGI_TASK_MULT, bi1, bi2, 0);
+}
+
+BgiTask *bgi_async_div(const BigInt *bi1, const BigInt *bi2, size_t digits) {
+    return bgi_task_submit(BGI_TASK_DIV, bi1, bi2, digits);
+}
+
+bool bgi_task_poll(const BgiTask *task) {
+    bgi_assert(task != NULL, "task cannot be NULL");
+
+    if (task == NULL) {
+        return false;
+    }
+
+#ifdef BIGINT_THREADS_ENABLED
+    pthread_mutex_lock(&bgi_executor_lock);
+    bool done = task->done;
+    pthread_mutex_unlock(&bgi_executor_lock);
+    return done;
+#else
+    return task->done;
+#endif
+}
+
+// true when the task finished within timeout_ms, deadlines are enforced by
+// cancelling the task when this returns false
+bool bgi_task_timed_wait(BgiTask *task, uint64_t timeout_ms) {
+    bgi_assert(task != NULL, "task cannot be NULL");
+
+    if (task == NULL) {
+        return false;
+    }
+
+#ifdef BIGINT_THREADS_ENABLED
+    pthread_once(&bgi_executor_done_once, bgi_executor_make_done);
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec  += (time_t)(timeout_ms / 1000);
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&bgi_executor_lock);
+    while (!task->done) {
+        if (pthread_cond_timedwait(&bgi_executor_done, &bgi_executor_lock, &deadline) != 0) {
+            break;
+        }
+    }
+    bool done = task->done;
+    pthread_mutex_unlock(&bgi_executor_lock);
+    return done;
+#else
+    (void)timeout_ms;
+    return task->done;
+#endif
+}
+
+// the result is handed to the caller once, a cancelled task gives a result
+// with BGI_CANCELLED
+BigInt *bgi_task_wait(BgiTask *task) {
+    bgi_assert(task != NULL, "task cannot be NULL");
+
+    if (task == NULL) {
+        return NULL;
+    }
+
+#ifdef BIGINT_THREADS_ENABLED
+    pthread_once(&bgi_executor_done_once, bgi_executor_make_done);
+    pthread_mutex_lock(&bgi_executor_lock);
+    while (!task->done) {
+        pthread_cond_wait(&bgi_executor_done, &bgi_executor_lock);
+    }
+    pthread_mutex_unlock(&bgi_executor_lock);
+#endif
+
+    BigInt *result = task->result;
+    task->result = NULL;
+    return result;
+}
+
+// the running kernel stops at its next checkpoint, a queued task never starts
+void bgi_task_cancel(BgiTask *task) {
+    bgi_assert(task != NULL, "task cannot be NULL");
+
+    if (task == NULL) {
+        return;
+    }
+
+#ifdef BIGINT_THREADS_ENABLED
+    __atomic_store_n(&task->cancelled, true, __ATOMIC_RELAXED);
+#else
+    task->cancelled = true;
+#endif
+}
+
+// 0.0 to 1.0, measured by the rows the kernel has finished
+double bgi_task_progress(const BgiTask *task) {
+    bgi_assert(task != NULL, "task cannot be NULL");
+
+    if (task == NULL) {
+        return 0.0;
+    }
+
+#ifdef BIGINT_THREADS_ENABLED
+    return (double)__atomic_load_n(&task->progress, __ATOMIC_RELAXED) / BGI_TASK_PROGRESS_SCALE;
+#else
+    return (double)task->progress / BGI_TASK_PROGRESS_SCALE;
+#endif
+}
+
+// a task that is still running is cancelled and waited for
+void bgi_task_free(BgiTask *task) {
+    if (task == NULL) return;
+    bgi_task_cancel(task);
+    bgi_free(bgi_task_wait(task));
+    bgi_free(task->bi1);
+    bgi_free(task->bi2);
+    free(task);
+}
+
+// finishes the queued tasks and joins the workers, the next submit starts them again
+void bgi_executor_shutdown(void) {
+#ifdef BIGINT_THREADS_ENABLED
+    pthread_mutex_lock(&bgi_executor_lock);
+    if (!bgi_executor_started) {
+        pthread_mutex_unlock(&bgi_executor_lock);
+        return;
+    }
+    bgi_executor_stopping = true;
+    pthread_cond_broadcast(&bgi_executor_work);
+    pthread_mutex_unlock(&bgi_executor_lock);
+
+    for (size_t i = 0; i < bgi_executor_workers; i++) {
+        pthread_join(bgi_executor_threads[i], NULL);
+    }
+
+    pthread_mutex_lock(&bgi_executor_lock);
+    bgi_executor_started  = false;
+    bgi_executor_stopping = false;
+    bgi_executor_workers  = 0;
+    pthread_mutex_unlock(&bgi_executor_lock);
+#endif
+}
+
+// expressions
+//
+// operations are recorded into a DAG and only computed by bgi_expr_eval.
+// identical nodes are stored once (hash-consing), a*b + a*c is rewritten to
+// a*(b+c) when the node is built, and chains of single use additions are
+// summed into one positive and one negative accumulator. every operation
+// result is trimmed, so the rewrites give the same digits as eager evaluation
+
+#define BGI_EXPR_MIN_TABLE 64
+
+static bool bgi_expr_same_value(const BigInt *bi1, const BigInt *bi2) {
+    ListSpan n1 = list_span(bi1->numeric);
+    ListSpan d1 = list_span(bi1->decimal);
+    ListSpan n2 = list_span(bi2->numeric);
+    ListSpan d2 = list_span(bi2->decimal);
+    return bi1->sign == bi2->sign && n1.len == n2.len && d1.len == d2.len
+        && memcmp(n1.data, n2.data, n1.len) == 0 && memcmp(d1.data, d2.data, d1.len) == 0;
+}
+
+static size_t bgi_expr_hash(BgiExprOp op, size_t lhs, size_t rhs, const BigInt *value) {
+    uint64_t hash = 14695981039346656037ull;
+    if (value != NULL) {
+        ListSpan numeric = list_span(value->numeric);
+        ListSpan decimal = list_span(value->decimal);
+        for (size_t i = 0; i < numeric.len; i++) {
+            hash = (hash ^ (uint8_t)numeric.data[i]) * 1099511628211ull;
+        }
+        hash = (hash ^ (numeric.len + 11*decimal.len + value->sign)) * 1099511628211ull;
+        for (size_t i = 0; i < decimal.len; i++) {
+            hash = (hash ^ (uint8_t)decimal.data[i]) * 1099511628211ull;
+        }
+        return (size_t)hash;
+    }
+    hash = (hash ^ op) * 1099511628211ull;
+    hash = (hash ^ lhs) * 1099511628211ull;
+    hash = (hash ^ rhs) * 1099511628211ull;
+    return (size_t)(hash ^ (hash >> 29));
+}
+
+static bool bgi_expr_same_node(const BgiExprNode *node, BgiExprOp op, size_t lhs, size_t rhs, const BigInt *value) {
+    if (node->op != op) {
+        return false;
+    }
+    if (op == BGI_EXPR_VALUE) {
+        return bgi_expr_same_value(node->value, value);
+    }
+    return node->lhs == lhs && node->rhs == rhs;
+}
+
+static bool bgi_expr_table_grow(BgiExpr *expr) {
+    size_t cap = expr->table_cap > 0 ? expr->table_cap * 2 : BGI_EXPR_MIN_TABLE;
+    size_t *table = (size_t*)calloc(cap, sizeof(size_t));
+    if (table == NULL) {
+        return false;
+    }
+    for (size_t id = 0; id < expr->len; id++) {
+        const BgiExprNode *node = &expr->nodes[id];
+        size_t slot = bgi_expr_hash(node->op, node->lhs, node->rhs, node->op == BGI_EXPR_VALUE ? node->value : NULL) & (cap - 1);
+        while (table[slot] != 0) {
+            slot = (slot + 1) & (cap - 1);
+        }
+        table[slot] = id + 1;
+    }
+    free(expr->table);
+    expr->table     = table;
+    expr->table_cap = cap;
+    return true;
+}
+
+static size_t bgi_expr_fail(BgiExpr *expr, BigIntStatusCode status_code) {
+    expr->status_code = status_code;
+    return BGI_EXPR_NONE;
+}
+
+// the existing node or a new one, value is only used for leaves and is cloned
+static size_t bgi_expr_node(BgiExpr *expr, BgiExprOp op, size_t lhs, size_t rhs, const BigInt *value) {
+    if ((op == BGI_EXPR_ADD || op == BGI_EXPR_MULT) && lhs > rhs) {
+        size_t tmp = lhs;
+        lhs = rhs;
+        rhs = tmp;
+    }
+
+    if (2*(expr->len + 1) > expr->table_cap && !bgi_expr_table_grow(expr)) {
+        return bgi_expr_fail(expr, BGI_ALLOC_FAIL);
+    }
+
+    size_t slot = bgi_expr_hash(op, lhs, rhs, value) & (expr->table_cap - 1);
+    while (expr->table[slot] != 0) {
+        size_t id = expr->table[slot] - 1;
+        if (bgi_expr_same_node(&expr->nodes[id], op, lhs, rhs, value)) {
+            return id;
+        }
+        slot = (slot + 1) & (expr->table_cap - 1);
+    }
+
+    if (expr->len == expr->cap) {
+        size_t cap = expr->cap > 0 ? expr->cap * 2 : BGI_EXPR_MIN_TABLE;
+        BgiExprNode *nodes = (BgiExprNode*)realloc(expr->nodes, cap * sizeof(BgiExprNode));
+        if (nodes == NULL) {
+            return bgi_expr_fail(expr, BGI_REALLOC_FAIL);
+        }
+        expr->nodes = nodes;
+        expr->cap   = cap;
+    }
+
+    BgiExprNode *node = &expr->nodes[expr->len];
+    node->op    = op;
+    node->lhs   = lhs;
+    node->rhs   = rhs;
+    node->value = NULL;
+    if (op == BGI_EXPR_VALUE) {
+        node->value = bgi_clone(value);
+        if (node->value == NULL) {
+            return bgi_expr_fail(expr, BGI_ALLOC_FAIL);
+        }
+    }
+
+    expr->table[slot] = expr->len + 1;
+    return expr->len++;
+}
+
+BgiExpr *bgi_expr_init(void) {
+    BgiExpr *expr = (BgiExpr*)calloc(1, sizeof(BgiExpr));
+    bgi_assert(expr != NULL, "expr allocation failed: calloc failed");
+    if (expr == NULL) {
+        return NULL;
+    }
+    expr->status_code = BGI_OK;
+    return expr;
+}
+
+size_t bgi_expr_value(BgiExpr *expr, const BigInt *bi) {
+    bgi_assert(expr != NULL, "expr cannot be NULL");
+    bgi_assert(bi != NULL, "bi cannot be NULL");
+    bgi_assert(bi->numeric != NULL, "bi->numeric cannot be NULL");
+    bgi_assert(bi->decimal != NULL, "bi->decimal cannot be NULL");
+
+    if (expr == NULL || expr->status_code != BGI_OK) {
+        return BGI_EXPR_NONE;
+    }
+
+    if (bi == NULL || bi->numeric == NULL || bi->decimal == NULL) {
+        return BGI_EXPR_NONE;
+    }
+
+    if (bi->status_code != BGI_OK || bi->numeric->status_code != LIST_OK || bi->decimal->status_code != LIST_OK) {
+        return bgi_expr_fail(expr, bi->status_code != BGI_OK ? bi->status_code : BGI_NUMERIC_FAIL);
+    }
+
+    return bgi_expr_node(expr, BGI_EXPR_VALUE, BGI_EXPR_NONE, BGI_EXPR_NONE, bi);
+}
+
+static size_t bgi_expr_sum(BgiExpr *expr, BgiExprOp op, size_t lhs, size_t rhs) {
+    if (expr == NULL || expr->status_code != BGI_OK) {
+        return BGI_EXPR_NONE;
+    }
+
+    bgi_assert(lhs < expr->len && rhs < expr->len, "unknown expression node");
+    if (lhs >= expr->len || rhs >= expr->len) {
+        return BGI_EXPR_NONE;
+    }
+
+    // a*b + a*c = a*(b+c)
+    BgiExprNode x = expr->nodes[lhs];
+    BgiExprNode y = expr->nodes[rhs];
+    if (x.op == BGI_EXPR_MULT && y.op == BGI_EXPR_MULT) {
+        size_t shared = BGI_EXPR_NONE;
+        size_t x_other = 0;
+        size_t y_other = 0;
+        if (x.lhs == y.lhs) {
+            shared = x.lhs, x_other = x.rhs, y_other = y.rhs;
+        } else if (x.lhs == y.rhs) {
+            shared = x.lhs, x_other = x.rhs, y_other = y.lhs;
+        } else if (x.rhs == y.lhs) {
+            shared = x.rhs, x_other = x.lhs, y_other = y.rhs;
+        } else if (x.rhs == y.rhs) {
+            shared = x.rhs, x_other = x.lhs, y_other = y.lhs;
+        }
+        if (shared != BGI_EXPR_NONE) {
+            size_t inner = bgi_expr_sum(expr, op, x_other, y_other);
+            if (inner == BGI_EXPR_NONE) {
+                return BGI_EXPR_NONE;
+            }
+            return bgi_expr_node(expr, BGI_EXPR_MULT, shared, inner, NULL);
+        }
+    }
+
+    return bgi_expr_node(expr, op, lhs, rhs, NULL);
+}
+
+size_t bgi_expr_add(BgiExpr *expr, size_t lhs, size_t rhs) {
+    return bgi_expr_sum(expr, BGI_EXPR_ADD, lhs, rhs);
+}
+
+size_t bgi_expr_sub(BgiExpr *expr, size_t lhs, size_t rhs) {
+    return bgi_expr_sum(expr, BGI_EXPR_SUB, lhs, rhs);
+}
+
+size_t bgi_expr_mult(BgiExpr *expr, size_t lhs, size_t rhs) {
+    if (expr == NULL || expr->status_code != BGI_OK) {
+        return BGI_EXPR_NONE;
+    }
+
+    bgi_assert(lhs < expr->len && rhs < expr->len, "unknown expression node");
+    if (lhs >= expr->len || rhs >= expr->len) {
+        return BGI_EXPR_NONE;
+    }
+
+    return bgi_expr_node(expr, BGI_EXPR_MULT, lhs, rhs, NULL);
+}
+
+static bool bgi_expr_is_sum(const BgiExprNode *node) {
+    return node->op == BGI_EXPR_ADD || node->op == BGI_EXPR_SUB;
+}
+
+// operands of id for the evaluation, single use sums below a sum are inlined
+// as signed terms. terms and stack need room for expr->len entries, returns
+// the number of operands
+static size_t bgi_expr_operands(const BgiExpr *expr, const size_t *refs, size_t id, size_t *terms, bool *positive, size_t *stack) {
+    const BgiExprNode *node = &expr->nodes[id];
+    if (node->op == BGI_EXPR_VALUE) {
+        return 0;
+    }
+    if (node->op == BGI_EXPR_MULT) {
+        terms[0] = node->lhs;
+        terms[1] = node->rhs;
+        return 2;
+    }
+
+    // the sign of a pending node is kept in the lowest bit of its stack entry
+    size_t len = 0;
+    size_t top = 0;
+    stack[top++] = id << 1;
+    while (top > 0) {
+        size_t entry = stack[--top];
+        const BgiExprNode *sum = &expr->nodes[entry >> 1];
+        bool negative = entry & 1;
+
+        size_t children[2]  = {sum->lhs, sum->rhs};
+        bool   negatives[2] = {negative, negative != (sum->op == BGI_EXPR_SUB)};
+        for (size_t c = 0; c < 2; c++) {
+            const BgiExprNode *child = &expr->nodes[children[c]];
+            if (bgi_expr_is_sum(child) && refs[children[c]] == 1) {
+                stack[top++] = (children[c] << 1) | negatives[c];
+            } else {
+                terms[len]    = children[c];
+                positive[len] = !negatives[c];
+                len++;
+            }
+        }
+    }
+    return len;
+}
+
+static BigInt *bgi_expr_fused_sum(const BgiExpr *expr, const size_t *terms, const bool *positive, size_t len) {
+    BigInt *sums[2] = {bgi_init_text("0"), bgi_init_text("0")};
+    bool ok = sums[0] != NULL && sums[1] != NULL && sums[0]->status_code == BGI_OK && sums[1]->status_code == BGI_OK;
+    for (size_t i = 0; ok && i < len; i++) {
+        const BigInt *value = expr->nodes[terms[i]].value;
+        ok = bgi_add_abs_into(sums[value->sign == positive[i] ? 0 : 1], value);
+    }
+
+    BigInt *result = ok ? bgi_sub(sums[0], sums[1]) : NULL;
+    bgi_free(sums[0]);
+    bgi_free(sums[1]);
+    return result;
+}
+
+// frees the values of the evaluated operation nodes in order[0..len)
+static void bgi_expr_release(BgiExpr *expr, const size_t *order, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        BgiExprNode *node = &expr->nodes[order[i]];
+        if (node->op != BGI_EXPR_VALUE) {
+            bgi_free(node->value);
+            node->value = NULL;
+        }
+    }
+}
+
+// every needed node is evaluated once in post order, operation values are
+// freed as soon as their last user has been evaluated
+BigInt *bgi_expr_eval(BgiExpr *expr, size_t root) {
+    bgi_assert(expr != NULL, "expr cannot be NULL");
+
+    if (expr == NULL) {
+        return NULL;
+    }
+
+    if (expr->status_code != BGI_OK) {
+        return bgi_init_with_status(expr->status_code);
+    }
+
+    bgi_assert(root < expr->len, "unknown expression node");
+    if (root >= expr->len) {
+        return NULL;
+    }
+
+    if (expr->nodes[root].op == BGI_EXPR_VALUE) {
+        return bgi_clone(expr->nodes[root].value);
+    }
+
+    size_t n = expr->len;
+    BgiScratchMark mark = bgi_scratch_mark();
+    size_t *refs     = (size_t*)bgi_scratch_calloc(n, sizeof(size_t));
+    size_t *uses     = (size_t*)bgi_scratch_calloc(n, sizeof(size_t));
+    bool   *visited  = (bool*)bgi_scratch_calloc(n, sizeof(bool));
+    size_t *order    = (size_t*)bgi_scratch_alloc(n * sizeof(size_t));
+    size_t *stack    = (size_t*)bgi_scratch_alloc((2 * n + 1) * sizeof(size_t));
+    size_t *terms    = (size_t*)bgi_scratch_alloc((n + 1) * sizeof(size_t));
+    bool   *positive = (bool*)bgi_scratch_alloc((n + 1) * sizeof(bool));
+    size_t *inner    = (size_t*)bgi_scratch_alloc(n * sizeof(size_t));
+    if (refs == NULL || uses == NULL || visited == NULL || order == NULL || stack == NULL
+        || terms == NULL || positive == NULL || inner == NULL) {
+        bgi_scratch_release(mark);
+        return NULL;
+    }
+
+    // structural references decide which sums can be inlined into their parent
+    for (size_t id = 0; id < n; id++) {
+        if (expr->nodes[id].op != BGI_EXPR_VALUE) {
+            refs[expr->nodes[id].lhs]++;
+            refs[expr->nodes[id].rhs]++;
         }
-        for (size_t i = decimal_part_start_index; i < strlen(text); i++) {
-            if (text[i] >= 48 && text[i] <= 57) {
-                if (text[i] != '0') {
-                    is_all_decimal_digits_are_zeros = false;
+    }
+    refs[root]++;
+
+    // post order of the needed nodes, the lowest bit of a stack entry is set
+    // once its operands have been pushed. a node can be pending more than once,
+    // only the first entry that reaches the top expands it
+    size_t len = 0;
+    size_t top = 0;
+    stack[top++] = root << 1;
+    while (top > 0) {
+        size_t id = stack[top-1] >> 1;
+        if ((stack[top-1] & 1) == 0) {
+            if (visited[id]) {
+                top--;
+                continue;
+            }
+            visited[id] = true;
+            stack[top-1] |= 1;
+            size_t count = bgi_expr_operands(expr, refs, id, terms, positive, inner);
+            for (size_t i = 0; i < count; i++) {
+                uses[terms[i]]++;
+                if (!visited[terms[i]]) {
+                    stack[top++] = terms[i] << 1;
                 }
-            } else {
-                bi->status_code = BGI_INVALID_TEXT_VALUE;
-                return bi;
             }
+            continue;
         }
+        top--;
+        order[len++] = id;
     }
 
-    if (!is_all_decimal_digits_are_zeros) {
-        for (size_t i = decimal_part_start_index; i < strlen(text); i++) {
-            list_append(bi->decimal, text[i]-'0');
-            if (bi->decimal->status_code != LIST_OK) {
-                bi->status_code = BGI_DECIMAL_FAIL;
-                return bi;
+    for (size_t i = 0; i < len; i++) {
+        BgiExprNode *node = &expr->nodes[order[i]];
+        if (node->op == BGI_EXPR_VALUE) {
+            continue;
+        }
+
+        // a sum with two operands had nothing inlined
+        size_t count = bgi_expr_operands(expr, refs, order[i], terms, positive, inner);
+        const BigInt *lhs = expr->nodes[node->lhs].value;
+        const BigInt *rhs = expr->nodes[node->rhs].value;
+        if (node->op == BGI_EXPR_MULT) {
+            node->value = bgi_mult(lhs, rhs);
+        } else if (count > 2) {
+            node->value = bgi_expr_fused_sum(expr, terms, positive, count);
+        } else {
+            node->value = node->op == BGI_EXPR_ADD ? bgi_add(lhs, rhs) : bgi_sub(lhs, rhs);
+        }
+
+        if (node->value == NULL || node->value->status_code != BGI_OK) {
+            BigInt *failed = node->value;
+            node->value = NULL;
+            bgi_expr_release(expr, order, i);
+            bgi_scratch_release(mark);
+            return failed;
+        }
+
+        for (size_t j = 0; j < count; j++) {
+            BgiExprNode *operand = &expr->nodes[terms[j]];
+            if (--uses[terms[j]] == 0 && operand->op != BGI_EXPR_VALUE) {
+                bgi_free(operand->value);
+                operand->value = NULL;
             }
         }
     }
 
-    if (list_len(bi->numeric) == 0 && list_len(bi->decimal) == 0) {
-        bi->sign = true;
-    }
+    BigInt *result = expr->nodes[root].value;
+    expr->nodes[root].value = NULL;
+    bgi_scratch_release(mark);
+    return result;
+}
 
-    bi->status_code = BGI_OK;
-    return bi;
+void bgi_expr_free(BgiExpr *expr) {
+    if (expr == NULL) return;
+    for (size_t id = 0; id < expr->len; id++) {
+        bgi_free(expr->nodes[id].value);
+    }
+    free(expr->nodes);
+    free(expr->table);
+    free(expr);
 }
 
-void bgi_print(BigInt *bi) {
-    bgi_assert(bi != NULL, "bi cannot be NULL");
-    bgi_assert(bi->numeric != NULL, "bi->numeric cannot be NULL");
-    bgi_assert(bi->decimal != NULL, "bi->decimal cannot be NULL");
+// binary format
+//
+// version byte, flags byte (bit 0 is the sign), scale and limb count as
+// unsigned leb128 varints, then the limbs as little endian uint32 values below
+// 10^9, least significant first. the value is limbs * 10^-scale, so the
+// fraction digits round trip exactly. the decimal digits map to the limbs
+// directly and no base conversion is needed in either direction
+
+#define BGI_BINARY_VERSION 1
+#define BGI_BINARY_NEGATIVE 0x01
+
+static size_t bgi_varint_len(uint64_t value) {
+    size_t len = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        len++;
+    }
+    return len;
+}
 
-    if (bi == NULL || bi->numeric == NULL || bi->decimal == NULL) {
-        return;
+static uint8_t *bgi_varint_write(uint8_t *buf, uint64_t value) {
+    while (value >= 0x80) {
+        *buf++ = (uint8_t)(value | 0x80);
+        value >>= 7;
     }
+    *buf++ = (uint8_t)value;
+    return buf;
+}
 
-    if (bi->status_code != BGI_OK || bi->numeric->status_code != LIST_OK || bi->decimal->status_code != LIST_OK) {
-        return;
+// false when the varint is cut off or does not fit 64 bits
+static bool bgi_varint_read(const uint8_t *buf, size_t len, size_t *pos, uint64_t *value) {
+    uint64_t result = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (*pos >= len) {
+            return false;
+        }
+        uint8_t byte = buf[(*pos)++];
+        if (shift == 63 && byte > 1) {
+            return false;
+        }
+        result |= (uint64_t)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            *value = result;
+            return true;
+        }
     }
+    return false;
+}
 
-    printf("<BigInt %c", bi->sign ? '+' : '-');
+// bytes written, or needed when buf is NULL. 0 when bi is not valid or cap is too small
+size_t bgi_export(const BigInt *bi, uint8_t *buf, size_t cap) {
+    bgi_assert(bi != NULL, "bi cannot be NULL");
 
-    if (list_len(bi->numeric) == 0) {
-        printf("0");
+    if (bi == NULL || bi->numeric == NULL || bi->decimal == NULL || bi->status_code != BGI_OK) {
+        return 0;
     }
 
-    for (size_t i = 0; i < list_len(bi->numeric); i++) {
-        int8 value = list_get(bi->numeric, i);
-        if (bi->numeric->status_code != LIST_OK) {
-            return;
-        }
-        printf("%d", value);
+    // zeros above the integer part and below the fraction carry no information
+    ListSpan n = list_span(bi->numeric);
+    ListSpan d = list_span(bi->decimal);
+    size_t numeric_len = n.len;
+    while (numeric_len > 0 && n.data[numeric_len-1] == 0) {
+        numeric_len--;
+    }
+    size_t scale = d.len;
+    while (scale > 0 && d.data[scale-1] == 0) {
+        scale--;
     }
 
-    if (list_len(bi->decimal) == 0) {
-        printf(">\n");
-    } else {
-        printf(".");
-        for (size_t i = 0; i < list_len(bi->decimal); i++) {
-            int8 value = list_get(bi->decimal, i);
-            if (bi->decimal->status_code != LIST_OK) {
-                return;
-            }
-            printf("%d", value);
+    size_t digits = scale + numeric_len;
+    size_t limbs  = (digits + BGI_LIMB_DIGITS - 1) / BGI_LIMB_DIGITS;
+    size_t size   = 2 + bgi_varint_len(scale) + bgi_varint_len(limbs) + 4 * limbs;
+    if (buf == NULL) {
+        return size;
+    }
+    if (cap < size) {
+        return 0;
+    }
+
+    uint8_t *p = buf;
+    *p++ = BGI_BINARY_VERSION;
+    *p++ = (bi->sign || digits == 0) ? 0 : BGI_BINARY_NEGATIVE;
+    p = bgi_varint_write(p, scale);
+    p = bgi_varint_write(p, limbs);
+
+    // digit i counts 10^(i - scale), fraction digits come first
+    for (size_t k = 0; k < limbs; k++) {
+        uint32_t limb = 0;
+        size_t end = (k + 1) * BGI_LIMB_DIGITS < digits ? (k + 1) * BGI_LIMB_DIGITS : digits;
+        for (size_t i = end; i-- > k * BGI_LIMB_DIGITS;) {
+            int8 digit = i < scale ? d.data[scale-1-i] : n.data[i-scale];
+            limb = limb * 10 + (uint32_t)digit;
         }
-        printf(">\n");
+        p[0] = (uint8_t)limb;
+        p[1] = (uint8_t)(limb >> 8);
+        p[2] = (uint8_t)(limb >> 16);
+        p[3] = (uint8_t)(limb >> 24);
+        p += 4;
     }
+
+    return size;
 }
 
-const char *bgi_get_text(BigInt *bi) {
-    bgi_assert(bi != NULL, "bi cannot be NULL");
-    bgi_assert(bi->numeric != NULL, "bi->numeric cannot be NULL");
-    bgi_assert(bi->decimal != NULL, "bi->decimal cannot be NULL");
+// decodes the value at the start of buf, *used (when not NULL) gets its size.
+// the digits are written straight from buf into the result without an
+// intermediate text, a malformed value gives BGI_INVALID_BINARY and *used = 0
+BigInt *bgi_import(const uint8_t *buf, size_t len, size_t *used) {
+    bgi_assert(buf != NULL || len == 0, "buf cannot be NULL");
 
-    if (bi == NULL || bi->numeric == NULL || bi->decimal == NULL) {
-        return NULL;
+    if (used != NULL) {
+        *used = 0;
     }
-
-    if (bi->status_code != BGI_OK || bi->numeric->status_code != LIST_OK || bi->decimal->status_code != LIST_OK) {
-        return NULL;
+    if (buf == NULL || len < 2 || buf[0] != BGI_BINARY_VERSION || (buf[1] & ~BGI_BINARY_NEGATIVE) != 0) {
+        return bgi_init_with_status(BGI_INVALID_BINARY);
     }
 
-    size_t length = 0;
+    size_t pos = 2;
+    uint64_t scale = 0;
+    uint64_t limbs = 0;
+    if (!bgi_varint_read(buf, len, &pos, &scale) || !bgi_varint_read(buf, len, &pos, &limbs)) {
+        return bgi_init_with_status(BGI_INVALID_BINARY);
+    }
 
-    if (list_len(bi->numeric) == 0 && list_len(bi->decimal) == 0) {
-        length++; // '0'
+    // exported values never have more fraction digits than limb digits, which
+    // also bounds the allocation by the size of buf
+    if (limbs > (len - pos) / 4 || scale > limbs * BGI_LIMB_DIGITS) {
+        return bgi_init_with_status(BGI_INVALID_BINARY);
     }
 
-    if (list_len(bi->numeric) > 0 && list_len(bi->decimal) == 0) {
-        length += 1 + list_len(bi->numeric); // ex: +23, -23
+    size_t digits = (size_t)limbs * BGI_LIMB_DIGITS;
+    BigInt *bi = bgi_alloc_digits(digits - (size_t)scale, (size_t)scale);
+    if (bi == NULL || bi->status_code != BGI_OK) {
+        return bi;
     }
 
-    if (list_len(bi->numeric) == 0 && list_len(bi->decimal) > 0) {
-        length += 3 + list_len(bi->numeric); // ex: +0.23, -0.23
+    int8 *numeric = list_data(bi->numeric);
+    int8 *decimal = list_data(bi->decimal);
+    const uint8_t *p = buf + pos;
+    for (size_t k = 0; k < limbs; k++, p += 4) {
+        uint32_t limb = (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+        if (limb >= BGI_LIMB_DIGITS_BASE) {
+            bgi_free(bi);
+            return bgi_init_with_status(BGI_INVALID_BINARY);
+        }
+        for (size_t i = k * BGI_LIMB_DIGITS; i < (k + 1) * BGI_LIMB_DIGITS; i++) {
+            int8 digit = (int8)(limb % 10);
+            limb /= 10;
+            if (i < scale) {
+                decimal[scale-1-i] = digit;
+            } else {
+                numeric[i-scale] = digit;
+            }
+        }
     }
 
-    if (list_len(bi->numeric) > 0 && list_len(bi->decimal) > 0) {
-        length += 2 + list_len(bi->numeric) + list_len(bi->decimal);  // ex: +23.23, -23.23
+    if (used != NULL) {
+        *used = pos + 4 * (size_t)limbs;
     }
+    return bgi_trim(bi, (buf[1] & BGI_BINARY_NEGATIVE) == 0);
+}
 
-    length++; // for last null terminator for the string
+// the values back to back, buf NULL gives the size needed. 0 when a value is
+// not valid or cap is too small
+size_t bgi_export_many(BigInt *const *bis, size_t n, uint8_t *buf, size_t cap) {
+    bgi_assert(bis != NULL || n == 0, "bis cannot be NULL");
 
-    char *text = (char*)calloc(length, sizeof(char));
-    if (text == NULL) {
-        return NULL;
+    if (bis == NULL && n > 0) {
+        return 0;
     }
 
-    if (list_len(bi->numeric) == 0 && list_len(bi->decimal) == 0) {
-        text[0] = '0';
+    size_t total = 0;
+    for (size_t i = 0; i < n; i++) {
+        size_t size = bgi_export(bis[i], NULL, 0);
+        if (size == 0 || size > SIZE_MAX - total) {
+            return 0;
+        }
+        total += size;
+    }
+    if (buf == NULL) {
+        return total;
+    }
+    if (cap < total) {
+        return 0;
     }
 
-    text[0] = bi->sign ? '+' : '-';
+    size_t pos = 0;
+    for (size_t i = 0; i < n; i++) {
+        pos += bgi_export(bis[i], buf + pos, cap - pos);
+    }
+    return pos;
+}
 
-    if (list_len(bi->numeric) > 0 && list_len(bi->decimal) == 0) {
-        for (size_t i = 0; i < list_len(bi->numeric); i++) {
-            int8 value = list_get(bi->numeric, i);
-            if (bi->numeric->status_code != LIST_OK) {
-                bi->status_code = BGI_NUMERIC_FAIL;
-                free(text);
-                return NULL;
-            }
-            text[i+1] = value + '0'; 
-        }
+// imports up to n values into out and returns how many are valid, decoding
+// stops at the first malformed value, which is left in out with
+// BGI_INVALID_BINARY. the entries after it are set to NULL
+size_t bgi_import_many(const uint8_t *buf, size_t len, BigInt **out, size_t n) {
+    bgi_assert(out != NULL || n == 0, "out cannot be NULL");
+
+    if (out == NULL) {
+        return 0;
     }
 
-    if (list_len(bi->numeric) == 0 && list_len(bi->decimal) > 0) {
-        text[1] = '0';
-        text[2] = '.';
-        for (size_t i = 0; i < list_len(bi->decimal); i++) {
-            int8 value = list_get(bi->decimal, i);
-            if (bi->decimal->status_code != LIST_OK) {
-                bi->status_code = BGI_DECIMAL_FAIL;
-                free(text);
-                return NULL;
-            }
-            text[i+3] = value + '0'; 
+    size_t pos = 0;
+    size_t count = 0;
+    for (; count < n; count++) {
+        size_t used = 0;
+        out[count] = bgi_import(buf != NULL ? buf + pos : NULL, len - pos, &used);
+        if (out[count] == NULL || out[count]->status_code != BGI_OK) {
+            break;
         }
+        pos += used;
     }
 
-    if (list_len(bi->numeric) > 0 && list_len(bi->decimal) > 0) {
-        for (size_t i = 0; i < list_len(bi->numeric); i++) {
-            int8 value = list_get(bi->numeric, i);
-            if (bi->numeric->status_code != LIST_OK) {
-                bi->status_code = BGI_NUMERIC_FAIL;
-                free(text);
-                return NULL;
-            }
-            text[i+1] = value + '0'; 
-        }
-        text[1 + list_len(bi->numeric)] = '.';
-        for (size_t i = 0; i < list_len(bi->decimal); i++) {
-            int8 value = list_get(bi->decimal, i);
-            if (bi->decimal->status_code != LIST_OK) {
-                bi->status_code = BGI_DECIMAL_FAIL;
-                free(text);
-                return NULL;
-            }
-            text[i+2+list_len(bi->numeric)] = value + '0'; 
-        }
+    for (size_t i = count + 1; i < n; i++) {
+        out[i] = NULL;
     }
+    return count;
+}
 
-    return text;
+// mapped files
+//
+// bgi_save writes the digit lists as they are stored, after a 24 byte header
+// ("BGIM", version, sign, 2 unused bytes, numeric and decimal length as little
+// endian uint64). bgi_map maps such a file and points the lists of the result
+// into the mapping, so the value is ready without reading or parsing it and
+// pages are only loaded when an operation touches them. the mapping is read
+// only, bgi_unshare copies mapped digits before they are modified. besides the
+// header only the digits at both ends are checked, the ones in between are
+// trusted to come from bgi_save
+
+#define BGI_MAP_MAGIC "BGIM"
+#define BGI_MAP_VERSION 1
+#define BGI_MAP_HEADER 24
+
+static void bgi_map_put_u64(unsigned char *p, uint64_t value) {
+    for (size_t i = 0; i < 8; i++) {
+        p[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+static uint64_t bgi_map_get_u64(const unsigned char *p) {
+    uint64_t value = 0;
+    for (size_t i = 8; i-- > 0;) {
+        value = value << 8 | p[i];
+    }
+    return value;
 }
 
-BigInt *bgi_clone(BigInt *bi) {
+bool bgi_save(const BigInt *bi, const char *path) {
     bgi_assert(bi != NULL, "bi cannot be NULL");
-    bgi_assert(bi->numeric != NULL, "bi->numeric cannot be NULL");
-    bgi_assert(bi->decimal != NULL, "bi->decimal cannot be NULL");
+    bgi_assert(path != NULL, "path cannot be NULL");
 
-    if (bi == NULL || bi->numeric == NULL || bi->decimal == NULL) {
-        return NULL;
+    if (bi == NULL || bi->numeric == NULL || bi->decimal == NULL || bi->status_code != BGI_OK || path == NULL) {
+        return false;
     }
 
-    if (bi->status_code != BGI_OK || bi->numeric->status_code != LIST_OK || bi->decimal->status_code != LIST_OK) {
-        return NULL;
+    ListSpan n = list_span(bi->numeric);
+    ListSpan d = list_span(bi->decimal);
+
+    unsigned char header[BGI_MAP_HEADER] = {0};
+    memcpy(header, BGI_MAP_MAGIC, 4);
+    header[4] = BGI_MAP_VERSION;
+    header[5] = bi->sign ? 1 : 0;
+    bgi_map_put_u64(header + 8, n.len);
+    bgi_map_put_u64(header + 16, d.len);
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        return false;
     }
+    bool ok = fwrite(header, 1, BGI_MAP_HEADER, file) == BGI_MAP_HEADER
+        && fwrite(n.data, 1, n.len, file) == n.len
+        && fwrite(d.data, 1, d.len, file) == d.len;
+    return fclose(file) == 0 && ok;
+}
 
-    BigInt *bi_copy = (BigInt*)malloc(sizeof(BigInt));
-    if (bi_copy == NULL) {
-        return NULL;
+#ifdef BGI_POSIX_FILES
+// the lists of a mapped value allocate through this, it counts their blocks
+// and unmaps the file when the last one is freed. a mapped buffer that has to
+// grow is copied to the heap
+typedef struct {
+    BgiAllocator allocator;
+    unsigned char *addr;
+    size_t size;
+    size_t blocks;
+} BgiMapping;
+
+static bool bgi_mapping_owns(const BgiMapping *mapping, const void *ptr) {
+    // an empty decimal list points at the end of the mapping
+    const unsigned char *p = (const unsigned char*)ptr;
+    return p >= mapping->addr && p <= mapping->addr + mapping->size;
+}
+
+static void bgi_mapping_retain(BgiMapping *mapping) {
+#ifdef BIGINT_THREADS_ENABLED
+    __atomic_add_fetch(&mapping->blocks, 1, __ATOMIC_RELAXED);
+#else
+    mapping->blocks++;
+#endif
+}
+
+static void bgi_mapping_release(BgiMapping *mapping) {
+#ifdef BIGINT_THREADS_ENABLED
+    if (__atomic_sub_fetch(&mapping->blocks, 1, __ATOMIC_ACQ_REL) > 0) return;
+#else
+    if (--mapping->blocks > 0) return;
+#endif
+    munmap(mapping->addr, mapping->size);
+    free(mapping);
+}
+
+static void *bgi_mapping_alloc(size_t size, void *data) {
+    void *ptr = malloc(size);
+    if (ptr != NULL) {
+        bgi_mapping_retain((BgiMapping*)data);
     }
+    return ptr;
+}
 
-    bi_copy->sign = bi->sign;
-    bi_copy->status_code = BGI_OK;
+static void *bgi_mapping_realloc(void *ptr, size_t old_size, size_t new_size, void *data) {
+    BgiMapping *mapping = (BgiMapping*)data;
+    if (!bgi_mapping_owns(mapping, ptr)) {
+        return realloc(ptr, new_size);
+    }
+    // the heap copy takes over the block count of the mapped buffer
+    void *copy = malloc(new_size);
+    if (copy != NULL) {
+        memcpy(copy, ptr, old_size < new_size ? old_size : new_size);
+    }
+    return copy;
+}
 
-    // numeric part
-    bi_copy->numeric = list_clone(bi->numeric);
-    if (bi_copy->numeric == NULL || bi_copy->numeric->status_code != LIST_OK) {
-        bi_copy->status_code = BGI_NUMERIC_FAIL;
-        return bi_copy;
+static void bgi_mapping_free(void *ptr, size_t size, void *data) {
+    (void)size;
+    BgiMapping *mapping = (BgiMapping*)data;
+    if (!bgi_mapping_owns(mapping, ptr)) {
+        free(ptr);
     }
+    bgi_mapping_release(mapping);
+}
 
-    // decimal part
-    bi_copy->decimal = list_clone(bi->decimal);
-    if (bi_copy->decimal == NULL || bi_copy->decimal->status_code != LIST_OK) {
-        bi_copy->status_code = BGI_DECIMAL_FAIL;
-        return bi_copy;
+// a list of len digits at offset, both the list and its buffer count as blocks
+static List *bgi_mapping_list(BgiMapping *mapping, size_t offset, size_t len) {
+    List *l = (List*)bgi_mem_alloc(&mapping->allocator, sizeof(List));
+    if (l == NULL) {
+        return NULL;
     }
+    bgi_mapping_retain(mapping);
+    l->index       = len;
+    l->bufsize     = len;
+    l->buf         = mapping->addr + offset;
+    l->status_code = LIST_OK;
+    l->refcount    = 1;
+    l->allocator   = &mapping->allocator;
+    return l;
+}
+#endif
 
-    return bi_copy;
+static bool list_is_mapped(const List *l) {
+#ifdef BGI_POSIX_FILES
+    return l->allocator->free == bgi_mapping_free
+        && bgi_mapping_owns((const BgiMapping*)l->allocator->data, l->buf);
+#else
+    (void)l;
+    return false;
+#endif
 }
 
-int bgi_cmp(BigInt *bi1, BigInt *bi2) {
-    if (bi1->sign && !bi2->sign) {
-        return 1;
+// the last digit of both lists is the most significant numeric digit and the
+// least significant decimal digit, a trimmed value has neither zero
+static bool bgi_map_digits_valid(const unsigned char *digits, size_t len) {
+    return len == 0 || (digits[len-1] >= 1 && digits[len-1] <= 9);
+}
+
+// the result can be used like any other value and is released with bgi_free,
+// BGI_MAP_FAIL when the file cannot be mapped or its header or end digits are
+// not the ones bgi_save writes
+BigInt *bgi_map(const char *path) {
+    bgi_assert(path != NULL, "path cannot be NULL");
+
+#ifdef BGI_POSIX_FILES
+    if (path == NULL) {
+        return bgi_init_with_status(BGI_MAP_FAIL);
     }
 
-    if (!bi1->sign && bi2->sign) {
-        return -1;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return bgi_init_with_status(BGI_MAP_FAIL);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < BGI_MAP_HEADER) {
+        close(fd);
+        return bgi_init_with_status(BGI_MAP_FAIL);
+    }
+    size_t size = (size_t)st.st_size;
+    void *addr = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return bgi_init_with_status(BGI_MAP_FAIL);
     }
 
-    if (bi1->sign) {
-        if (list_len(bi1->numeric) > list_len(bi2->numeric)) {
-            return 1;
-        }
+    const unsigned char *header = (const unsigned char*)addr;
+    uint64_t numeric_len = bgi_map_get_u64(header + 8);
+    uint64_t decimal_len = bgi_map_get_u64(header + 16);
+    if (memcmp(header, BGI_MAP_MAGIC, 4) != 0 || header[4] != BGI_MAP_VERSION || header[5] > 1
+        || numeric_len > size - BGI_MAP_HEADER || decimal_len != size - BGI_MAP_HEADER - numeric_len
+        || !bgi_map_digits_valid(header + BGI_MAP_HEADER, (size_t)numeric_len)
+        || !bgi_map_digits_valid(header + BGI_MAP_HEADER + numeric_len, (size_t)decimal_len)
+        || (numeric_len == 0 && decimal_len == 0 && header[5] != 1)) {
+        munmap(addr, size);
+        return bgi_init_with_status(BGI_MAP_FAIL);
+    }
 
-        if (list_len(bi1->numeric) < list_len(bi2->numeric)) {
-            return -1;
-        }
+    BgiMapping *mapping = (BgiMapping*)malloc(sizeof(BgiMapping));
+    BigInt *bi = bgi_init_text("0");
+    if (mapping == NULL || bi == NULL || bi->status_code != BGI_OK) {
+        free(mapping);
+        munmap(addr, size);
+        bgi_free(bi);
+        return bgi_init_with_status(BGI_MAP_FAIL);
+    }
+    mapping->allocator = (BgiAllocator){bgi_mapping_alloc, bgi_mapping_realloc, bgi_mapping_free, mapping};
+    mapping->addr   = (unsigned char*)addr;
+    mapping->size   = size;
+    mapping->blocks = 1; // held until both lists are in place
+
+    List *numeric = bgi_mapping_list(mapping, BGI_MAP_HEADER, (size_t)numeric_len);
+    List *decimal = bgi_mapping_list(mapping, BGI_MAP_HEADER + (size_t)numeric_len, (size_t)decimal_len);
+    if (numeric == NULL || decimal == NULL) {
+        list_free(numeric);
+        list_free(decimal);
+        bgi_mapping_release(mapping);
+        bgi_free(bi);
+        return bgi_init_with_status(BGI_MAP_FAIL);
+    }
 
-        for (size_t i = 0; i < list_len(bi1->numeric); i++) {
-            int8 n1 = list_get(bi1->numeric, i);
-            int8 n2 = list_get(bi2->numeric, i);
-            if (n1 > n2) {
-                return 1;
-            }
-            if (n1 < n2) {
-                return -1;
-            }
-        }
+    list_free(bi->numeric);
+    list_free(bi->decimal);
+    bi->numeric = numeric;
+    bi->decimal = decimal;
+    bi->sign    = header[5] == 1;
+    bgi_mapping_release(mapping);
+    return bi;
+#else
+    (void)path;
+    return bgi_init_with_status(BGI_MAP_FAIL);
+#endif
+}
 
-        size_t len = list_len(bi1->decimal);
-        if (list_len(bi1->decimal) > list_len(bi2->decimal)) {
-            len = list_len(bi2->decimal);
-        }
+// out of core arithmetic
+//
+// bgi_cmp, bgi_add, bgi_sub and bgi_mult for operands in bgi_save files that
+// do not fit in memory. the digits are streamed in blocks that keep the
+// buffers within about budget bytes, and the result is written as a bgi_save
+// file that bgi_map can open. an output that is one of the input files gives
+// BGI_FILE_FAIL and leaves the file untouched
 
-        for (size_t i = 0; i < len; i++) {
-            int8 n1 = list_get(bi1->decimal, i);
-            int8 n2 = list_get(bi2->decimal, i);
-            if (n1 > n2) {
-                return 1;
-            }
-            if (n1 < n2) {
-                return -1;
-            }
-        }
+#define BGI_OOC_MIN_BLOCK 64
 
-        if (list_len(bi1->decimal) > list_len(bi2->decimal)) {
-            return 1;
+#ifdef BGI_POSIX_FILES
+typedef struct {
+    int fd;
+    bool sign;
+    uint64_t numeric_len;
+    uint64_t decimal_len;
+    uint64_t shift; // zero digits below the fraction that align it with the other operand
+    dev_t dev;
+    ino_t ino;
+} BgiOocFile;
+
+static bool bgi_ooc_pread(int fd, void *buf, size_t len, uint64_t offset) {
+    unsigned char *p = (unsigned char*)buf;
+    while (len > 0) {
+        ssize_t n = pread(fd, p, len, (off_t)offset);
+        if (n <= 0) {
+            return false;
         }
+        p += n;
+        len -= (size_t)n;
+        offset += (uint64_t)n;
+    }
+    return true;
+}
 
-        if (list_len(bi1->decimal) < list_len(bi2->decimal)) {
-            return -1;
+static bool bgi_ooc_pwrite(int fd, const void *buf, size_t len, uint64_t offset) {
+    const unsigned char *p = (const unsigned char*)buf;
+    while (len > 0) {
+        ssize_t n = pwrite(fd, p, len, (off_t)offset);
+        if (n <= 0) {
+            return false;
         }
-
-        return 0;
+        p += n;
+        len -= (size_t)n;
+        offset += (uint64_t)n;
     }
+    return true;
+}
 
-    if (list_len(bi1->numeric) > list_len(bi2->numeric)) {
-        return -1;
+static bool bgi_ooc_open(BgiOocFile *f, const char *path) {
+    f->fd = path != NULL ? open(path, O_RDONLY) : -1;
+    if (f->fd < 0) {
+        return false;
     }
 
-    if (list_len(bi1->numeric) < list_len(bi2->numeric)) {
-        return 1;
+    unsigned char header[BGI_MAP_HEADER];
+    struct stat st;
+    if (fstat(f->fd, &st) != 0 || st.st_size < BGI_MAP_HEADER || !bgi_ooc_pread(f->fd, header, BGI_MAP_HEADER, 0)) {
+        close(f->fd);
+        return false;
     }
 
-    for (size_t i = 0; i < list_len(bi1->numeric); i++) {
-        int8 n1 = list_get(bi1->numeric, i);
-        int8 n2 = list_get(bi2->numeric, i);
-        if (n1 > n2) {
-            return -1;
-        }
-        if (n1 < n2) {
-            return 1;
-        }
+    f->sign        = header[5] == 1;
+    f->numeric_len = bgi_map_get_u64(header + 8);
+    f->decimal_len = bgi_map_get_u64(header + 16);
+    f->shift       = 0;
+    f->dev         = st.st_dev;
+    f->ino         = st.st_ino;
+    uint64_t size  = (uint64_t)st.st_size - BGI_MAP_HEADER;
+    if (memcmp(header, BGI_MAP_MAGIC, 4) != 0 || header[4] != BGI_MAP_VERSION || header[5] > 1
+        || f->numeric_len > size || f->decimal_len != size - f->numeric_len) {
+        close(f->fd);
+        return false;
     }
+    return true;
+}
 
-    size_t len = list_len(bi1->decimal);
-    if (list_len(bi1->decimal) > list_len(bi2->decimal)) {
-        len = list_len(bi2->decimal);
-    }
+// one past the most significant stored digit
+static uint64_t bgi_ooc_top(const BgiOocFile *f) {
+    return f->shift + f->decimal_len + f->numeric_len;
+}
 
-    for (size_t i = 0; i < len; i++) {
-        int8 n1 = list_get(bi1->decimal, i);
-        int8 n2 = list_get(bi2->decimal, i);
-        if (n1 > n2) {
-            return -1;
+// len digits from index start, least significant first. index 0 is the
+// lowest aligned fraction digit, outside of the stored digits the value is zero
+static bool bgi_ooc_read(const BgiOocFile *f, uint64_t start, size_t len, int8 *out) {
+    memset(out, 0, len);
+    uint64_t end = start + len;
+
+    // the fraction is stored most significant first, so its run is reversed
+    uint64_t low  = start > f->shift ? start : f->shift;
+    uint64_t high = end < f->shift + f->decimal_len ? end : f->shift + f->decimal_len;
+    if (low < high) {
+        int8 *dst = out + (low - start);
+        size_t n  = (size_t)(high - low);
+        uint64_t first = f->decimal_len - (high - f->shift);
+        if (!bgi_ooc_pread(f->fd, dst, n, BGI_MAP_HEADER + f->numeric_len + first)) {
+            return false;
         }
-        if (n1 < n2) {
-            return 1;
+        for (size_t i = 0; i < n / 2; i++) {
+            int8 digit = dst[i];
+            dst[i] = dst[n-1-i];
+            dst[n-1-i] = digit;
         }
     }
 
-    if (list_len(bi1->decimal) > list_len(bi2->decimal)) {
-        return -1;
+    low  = start > f->shift + f->decimal_len ? start : f->shift + f->decimal_len;
+    high = end < bgi_ooc_top(f) ? end : bgi_ooc_top(f);
+    if (low < high) {
+        if (!bgi_ooc_pread(f->fd, out + (low - start), (size_t)(high - low), BGI_MAP_HEADER + (low - f->shift - f->decimal_len))) {
+            return false;
+        }
     }
+    return true;
+}
 
-    if (list_len(bi1->decimal) < list_len(bi2->decimal)) {
-        return 1;
+// result digits arrive least significant first. integer digits go to their
+// place in the file, fraction digits to a temporary file that is copied
+// behind them in reverse once the integer length is known
+typedef struct {
+    int fd;
+    FILE *fraction;
+    uint64_t scale;
+    uint64_t len;
+    uint64_t numeric_len;    // up to the highest non zero integer digit
+    uint64_t fraction_zeros; // zero fraction digits below the lowest non zero one
+    bool fraction_nonzero;
+} BgiOocWriter;
+
+// the file is only truncated once it is known not to be x or y
+static bool bgi_ooc_writer_open(BgiOocWriter *w, const char *path, uint64_t scale, const BgiOocFile *x, const BgiOocFile *y) {
+    memset(w, 0, sizeof(BgiOocWriter));
+    w->scale = scale;
+    w->fd = path != NULL ? open(path, O_RDWR | O_CREAT, 0644) : -1;
+    if (w->fd < 0) {
+        return false;
     }
-
-    return 0;
+    struct stat st;
+    if (fstat(w->fd, &st) != 0 || (st.st_dev == x->dev && st.st_ino == x->ino)
+        || (st.st_dev == y->dev && st.st_ino == y->ino) || ftruncate(w->fd, 0) != 0) {
+        close(w->fd);
+        return false;
+    }
+    w->fraction = tmpfile();
+    if (w->fraction == NULL) {
+        close(w->fd);
+        return false;
+    }
+    return true;
 }
 
-int bgi_abs_cmp(BigInt *bi1, BigInt *bi2) {
-    if (list_len(bi1->numeric) > list_len(bi2->numeric)) {
-        return 1;
+static bool bgi_ooc_write(BgiOocWriter *w, const int8 *digits, size_t n) {
+    size_t i = 0;
+    for (; i < n && w->len + i < w->scale; i++) {
+        if (!w->fraction_nonzero && digits[i] == 0) {
+            w->fraction_zeros++;
+        } else {
+            w->fraction_nonzero = true;
+        }
     }
-
-    if (list_len(bi1->numeric) < list_len(bi2->numeric)) {
-        return -1;
+    if (i > 0 && fwrite(digits, 1, i, w->fraction) != i) {
+        return false;
     }
 
-    for (size_t i = 0; i < list_len(bi1->numeric); i++) {
-        int8 n1 = list_get(bi1->numeric, i);
-        int8 n2 = list_get(bi2->numeric, i);
-        if (n1 > n2) {
-            return 1;
+    if (i < n) {
+        uint64_t index = w->len + i - w->scale;
+        if (!bgi_ooc_pwrite(w->fd, digits + i, n - i, BGI_MAP_HEADER + index)) {
+            return false;
         }
-        if (n1 < n2) {
-            return -1;
+        for (size_t j = n; j-- > i;) {
+            if (digits[j] != 0) {
+                w->numeric_len = index + (j - i) + 1;
+                break;
+            }
         }
     }
 
-    size_t len = list_len(bi1->decimal);
-    if (list_len(bi1->decimal) > list_len(bi2->decimal)) {
-        len = list_len(bi2->decimal);
-    }
+    w->len += n;
+    return true;
+}
 
-    for (size_t i = 0; i < len; i++) {
-        int8 n1 = list_get(bi1->decimal, i);
-        int8 n2 = list_get(bi2->decimal, i);
-        if (n1 > n2) {
-            return 1;
-        }
-        if (n1 < n2) {
-            return -1;
+// buf is a block of block digits used for the fraction copy
+static bool bgi_ooc_writer_close(BgiOocWriter *w, bool sign, int8 *buf, size_t block, bool ok) {
+    uint64_t decimal_len = w->fraction_nonzero ? w->scale - w->fraction_zeros : 0;
+    if (w->len < w->scale) {
+        ok = false;
+    }
+    ok = ok && fflush(w->fraction) == 0;
+
+    // the fraction file holds the digits least significant first
+    int fraction_fd = fileno(w->fraction);
+    for (uint64_t high = w->scale; ok && high > w->fraction_zeros;) {
+        uint64_t low = high - w->fraction_zeros > block ? high - block : w->fraction_zeros;
+        size_t n = (size_t)(high - low);
+        ok = bgi_ooc_pread(fraction_fd, buf, n, low);
+        for (size_t i = 0; ok && i < n / 2; i++) {
+            int8 digit = buf[i];
+            buf[i] = buf[n-1-i];
+            buf[n-1-i] = digit;
         }
+        ok = ok && bgi_ooc_pwrite(w->fd, buf, n, BGI_MAP_HEADER + w->numeric_len + (w->scale - high));
+        high = low;
     }
 
-    if (list_len(bi1->decimal) > list_len(bi2->decimal)) {
-        return 1;
-    }
+    unsigned char header[BGI_MAP_HEADER] = {0};
+    memcpy(header, BGI_MAP_MAGIC, 4);
+    header[4] = BGI_MAP_VERSION;
+    header[5] = (sign || (w->numeric_len == 0 && decimal_len == 0)) ? 1 : 0;
+    bgi_map_put_u64(header + 8, w->numeric_len);
+    bgi_map_put_u64(header + 16, decimal_len);
+    ok = ok && bgi_ooc_pwrite(w->fd, header, BGI_MAP_HEADER, 0);
+    ok = ok && ftruncate(w->fd, (off_t)(BGI_MAP_HEADER + w->numeric_len + decimal_len)) == 0;
+
+    fclose(w->fraction);
+    return close(w->fd) == 0 && ok;
+}
 
-    if (list_len(bi1->decimal) < list_len(bi2->decimal)) {
-        return -1;
-    }
+// digits per block when count buffers share the budget
+static size_t bgi_ooc_block(size_t budget, size_t count) {
+    size_t block = budget / count;
+    return block > BGI_OOC_MIN_BLOCK ? block : BGI_OOC_MIN_BLOCK;
+}
 
-    return 0;
+static void bgi_ooc_align(BgiOocFile *x, BgiOocFile *y) {
+    x->shift = x->decimal_len < y->decimal_len ? y->decimal_len - x->decimal_len : 0;
+    y->shift = y->decimal_len < x->decimal_len ? x->decimal_len - y->decimal_len : 0;
 }
 
-BigInt *bgi_add(BigInt *bi1, BigInt *bi2) {
-    bgi_assert(bi1 != NULL, "bi1 cannot be NULL");
-    bgi_assert(bi1->numeric != NULL, "bi1->numeric cannot be NULL");
-    bgi_assert(bi1->decimal != NULL, "bi1->decimal cannot be NULL");
+// compares |x| and |y| from the most significant block down, aligned operands
+static BigIntStatusCode bgi_ooc_abs_cmp(const BgiOocFile *x, const BgiOocFile *y, size_t block, int8 *a, int8 *b, int *result) {
+    uint64_t top = bgi_ooc_top(x) > bgi_ooc_top(y) ? bgi_ooc_top(x) : bgi_ooc_top(y);
+    *result = 0;
+    for (uint64_t high = top; high > 0;) {
+        uint64_t low = high > block ? high - block : 0;
+        size_t n = (size_t)(high - low);
+        if (!bgi_ooc_read(x, low, n, a) || !bgi_ooc_read(y, low, n, b)) {
+            return BGI_FILE_FAIL;
+        }
+        for (size_t i = n; i-- > 0;) {
+            if (a[i] != b[i]) {
+                *result = a[i] > b[i] ? 1 : -1;
+                return BGI_OK;
+            }
+        }
+        high = low;
+    }
+    return BGI_OK;
+}
 
-    if (bi1 == NULL || bi1->numeric == NULL || bi1->decimal == NULL) {
-        return NULL;
+// |x| + |y| or |x| - |y| with |x| >= |y|, from the least significant block up
+static BigIntStatusCode bgi_ooc_add_abs(const BgiOocFile *x, const BgiOocFile *y, bool subtract, bool sign, const char *out, size_t block, int8 *a, int8 *b) {
+    BgiOocWriter w;
+    if (!bgi_ooc_writer_open(&w, out, x->shift + x->decimal_len, x, y)) {
+        return BGI_FILE_FAIL;
     }
 
-    if (bi1->status_code != BGI_OK || bi1->status_code != LIST_OK || bi1->status_code != LIST_OK) {
-        return NULL;
+    uint64_t top = bgi_ooc_top(x) > bgi_ooc_top(y) ? bgi_ooc_top(x) : bgi_ooc_top(y);
+    int carrier = 0;
+    bool ok = true;
+    for (uint64_t low = 0; ok && low < top; low += block) {
+        size_t n = top - low < block ? (size_t)(top - low) : block;
+        ok = bgi_ooc_read(x, low, n, a) && bgi_ooc_read(y, low, n, b);
+        for (size_t i = 0; ok && i < n; i++) {
+            int value = subtract ? a[i] - b[i] - carrier : a[i] + b[i] + carrier;
+            carrier = subtract ? value < 0 : value >= 10;
+            a[i] = (int8)(subtract ? (value < 0 ? value + 10 : value) : value % 10);
+        }
+        ok = ok && bgi_ooc_write(&w, a, n);
+    }
+    if (ok && carrier != 0) {
+        int8 digit = 1;
+        ok = bgi_ooc_write(&w, &digit, 1);
     }
 
-    bgi_assert(bi2 != NULL, "bi2 cannot be NULL");
-    bgi_assert(bi2->numeric != NULL, "bi2->numeric cannot be NULL");
-    bgi_assert(bi2->decimal != NULL, "bi2->decimal cannot be NULL");
+    return bgi_ooc_writer_close(&w, sign, a, block, ok) ? BGI_OK : BGI_FILE_FAIL;
+}
 
-    if (bi2 == NULL || bi2->numeric == NULL || bi2->decimal == NULL) {
-        return NULL;
+static BigIntStatusCode bgi_ooc_add_signed(const char *path1, const char *path2, const char *out, size_t budget, bool negate) {
+    BgiOocFile x, y;
+    if (!bgi_ooc_open(&x, path1)) {
+        return BGI_FILE_FAIL;
     }
-
-    if (bi2->status_code != BGI_OK || bi2->status_code != LIST_OK || bi2->status_code != LIST_OK) {
-        return NULL;
+    if (!bgi_ooc_open(&y, path2)) {
+        close(x.fd);
+        return BGI_FILE_FAIL;
     }
-
-    if (bi1->sign != bi2->sign) {
-        if (bi1->sign) {
-            bi2->sign = true;
-            BigInt *result = bgi_sub(bi1, bi2);
-            bi2->sign = false;
-            return result;
+    bgi_ooc_align(&x, &y);
+    bool sign2 = negate ? !y.sign : y.sign;
+
+    size_t block = bgi_ooc_block(budget, 2);
+    int8 *a = (int8*)malloc(block);
+    int8 *b = (int8*)malloc(block);
+    BigIntStatusCode status = (a == NULL || b == NULL) ? BGI_ALLOC_FAIL : BGI_OK;
+
+    if (status == BGI_OK && x.sign == sign2) {
+        status = bgi_ooc_add_abs(&x, &y, false, x.sign, out, block, a, b);
+    } else if (status == BGI_OK) {
+        int cmp = 0;
+        status = bgi_ooc_abs_cmp(&x, &y, block, a, b, &cmp);
+        if (status == BGI_OK) {
+            status = cmp >= 0
+                ? bgi_ooc_add_abs(&x, &y, true, x.sign, out, block, a, b)
+                : bgi_ooc_add_abs(&y, &x, true, sign2, out, block, a, b);
         }
-        bi1->sign = true;
-        BigInt *result = bgi_sub(bi2, bi1);
-        bi1->sign = false;
-        return result;
     }
 
-    int8 carrier = 0;
-    BigInt *bi1_copy = bgi_clone(bi1);
+    free(a);
+    free(b);
+    close(x.fd);
+    close(y.fd);
+    return status;
+}
 
-    if (bi1_copy == NULL) {
-        return NULL;
+// disk backed ntt
+//
+// the product is the cyclic convolution of base 10^4 limbs modulo the prime
+// p = 2^64 - 2^32 + 1, which has roots of unity of every power of two order up
+// to 2^32. a coefficient stays below 2^32 * 9999^2 < p, so it is exact. the n
+// limbs of a transform live in a scratch file as a rows x cols matrix, index
+// j1 + cols*j2 in row j2, and the four step algorithm runs on it: transforms
+// of the columns, a twiddle multiplication and transforms of the rows. a pass
+// only holds a panel of whole columns or a block of whole rows, so the memory
+// is the budget or one row or column, whichever is larger. the spectrum is
+// left transposed, the pointwise product does not mind and the inverse passes
+// run in the opposite order
+
+#define BGI_NTT_P     0xffffffff00000001ull
+#define BGI_NTT_EPS   0xffffffffull // 2^64 mod p
+#define BGI_NTT_ROOT  7             // generator of the multiplicative group
+#define BGI_NTT_LIMB  4
+#define BGI_NTT_BASE  10000
+#define BGI_NTT_MAX_N (1ull << 32)
+
+static inline uint64_t bgi_ntt_add(uint64_t a, uint64_t b) {
+    uint64_t sum = a + b;
+    // a wrapped sum is 2^64 too small, and 2^64 - p is BGI_NTT_EPS
+    if (sum < a) {
+        return sum + BGI_NTT_EPS;
+    }
+    return sum >= BGI_NTT_P ? sum - BGI_NTT_P : sum;
+}
+
+static inline uint64_t bgi_ntt_sub(uint64_t a, uint64_t b) {
+    return a >= b ? a - b : a - b + BGI_NTT_P;
+}
+
+static inline uint64_t bgi_ntt_mul(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 x = (unsigned __int128)a * b;
+    uint64_t lo = (uint64_t)x;
+    uint64_t hi = (uint64_t)(x >> 64);
+#else
+    uint64_t a0 = a & 0xffffffffu, a1 = a >> 32;
+    uint64_t b0 = b & 0xffffffffu, b1 = b >> 32;
+    uint64_t p00 = a0*b0, p01 = a0*b1, p10 = a1*b0, p11 = a1*b1;
+    uint64_t mid = (p00 >> 32) + (p01 & 0xffffffffu) + (p10 & 0xffffffffu);
+    uint64_t lo  = (p00 & 0xffffffffu) | (mid << 32);
+    uint64_t hi  = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+#endif
+    // 2^64 = 2^32 - 1 and 2^96 = -1 modulo p
+    uint64_t hi_hi = hi >> 32;
+    uint64_t hi_lo = hi & BGI_NTT_EPS;
+    uint64_t t = lo - hi_hi;
+    if (lo < hi_hi) {
+        t -= BGI_NTT_EPS;
     }
+    uint64_t r = t + hi_lo * BGI_NTT_EPS;
+    if (r < t) {
+        r += BGI_NTT_EPS;
+    }
+    return r >= BGI_NTT_P ? r - BGI_NTT_P : r;
+}
 
-    if (bi1_copy->status_code != BGI_OK) {
-        return bi1_copy;
+static uint64_t bgi_ntt_pow(uint64_t a, uint64_t e) {
+    uint64_t r = 1;
+    for (; e > 0; e >>= 1) {
+        if (e & 1) {
+            r = bgi_ntt_mul(r, a);
+        }
+        a = bgi_ntt_mul(a, a);
     }
+    return r;
+}
 
-    BigInt *bi2_copy = bgi_clone(bi2);
+// primitive root of unity of order n, a power of two up to BGI_NTT_MAX_N
+static uint64_t bgi_ntt_root(uint64_t n, bool inverse) {
+    uint64_t root = bgi_ntt_pow(BGI_NTT_ROOT, (BGI_NTT_P - 1) / n);
+    return inverse ? bgi_ntt_pow(root, BGI_NTT_P - 2) : root;
+}
 
-    if (bi2_copy == NULL) {
-        bgi_free(bi1_copy);
-        return NULL;
+// in place transform of a[0], a[stride], ..., a[(n-1)*stride] in natural order
+static void bgi_ntt(uint64_t *a, size_t n, size_t stride, uint64_t root) {
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            uint64_t t = a[i*stride];
+            a[i*stride] = a[j*stride];
+            a[j*stride] = t;
+        }
     }
 
-    if (bi2_copy->status_code != BGI_OK) {
-        bgi_free(bi1_copy);
-        return bi2_copy;
+    for (size_t len = 2; len <= n; len <<= 1) {
+        uint64_t step = bgi_ntt_pow(root, n / len);
+        for (size_t i = 0; i < n; i += len) {
+            uint64_t w = 1;
+            for (size_t j = 0; j < len / 2; j++) {
+                uint64_t *u = &a[(i + j)*stride];
+                uint64_t *v = &a[(i + j + len/2)*stride];
+                uint64_t t = bgi_ntt_mul(*v, w);
+                *v = bgi_ntt_sub(*u, t);
+                *u = bgi_ntt_add(*u, t);
+                w = bgi_ntt_mul(w, step);
+            }
+        }
     }
+}
 
-    // do addition in decimal part
-    if (list_len(bi2_copy->decimal) > list_len(bi1_copy->decimal)) {
-        size_t diff = list_len(bi2_copy->decimal) - list_len(bi1_copy->decimal);
-        for (size_t i = 0; i < diff; i++) {
-            list_append(bi1_copy->decimal, 0);
-            if (bi1_copy->decimal->status_code != LIST_OK) {
-                bi1_copy->status_code = BGI_DECIMAL_FAIL;
-                bgi_free(bi2_copy);
-                return bi1_copy;
+typedef struct {
+    int fd;
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t *buf;
+    size_t elems; // length of buf, at least one row and one column
+} BgiNttFile;
+
+// transforms every column of length rows, width columns per panel
+static bool bgi_ntt_columns(const BgiNttFile *f, bool inverse) {
+    uint64_t root  = bgi_ntt_root(f->rows, inverse);
+    size_t   width = f->elems / f->rows;
+    for (uint64_t c0 = 0; c0 < f->cols; c0 += width) {
+        size_t n = f->cols - c0 < width ? (size_t)(f->cols - c0) : width;
+        for (uint64_t r = 0; r < f->rows; r++) {
+            if (!bgi_ooc_pread(f->fd, f->buf + r*n, n * sizeof(uint64_t), (r*f->cols + c0) * sizeof(uint64_t))) {
+                return false;
             }
         }
-    } else {
-        size_t diff = list_len(bi1_copy->decimal) - list_len(bi2_copy->decimal);
-        for (size_t i = 0; i < diff; i++) {
-            list_append(bi2_copy->decimal, 0);
-            if (bi2_copy->decimal->status_code != LIST_OK) {
-                bi2_copy->status_code = BGI_NUMERIC_FAIL;
-                bgi_free(bi1_copy);
-                return bi2_copy;
+        for (size_t c = 0; c < n; c++) {
+            bgi_ntt(f->buf + c, (size_t)f->rows, n, root);
+        }
+        for (uint64_t r = 0; r < f->rows; r++) {
+            if (!bgi_ooc_pwrite(f->fd, f->buf + r*n, n * sizeof(uint64_t), (r*f->cols + c0) * sizeof(uint64_t))) {
+                return false;
             }
         }
     }
+    return true;
+}
 
-    for (int i = list_len(bi1_copy->decimal)-1; i >= 0; i--) {
-        int8 n1 = list_get(bi1_copy->decimal, i);
-        int8 n2 = list_get(bi2_copy->decimal, i);
-
-        if (bi1_copy->decimal->status_code != LIST_OK) {
-            bi1_copy->status_code = BGI_DECIMAL_FAIL;
-            bgi_free(bi2_copy);
-            return bi1_copy;
+// transforms every row of length cols, element j1 of row k2 is twiddled by
+// w^(j1*k2) with w of order rows*cols, before the forward transform and after
+// the inverse one
+static bool bgi_ntt_rows(const BgiNttFile *f, bool inverse) {
+    uint64_t root   = bgi_ntt_root(f->cols, inverse);
+    uint64_t w      = bgi_ntt_root(f->rows * f->cols, inverse);
+    size_t   height = f->elems / f->cols;
+    uint64_t row_w  = 1; // w^k2
+    for (uint64_t r0 = 0; r0 < f->rows; r0 += height) {
+        size_t n = f->rows - r0 < height ? (size_t)(f->rows - r0) : height;
+        size_t size = n * (size_t)f->cols * sizeof(uint64_t);
+        if (!bgi_ooc_pread(f->fd, f->buf, size, r0*f->cols * sizeof(uint64_t))) {
+            return false;
         }
-
-        if (bi2_copy->decimal->status_code != LIST_OK) {
-            bi2_copy->status_code = BGI_DECIMAL_FAIL;
-            bgi_free(bi1_copy);
-            return bi2_copy;
+        for (size_t r = 0; r < n; r++, row_w = bgi_ntt_mul(row_w, w)) {
+            uint64_t *row = f->buf + r*f->cols;
+            if (inverse) {
+                bgi_ntt(row, (size_t)f->cols, 1, root);
+            }
+            uint64_t t = 1;
+            for (size_t c = 0; c < f->cols; c++, t = bgi_ntt_mul(t, row_w)) {
+                row[c] = bgi_ntt_mul(row[c], t);
+            }
+            if (!inverse) {
+                bgi_ntt(row, (size_t)f->cols, 1, root);
+            }
         }
-
-        list_set(bi1_copy->decimal, i, (n1 + n2 + carrier) % 10);
-        if (bi1_copy->decimal->status_code != LIST_OK) {
-            bi1_copy->status_code = BGI_DECIMAL_FAIL;
-            bgi_free(bi2_copy);
-            return bi1_copy;
+        if (!bgi_ooc_pwrite(f->fd, f->buf, size, r0*f->cols * sizeof(uint64_t))) {
+            return false;
         }
-
-        carrier = (n1 + n2) / 10;
     }
+    return true;
+}
 
-    list_reverse(bi1_copy->numeric);
-    if (bi1_copy->numeric->status_code != LIST_OK) {
-        bi1_copy->status_code = BGI_NUMERIC_FAIL;
-        bgi_free(bi2_copy);
-        return bi1_copy;
-    }
+static bool bgi_ntt_forward(const BgiNttFile *f) {
+    return bgi_ntt_columns(f, false) && bgi_ntt_rows(f, false);
+}
 
-    list_reverse(bi2_copy->numeric);
-    if (bi2_copy->numeric->status_code != LIST_OK) {
-        bi2_copy->status_code = BGI_NUMERIC_FAIL;
-        bgi_free(bi1_copy);
-        return bi2_copy;
-    }
+// leaves the coefficients multiplied by rows*cols
+static bool bgi_ntt_inverse(const BgiNttFile *f) {
+    return bgi_ntt_rows(f, true) && bgi_ntt_columns(f, true);
+}
 
-    // do addition in numeric part
-    if (list_len(bi1_copy->numeric) < list_len(bi2_copy->numeric)) {
-        size_t diff = list_len(bi2_copy->numeric) - list_len(bi1_copy->numeric);
-        for (size_t i = 0; i < diff; i++) {
-            list_append(bi1_copy->numeric, 0);
-            if (bi1_copy->numeric->status_code != LIST_OK) {
-                bi1_copy->status_code = BGI_NUMERIC_FAIL;
-                bgi_free(bi2_copy);
-                return bi1_copy;
-            }
+// writes the limbs of the digits of x to f, zero up to rows*cols. the digits
+// are read into the upper half of the buffer, behind the limbs made from them
+static bool bgi_ntt_load(const BgiNttFile *f, const BgiOocFile *x) {
+    size_t   block = f->elems / 2;
+    int8    *digits = (int8*)(f->buf + block);
+    uint64_t n_len = f->rows * f->cols;
+    for (uint64_t l0 = 0; l0 < n_len; l0 += block) {
+        size_t n = n_len - l0 < block ? (size_t)(n_len - l0) : block;
+        if (!bgi_ooc_read(x, l0 * BGI_NTT_LIMB, n * BGI_NTT_LIMB, digits)) {
+            return false;
         }
-    } else {
-        size_t diff = list_len(bi1_copy->numeric) - list_len(bi2_copy->numeric);
-        for (size_t i = 0; i < diff; i++) {
-            list_append(bi2_copy->numeric, 0);
-            if (bi2_copy->numeric->status_code != LIST_OK) {
-                bi2_copy->status_code = BGI_NUMERIC_FAIL;
-                bgi_free(bi1_copy);
-                return bi2_copy;
-            }
+        for (size_t i = 0; i < n; i++) {
+            const int8 *d = digits + i*BGI_NTT_LIMB;
+            f->buf[i] = (uint64_t)d[0] + 10u*(uint64_t)d[1] + 100u*(uint64_t)d[2] + 1000u*(uint64_t)d[3];
+        }
+        if (!bgi_ooc_pwrite(f->fd, f->buf, n * sizeof(uint64_t), l0 * sizeof(uint64_t))) {
+            return false;
         }
     }
+    return true;
+}
 
-    for (int i = 0; i < list_len(bi1_copy->numeric); i++) {
-        int8 n1 = list_get(bi1_copy->numeric, i);
-        int8 n2 = list_get(bi2_copy->numeric, i);
-        if (bi1_copy->numeric->status_code != LIST_OK) {
-            bi1_copy->status_code = BGI_NUMERIC_FAIL;
-            bgi_free(bi2_copy);
-            return bi1_copy;
+// f = f * g / (rows*cols) elementwise, the division undoes the inverse transform
+static bool bgi_ntt_pointwise(const BgiNttFile *f, const BgiNttFile *g) {
+    size_t   block = f->elems / 2;
+    uint64_t n_len = f->rows * f->cols;
+    uint64_t scale = bgi_ntt_pow(n_len % BGI_NTT_P, BGI_NTT_P - 2);
+    for (uint64_t i0 = 0; i0 < n_len; i0 += block) {
+        size_t n = n_len - i0 < block ? (size_t)(n_len - i0) : block;
+        uint64_t *a = f->buf;
+        uint64_t *b = f->buf + block;
+        if (!bgi_ooc_pread(f->fd, a, n * sizeof(uint64_t), i0 * sizeof(uint64_t))
+            || !bgi_ooc_pread(g->fd, b, n * sizeof(uint64_t), i0 * sizeof(uint64_t))) {
+            return false;
         }
-        if (bi2_copy->numeric->status_code != LIST_OK) {
-            bi2_copy->status_code = BGI_NUMERIC_FAIL;
-            bgi_free(bi1_copy);
-            return bi2_copy;
+        for (size_t i = 0; i < n; i++) {
+            a[i] = bgi_ntt_mul(bgi_ntt_mul(a[i], b[i]), scale);
         }
-
-        list_set(bi1_copy->numeric, i, (n1 + n2 + carrier) % 10);
-        if (bi1_copy->numeric->status_code != LIST_OK) {
-            bi1_copy->status_code = BGI_NUMERIC_FAIL;
-            bgi_free(bi2_copy);
-            return bi1_copy;
+        if (!bgi_ooc_pwrite(f->fd, a, n * sizeof(uint64_t), i0 * sizeof(uint64_t))) {
+            return false;
         }
-        carrier = (n1 + n2 + carrier) / 10;
     }
+    return true;
+}
 
-    if (carrier > 0) {
-        list_append(bi1_copy->numeric, carrier);
-        if (bi1_copy->numeric->status_code != LIST_OK) {
-            bi1_copy->status_code = BGI_NUMERIC_FAIL;
-            bgi_free(bi2_copy);
-            return bi1_copy;
+// carries the first len coefficients of f into base 10 digits for w, the
+// digits are made in the upper half of the buffer like in bgi_ntt_load
+static bool bgi_ntt_store(const BgiNttFile *f, uint64_t len, BgiOocWriter *w) {
+    size_t   block  = f->elems / 2;
+    int8    *digits = (int8*)(f->buf + block);
+    uint64_t carry  = 0;
+    for (uint64_t i0 = 0; i0 < len; i0 += block) {
+        size_t n = len - i0 < block ? (size_t)(len - i0) : block;
+        if (!bgi_ooc_pread(f->fd, f->buf, n * sizeof(uint64_t), i0 * sizeof(uint64_t))) {
+            return false;
+        }
+        for (size_t i = 0; i < n; i++) {
+            uint64_t value = f->buf[i] + carry;
+            carry = value / BGI_NTT_BASE;
+            value %= BGI_NTT_BASE;
+            for (size_t k = 0; k < BGI_NTT_LIMB; k++, value /= 10) {
+                digits[i*BGI_NTT_LIMB + k] = (int8)(value % 10);
+            }
+        }
+        if (!bgi_ooc_write(w, digits, n * BGI_NTT_LIMB)) {
+            return false;
+        }
+    }
+    for (; carry != 0; carry /= 10) {
+        int8 digit = (int8)(carry % 10);
+        if (!bgi_ooc_write(w, &digit, 1)) {
+            return false;
         }
     }
+    return true;
+}
 
-    list_reverse(bi1_copy->numeric);
-    if (bi1_copy->numeric->status_code != LIST_OK) {
-        bi1_copy->status_code = BGI_NUMERIC_FAIL;
-        bgi_free(bi2_copy);
-        return bi1_copy;
+// |x| * |y| through the scratch files a and b, BGI_OUT_OF_RANGE when the
+// product needs a transform longer than BGI_NTT_MAX_N limbs
+static BigIntStatusCode bgi_ntt_mult(const BgiOocFile *x, const BgiOocFile *y, size_t budget, BgiOocWriter *w) {
+    uint64_t lx = (bgi_ooc_top(x) + BGI_NTT_LIMB - 1) / BGI_NTT_LIMB;
+    uint64_t ly = (bgi_ooc_top(y) + BGI_NTT_LIMB - 1) / BGI_NTT_LIMB;
+    if (lx == 0 || ly == 0) {
+        return BGI_OK;
+    }
+    if (lx + ly - 1 > BGI_NTT_MAX_N) {
+        return BGI_OUT_OF_RANGE;
     }
 
-    bgi_free(bi2_copy);
-    return bi1_copy;
-}
+    unsigned bits = 0;
+    while ((1ull << bits) < lx + ly - 1) {
+        bits++;
+    }
+    uint64_t cols = 1ull << ((bits + 1) / 2);
+    uint64_t rows = 1ull << (bits / 2);
 
-BigInt *bgi_sub(BigInt *bi1, BigInt *bi2) {
-    bgi_assert(bi1 != NULL, "bi1 cannot be NULL");
-    bgi_assert(bi1->numeric != NULL, "bi1->numeric cannot be NULL");
-    bgi_assert(bi1->decimal != NULL, "bi1->decimal cannot be NULL");
+    size_t elems = budget / sizeof(uint64_t);
+    if (elems < cols) {
+        elems = (size_t)cols;
+    }
+    if (elems < BGI_OOC_MIN_BLOCK) {
+        elems = BGI_OOC_MIN_BLOCK;
+    }
 
-    if (bi1 == NULL || bi1->numeric == NULL || bi1->decimal == NULL) {
-        return NULL;
+    FILE *file_a = tmpfile();
+    FILE *file_b = tmpfile();
+    uint64_t *buf = (uint64_t*)malloc(elems * sizeof(uint64_t));
+    BigIntStatusCode status = BGI_OK;
+    if (buf == NULL) {
+        status = BGI_ALLOC_FAIL;
+    } else if (file_a == NULL || file_b == NULL) {
+        status = BGI_FILE_FAIL;
+    } else {
+        BgiNttFile a = {fileno(file_a), rows, cols, buf, elems};
+        BgiNttFile b = {fileno(file_b), rows, cols, buf, elems};
+        bool ok = bgi_ntt_load(&a, x) && bgi_ntt_forward(&a)
+            && bgi_ntt_load(&b, y) && bgi_ntt_forward(&b)
+            && bgi_ntt_pointwise(&a, &b) && bgi_ntt_inverse(&a)
+            && bgi_ntt_store(&a, lx + ly - 1, w);
+        status = ok ? BGI_OK : BGI_FILE_FAIL;
     }
 
-    if (bi1->status_code != BGI_OK || bi1->status_code != LIST_OK || bi1->status_code != LIST_OK) {
-        return NULL;
+    if (file_a != NULL) {
+        fclose(file_a);
+    }
+    if (file_b != NULL) {
+        fclose(file_b);
     }
+    free(buf);
+    return status;
+}
+#endif
 
-    bgi_assert(bi2 != NULL, "bi2 cannot be NULL");
-    bgi_assert(bi2->numeric != NULL, "bi2->numeric cannot be NULL");
-    bgi_assert(bi2->decimal != NULL, "bi2->decimal cannot be NULL");
+// *result is -1, 0 or 1 like bgi_cmp
+BigIntStatusCode bgi_file_cmp(const char *path1, const char *path2, size_t budget, int *result) {
+    bgi_assert(result != NULL, "result cannot be NULL");
 
-    if (bi2 == NULL || bi2->numeric == NULL || bi2->decimal == NULL) {
-        return NULL;
+#ifdef BGI_POSIX_FILES
+    if (result == NULL) {
+        return BGI_FILE_FAIL;
     }
 
-    if (bi2->status_code != BGI_OK || bi2->status_code != LIST_OK || bi2->status_code != LIST_OK) {
-        return NULL;
+    BgiOocFile x, y;
+    if (!bgi_ooc_open(&x, path1)) {
+        return BGI_FILE_FAIL;
     }
+    if (!bgi_ooc_open(&y, path2)) {
+        close(x.fd);
+        return BGI_FILE_FAIL;
+    }
+    bgi_ooc_align(&x, &y);
+
+    size_t block = bgi_ooc_block(budget, 2);
+    int8 *a = (int8*)malloc(block);
+    int8 *b = (int8*)malloc(block);
+    int cmp = 0;
+    BigIntStatusCode status = (a == NULL || b == NULL) ? BGI_ALLOC_FAIL : bgi_ooc_abs_cmp(&x, &y, block, a, b, &cmp);
+
+    if (status == BGI_OK && x.sign != y.sign) {
+        // equal magnitudes of opposite signs are only equal when both are zero
+        BgiOocFile zero = {-1, true, 0, 0, 0, 0, 0};
+        int zero_cmp = cmp;
+        if (cmp == 0) {
+            status = bgi_ooc_abs_cmp(&x, &zero, block, a, b, &zero_cmp);
+        }
+        cmp = zero_cmp == 0 ? 0 : (x.sign ? 1 : -1);
+    } else if (status == BGI_OK && !x.sign) {
+        cmp = -cmp;
+    }
+    *result = cmp;
+
+    free(a);
+    free(b);
+    close(x.fd);
+    close(y.fd);
+    return status;
+#else
+    (void)path1;
+    (void)path2;
+    (void)budget;
+    return BGI_FILE_FAIL;
+#endif
+}
 
-    BigInt *bi2_copy = bgi_clone(bi2);
+BigIntStatusCode bgi_file_add(const char *path1, const char *path2, const char *out, size_t budget) {
+#ifdef BGI_POSIX_FILES
+    return bgi_ooc_add_signed(path1, path2, out, budget, false);
+#else
+    (void)path1;
+    (void)path2;
+    (void)out;
+    (void)budget;
+    return BGI_FILE_FAIL;
+#endif
+}
 
-    if (bi2_copy == NULL) {
-        return NULL;
+BigIntStatusCode bgi_file_sub(const char *path1, const char *path2, const char *out, size_t budget) {
+#ifdef BGI_POSIX_FILES
+    return bgi_ooc_add_signed(path1, path2, out, budget, true);
+#else
+    (void)path1;
+    (void)path2;
+    (void)out;
+    (void)budget;
+    return BGI_FILE_FAIL;
+#endif
+}
+
+// the digits of both operands go through the disk backed ntt above, the
+// product is streamed to out as its coefficients are carried
+BigIntStatusCode bgi_file_mult(const char *path1, const char *path2, const char *out, size_t budget) {
+#ifdef BGI_POSIX_FILES
+    BgiOocFile x, y;
+    if (!bgi_ooc_open(&x, path1)) {
+        return BGI_FILE_FAIL;
+    }
+    if (!bgi_ooc_open(&y, path2)) {
+        close(x.fd);
+        return BGI_FILE_FAIL;
     }
 
-    if (bi2_copy->status_code != BGI_OK) {
-        return bi2_copy;
+    BgiOocWriter w;
+    if (!bgi_ooc_writer_open(&w, out, x.decimal_len + y.decimal_len, &x, &y)) {
+        close(x.fd);
+        close(y.fd);
+        return BGI_FILE_FAIL;
     }
 
-    if (bi1->sign && !bi2->sign) {
-        bi2_copy->sign = true;
-        BigInt *result = bgi_add(bi1, bi2_copy);
-        bgi_free(bi2_copy);
-        return result;
+    BigIntStatusCode status = bgi_ntt_mult(&x, &y, budget, &w);
+    // an operand of zero digits writes nothing, the fraction is still padded
+    for (int8 zero = 0; status == BGI_OK && w.len < w.scale;) {
+        status = bgi_ooc_write(&w, &zero, 1) ? BGI_OK : BGI_FILE_FAIL;
     }
 
-    BigInt *bi1_copy = bgi_clone(bi1);
+    size_t block = bgi_ooc_block(budget, 1);
+    int8 *buf = (int8*)malloc(block);
+    if (status == BGI_OK && buf == NULL) {
+        status = BGI_ALLOC_FAIL;
+    }
+    if (!bgi_ooc_writer_close(&w, x.sign == y.sign, buf, block, status == BGI_OK) && status == BGI_OK) {
+        status = BGI_FILE_FAIL;
+    }
+    free(buf);
+    close(x.fd);
+    close(y.fd);
+    return status;
+#else
+    (void)path1;
+    (void)path2;
+    (void)out;
+    (void)budget;
+    return BGI_FILE_FAIL;
+#endif
+}
 
-    if (bi1_copy == NULL) {
-        bgi_free(bi2_copy);
+// streaming parser
+//
+// accepts the text of bgi_init in chunks of any size, a chunk may end inside
+// the sign, the integer part or the fraction. the digits of every chunk are
+// converted straight into the digit lists, so the text is never buffered and
+// its length is never measured. the rules are the ones of bgi_init, the first
+// invalid character makes the parser keep BGI_INVALID_TEXT_VALUE and ignore
+// the rest of the input
+
+BgiParser *bgi_parser_new(void) {
+    BgiParser *parser = (BgiParser*)malloc(sizeof(BgiParser));
+    bgi_assert(parser != NULL, "parser allocation failed: malloc failed");
+    if (parser == NULL) {
         return NULL;
     }
 
-    if (bi1_copy->status_code != BGI_OK) {
-        bgi_free(bi2_copy);
-        return bi1_copy;
+    parser->numeric = list_init();
+    parser->decimal = list_init();
+    parser->fed = 0;
+    parser->sign = true;
+    parser->in_decimal = false;
+    parser->part_len = 0;
+    parser->decimal_non_zero = false;
+    parser->status_code = BGI_OK;
+
+    if (parser->numeric == NULL || parser->numeric->status_code != LIST_OK) {
+        parser->status_code = BGI_NUMERIC_FAIL;
+    } else if (parser->decimal == NULL || parser->decimal->status_code != LIST_OK) {
+        parser->status_code = BGI_DECIMAL_FAIL;
     }
+    return parser;
+}
 
-    if (!bi1_copy->sign && bi2_copy->sign) {
-        bi2_copy->sign = false;
-        BigInt *result = bgi_add(bi1, bi2_copy);
-        bgi_free(bi2_copy);
-        return result;
+// appends the digit characters buf[0..n) to l
+static bool bgi_parser_put(List *l, const char *buf, size_t n) {
+    if (n == 0) {
+        return true;
     }
-
-    int val = bgi_abs_cmp(bi1_copy, bi2_copy);
-    if (bi1_copy->status_code != BGI_OK) {
-        bgi_free(bi2_copy);
-        return bi1_copy;
+    if (!list_grow(l, l->index + n)) {
+        return false;
     }
-
-    if (bi2_copy->status_code != BGI_OK) {
-        bgi_free(bi1_copy);
-        return bi2_copy;
+    int8 *digits = list_data(l) + l->index;
+    for (size_t i = 0; i < n; i++) {
+        digits[i] = buf[i] - '0';
     }
+    l->index += n;
+    return true;
+}
 
-    if (val == 0) {
-        bi1_copy->sign    = true;
-        list_free(bi1_copy->numeric);
-        list_free(bi1_copy->decimal);
-
-        bi1_copy->numeric = list_init();
-        if (bi1_copy->numeric == NULL || bi1_copy->numeric->status_code != LIST_OK) {
-            bi1_copy->status_code = BGI_NUMERIC_FAIL;
-            bgi_free(bi2_copy);
-            return bi1_copy;
-        }
+// returns the status after the chunk, BGI_OK while the text is still valid
+BigIntStatusCode bgi_parser_feed(BgiParser *parser, const char *buf, size_t len) {
+    bgi_assert(parser != NULL, "parser cannot be NULL");
+    if (parser == NULL) {
+        return BGI_INVALID_TEXT_VALUE;
+    }
+    if (parser->status_code != BGI_OK || len == 0) {
+        return parser->status_code;
+    }
+    bgi_assert(buf != NULL, "buf cannot be NULL");
+    if (buf == NULL) {
+        parser->status_code = BGI_INVALID_TEXT_VALUE;
+        return parser->status_code;
+    }
 
-        bi1_copy->decimal = list_init();
-        if (bi1_copy->decimal == NULL || bi1_copy->decimal->status_code != LIST_OK) {
-            bi1_copy->status_code = BGI_DECIMAL_FAIL;
-            bgi_free(bi2_copy);
-            return bi1_copy;
+    size_t i = 0;
+    if (parser->fed == 0) {
+        if (buf[0] == '+' || buf[0] == '-') {
+            parser->sign = buf[0] == '+';
+            i++;
+        } else if (buf[0] < '0' || buf[0] > '9') {
+            parser->status_code = BGI_INVALID_TEXT_VALUE;
+            return parser->status_code;
         }
-
-        return bi1_copy;
     }
 
-    bool sign = bi1_copy->sign;
-    if (val == -1) {
-        sign = !bi2_copy->sign;
-        BigInt *temp = bi1_copy;
-        bi1_copy = bi2_copy;
-        bi2_copy = temp;
-    }
+    while (i < len) {
+        // the run of digits up to the next other character
+        size_t start = i;
+        while (i < len && buf[i] >= '0' && buf[i] <= '9') {
+            i++;
+        }
 
-    // decimal part subtraction
-    if (list_len(bi1_copy->decimal) > 0) {
-        size_t min_decimal_length = list_len(bi1_copy->decimal);
-        if (list_len(bi1_copy->decimal) < list_len(bi2_copy->decimal)) {
-            size_t diff = list_len(bi2_copy->decimal) - list_len(bi1_copy->decimal);
-            for (size_t i = 0; i < diff; i++) {
-                list_append(bi1_copy->decimal, 0);
-                if (bi1_copy->decimal->status_code != LIST_OK) {
-                    bi1_copy->status_code = BGI_DECIMAL_FAIL;
-                    bgi_free(bi2_copy);
-                    return bi1_copy;
-                }
-            }
-        } else {
-            min_decimal_length = list_len(bi2_copy->decimal);
-            size_t diff = list_len(bi1_copy->decimal) - list_len(bi2_copy->decimal);
-            for (size_t i = 0; i < diff; i++) {
-                list_append(bi2_copy->decimal, 0);
-                if (bi2_copy->decimal->status_code != LIST_OK) {
-                    bi2_copy->status_code = BGI_DECIMAL_FAIL;
-                    bgi_free(bi1_copy);
-                    return bi2_copy;
+        if (!parser->in_decimal) {
+            // leading zeros are dropped as they arrive
+            size_t first = start;
+            if (list_len(parser->numeric) == 0) {
+                while (first < i && buf[first] == '0') {
+                    first++;
                 }
             }
-        }
-
-        for (int i = min_decimal_length-1; i >= 0; i--) {
-            int8 n1 = list_get(bi1_copy->decimal, i);
-            int8 n2 = list_get(bi2_copy->decimal, i);
-
-            if (bi1_copy->decimal->status_code != LIST_OK) {
-                bi1_copy->status_code = BGI_DECIMAL_FAIL;
-                bgi_free(bi2_copy);
-                return bi1_copy;
+            if (!bgi_parser_put(parser->numeric, buf + first, i - first)) {
+                parser->status_code = BGI_NUMERIC_FAIL;
+                break;
             }
-
-            if (bi2_copy->decimal->status_code != LIST_OK) {
-                bi2_copy->status_code = BGI_DECIMAL_FAIL;
-                bgi_free(bi1_copy);
-                return bi2_copy;
+        } else {
+            for (size_t j = start; j < i && !parser->decimal_non_zero; j++) {
+                parser->decimal_non_zero = buf[j] != '0';
             }
-
-            if (n1 >= n2) {
-                list_set(bi1_copy->decimal, i, n1-n2);
-                if (bi1_copy->decimal->status_code != LIST_OK) {
-                    bi1_copy->status_code = BGI_DECIMAL_FAIL;
-                    bgi_free(bi1_copy);
-                    return bi1_copy;
-                }
-            } else {
-                int carrier_index = -1;
-
-                for (int j = i-1; j >= 0; j--) {
-                    int8 value = list_get(bi1_copy->decimal, j);
-                    if (bi1_copy->decimal->status_code != LIST_OK) {
-                        bi1_copy->status_code = BGI_DECIMAL_FAIL;
-                        bgi_free(bi2_copy);
-                        return bi1_copy;
-                    }
-                    if (value > 0) {
-                        carrier_index = j;
-                        break;
-                    }
-                }
-
-                if (carrier_index > -1) {
-                    int8 value = list_get(bi1_copy->decimal, carrier_index);
-                    if (bi1_copy->decimal->status_code != LIST_OK) {
-                        bi1_copy->status_code = BGI_DECIMAL_FAIL;
-                        bgi_free(bi2_copy);
-                        return bi1_copy;
-                    }
-
-                    list_set(bi1_copy->decimal, carrier_index, value-1);
-                    if (bi1_copy->decimal->status_code != LIST_OK) {
-                        bi1_copy->status_code = BGI_DECIMAL_FAIL;
-                        bgi_free(bi2_copy);
-                        return bi1_copy;
-                    }
-
-                    for (int j = carrier_index+1; j < i; j++) {
-                        list_set(bi1_copy->decimal, j, 9);
-                        if (bi1_copy->decimal->status_code != LIST_OK) {
-                            bi1_copy->status_code = BGI_DECIMAL_FAIL;
-                            bgi_free(bi2_copy);
-                            return bi1_copy;
-                        }
-                    }
-
-                    list_set(bi1_copy->decimal, i, n1+10-n2);
-                    if (bi1_copy->decimal->status_code != LIST_OK) {
-                        bi1_copy->status_code = BGI_DECIMAL_FAIL;
-                        bgi_free(bi2_copy);
-                        return bi1_copy;
-                    }
-                } else { // have to carrier from numeric part
-                    for (int j = list_len(bi1_copy->numeric)-1; j >= 0; j--) {
-                        int8 value = list_get(bi1_copy->numeric, j);
-                        if (bi1_copy->numeric->status_code != LIST_OK) {
-                            bi1_copy->status_code = BGI_NUMERIC_FAIL;
-                            bgi_free(bi2_copy);
-                            return bi1_copy;
-                        }
-                        if (value > 0) {
-                            carrier_index = j;
-                            break;
-                        }
-                    }
-
-                    bgi_assert(carrier_index != -1, "carrier_index cannot be -1 (something went wrong)");
-                    if (carrier_index == -1) {
-                        bgi_free(bi1_copy);
-                        bgi_free(bi2_copy);
-                        return NULL;
-                    }
-
-                    int8 value = list_get(bi1_copy->numeric, carrier_index);
-                    if (bi1_copy->numeric->status_code != LIST_OK) {
-                        bi1_copy->status_code = BGI_NUMERIC_FAIL;
-                        bgi_free(bi2_copy);
-                        return bi1_copy;
-                    }
-                    list_set(bi1_copy->numeric, carrier_index, value-1);
-                    if (bi1_copy->numeric->status_code != LIST_OK) {
-                        bi1_copy->status_code = BGI_NUMERIC_FAIL;
-                        bgi_free(bi2_copy);
-                        return bi1_copy;
-                    }
-
-                    for (int j = carrier_index+1; j < list_len(bi1_copy->numeric); j++) {
-                        list_set(bi1_copy->numeric, j, 9);
-                        if (bi1_copy->numeric->status_code != LIST_OK) {
-                            bi1_copy->status_code = BGI_NUMERIC_FAIL;
-                            bgi_free(bi2_copy);
-                            return bi1_copy;
-                        }
-                    }
-
-                    for (int j = 0; j < i; j++) {
-                        list_set(bi1_copy->decimal, j, 9);
-                        if (bi1_copy->decimal->status_code != LIST_OK) {
-                            bi1_copy->status_code = BGI_DECIMAL_FAIL;
-                            bgi_free(bi2_copy);
-                            return bi1_copy;
-                        }
-                    }
-
-                    list_set(bi1_copy->decimal, i, n1+10-n2);
-                    if (bi1_copy->decimal->status_code != LIST_OK) {
-                        bi1_copy->status_code = BGI_DECIMAL_FAIL;
-                        bgi_free(bi2_copy);
-                        return bi1_copy;
-                    }
-                }
+            if (!bgi_parser_put(parser->decimal, buf + start, i - start)) {
+                parser->status_code = BGI_DECIMAL_FAIL;
+                break;
             }
         }
-    }
+        parser->part_len += i - start;
 
-    if (list_len(bi1_copy->numeric) > 0 && list_len(bi2_copy->numeric) > 0) {
-        bgi_assert(list_len(bi1_copy->numeric) >= list_len(bi2_copy->numeric), "bi1_copy->numeric length should be greater or equal to bi2_copy->numeric length");
-        if (list_len(bi1_copy->numeric) < list_len(bi2_copy->numeric)) {
-            bgi_free(bi1_copy);
-            bgi_free(bi2_copy);
-            return NULL;
+        if (i == len) {
+            break;
         }
-
-        for (size_t i = 0; i < list_len(bi2_copy->numeric); i++) {
-            int b1i = list_len(bi1_copy->numeric)-i-1;
-            int b2i = list_len(bi2_copy->numeric)-i-1;
-
-            int8 n1 = list_get(bi1_copy->numeric, b1i);
-            int8 n2 = list_get(bi2_copy->numeric, b2i);
-
-            if (bi1_copy->numeric->status_code != LIST_OK) {
-                bi1_copy->status_code = BGI_NUMERIC_FAIL;
-                bgi_free(bi2_copy);
-                return bi1_copy;
-            }
-
-            if (bi2_copy->numeric->status_code != LIST_OK) {
-                bi2_copy->status_code = BGI_NUMERIC_FAIL;
-                bgi_free(bi1_copy);
-                return bi2_copy;
-            }
-
-            if (n1 >= n2) {
-                list_set(bi1_copy->numeric, b1i, n1-n2);
-                if (bi1_copy->numeric->status_code != LIST_OK) {
-                    bi1_copy->status_code = BGI_NUMERIC_FAIL;
-                    bgi_free(bi2_copy);
-                    return bi1_copy;
-                }
-            } else {
-                int carrier_index = -1;
-                for (int j = b1i-1; j >= 0; j--) {
-                    int8 value = list_get(bi1_copy->numeric, j);
-                    if (bi1_copy->numeric->status_code != LIST_OK) {
-                        bi1_copy->status_code = BGI_NUMERIC_FAIL;
-                        bgi_free(bi2_copy);
-                        return bi1_copy;
-                    }
-                    if (value > 0) {
-                        carrier_index = j;
-                        list_set(bi1_copy->numeric, j, value-1);
-                        if (bi1_copy->numeric->status_code != LIST_OK) {
-                            bi1_copy->status_code = BGI_NUMERIC_FAIL;
-                            bgi_free(bi2_copy);
-                            return bi1_copy;
-                        }
-                        break;
-                    }
-                }
-
-                bgi_assert(carrier_index != -1, "carrier_index cannot be -1");
-                if (carrier_index == -1) {
-                    bgi_free(bi1_copy);
-                    bgi_free(bi2_copy);
-                    return NULL;
-                }
-
-                for (int j = carrier_index+1; j < b1i; j++) {
-                    list_set(bi1_copy->numeric, j, 9);
-                    if (bi1_copy->numeric->status_code != LIST_OK) {
-                        bi1_copy->status_code = BGI_NUMERIC_FAIL;
-                        bgi_free(bi2_copy);
-                        return bi1_copy;
-                    }
-                }
-
-                list_set(bi1_copy->numeric, b1i, n1+10-n2);
-                if (bi1_copy->numeric->status_code != LIST_OK) {
-                    bi1_copy->status_code = BGI_NUMERIC_FAIL;
-                    bgi_free(bi2_copy);
-                    return bi1_copy;
-                }
-            }
+        if (buf[i] != '.' || parser->in_decimal || parser->part_len == 0) {
+            parser->status_code = BGI_INVALID_TEXT_VALUE;
+            break;
         }
+        parser->in_decimal = true;
+        parser->part_len = 0;
+        i++;
     }
 
-    BigInt *bi3 = bgi_init("0");
-    if (bi3 == NULL) {
-        bgi_free(bi1_copy);
-        bgi_free(bi2_copy);
+    parser->fed += i;
+    return parser->status_code;
+}
+
+// the value of the text fed so far, the parser is freed. the result carries
+// the status of the parser, like bgi_init for an invalid text
+BigInt *bgi_parser_finish(BgiParser *parser) {
+    bgi_assert(parser != NULL, "parser cannot be NULL");
+    if (parser == NULL) {
         return NULL;
     }
 
-    if (bi3->status_code != BGI_OK) {
-        bgi_free(bi1_copy);
-        bgi_free(bi2_copy);
-        return bi3;
+    BigIntStatusCode status_code = parser->status_code;
+    if (status_code == BGI_OK && (parser->fed == 0 || (parser->in_decimal && parser->part_len == 0))) {
+        status_code = BGI_INVALID_TEXT_VALUE;
     }
 
-    bool is_all_numeric_digits_are_zeros = true;
-    for (size_t i = 0; i < list_len(bi1_copy->numeric); i++) {
-        int8 value = list_get(bi1_copy->numeric, i);
-        if (bi1_copy->numeric->status_code != LIST_OK) {
-            bi1_copy->status_code = BGI_NUMERIC_FAIL;
-            bgi_free(bi2_copy);
-            return bi1_copy;
-        }
-        if (is_all_numeric_digits_are_zeros && value == 0) {
-            continue;
-        }
-        is_all_numeric_digits_are_zeros = false; 
-        list_append(bi3->numeric, value);
-        if (bi3->numeric->status_code != LIST_OK) {
-            bi3->status_code = BGI_NUMERIC_FAIL;
-            bgi_free(bi1_copy);
-            bgi_free(bi2_copy);
-            return bi3;
+    BigInt *bi = bgi_init_text("0");
+    if (bi == NULL || bi->status_code != BGI_OK || status_code != BGI_OK) {
+        if (bi != NULL && bi->status_code == BGI_OK) {
+            bi->status_code = status_code;
         }
+        bgi_parser_free(parser);
+        return bi;
     }
 
-    int last_valid_decimal_index = -1;
-    for (int i = list_len(bi1_copy->decimal)-1; i >= 0; i--) {
-        int8 value = list_get(bi1_copy->decimal, i);
-        if (bi1_copy->decimal->status_code != LIST_OK) {
-            bi1_copy->status_code = BGI_DECIMAL_FAIL;
-            bgi_free(bi2_copy);
-            bgi_free(bi3);
-            return bi1_copy;
-        }
-        if (value != 0) {
-            last_valid_decimal_index = i;
-            break;
-        }
+    // the lists move into the result, only the order of the integer digits changes
+    list_free(bi->numeric);
+    list_free(bi->decimal);
+    bi->numeric = parser->numeric;
+    bi->decimal = parser->decimal;
+    parser->numeric = NULL;
+    parser->decimal = NULL;
+
+    list_reverse(bi->numeric);
+    if (!parser->decimal_non_zero) {
+        list_resize(bi->decimal, 0);
     }
-
-    for (int i = 0; i <= last_valid_decimal_index; i++) {
-        int8 value = list_get(bi1_copy->decimal, i);
-        if (bi1_copy->decimal->status_code != LIST_OK) {
-            bi1_copy->status_code = BGI_DECIMAL_FAIL;
-            bgi_free(bi2_copy);
-            bgi_free(bi3);
-            return bi1_copy;
-        }
-        list_append(bi3->decimal, value);
-        if (bi3->decimal->status_code != LIST_OK) {
-            bi3->status_code = BGI_DECIMAL_FAIL;
-            bgi_free(bi1_copy);
-            bgi_free(bi2_copy);
-            return bi3;
-        }
+    bi->sign = parser->sign;
+    if (list_len(bi->numeric) == 0 && list_len(bi->decimal) == 0) {
+        bi->sign = true;
     }
 
-    bi3->sign = sign;
-    bgi_free(bi1_copy);
-    bgi_free(bi2_copy);
-
-    return bi3;
+    bgi_parser_free(parser);
+    return bi;
 }
 
-BigInt *bgi_mult(BigInt *bi1, BigInt *bi2) {
-    bgi_assert(bi1 != NULL, "bi1 cannot be NULL");
-    bgi_assert(bi1->numeric != NULL, "bi1->numeric cannot be NULL");
-    bgi_assert(bi1->decimal != NULL, "bi1->decimal cannot be NULL");
-
-    if (bi1 == NULL || bi1->numeric == NULL || bi1->decimal == NULL) {
-        return NULL;
+// drops a parser that is not finished
+void bgi_parser_free(BgiParser *parser) {
+    if (parser == NULL) {
+        return;
     }
+    list_free(parser->numeric);
+    list_free(parser->decimal);
+    free(parser);
+}
 
-    if (bi1->status_code != BGI_OK || bi1->status_code != LIST_OK || bi1->status_code != LIST_OK) {
-        return NULL;
-    }
+// formatting
+//
+// bgi_format writes bi with the options of a BgiFormat. FIXED and SCIENTIFIC
+// round half away from zero, and SCIENTIFIC only reads the digits it prints
+// plus one, so a summary of a huge value costs as much as its precision.
+// digits above 9 of other bases are lowercase letters. the text is released
+// with bgi_free_text, NULL when bi is not valid or the options cannot be
+// applied
 
-    bgi_assert(bi2 != NULL, "bi2 cannot be NULL");
-    bgi_assert(bi2->numeric != NULL, "bi2->numeric cannot be NULL");
-    bgi_assert(bi2->decimal != NULL, "bi2->decimal cannot be NULL");
+// integer digits MSD first and fraction digits of the text, as characters
+typedef struct {
+    bool negative;
+    const char *integer;
+    size_t integer_len;
+    const char *fraction;
+    size_t fraction_len;
+    char exponent[24]; // empty without an exponent
+} BgiFormatParts;
+
+static size_t bgi_format_group_len(size_t len, const BgiFormat *format, size_t group_size) {
+    return format->group != 0 && len > 0 ? len + (len - 1) / group_size : len;
+}
 
-    if (bi2 == NULL || bi2->numeric == NULL || bi2->decimal == NULL) {
-        return NULL;
-    }
+static const char *bgi_format_write(const BgiFormatParts *parts, const BgiFormat *format) {
+    size_t group_size = format->group_size > 0 ? format->group_size : 3;
+    bool sign = parts->negative || format->plus;
 
-    if (bi2->status_code != BGI_OK || bi2->status_code != LIST_OK || bi2->status_code != LIST_OK) {
-        return NULL;
+    size_t length = sign + bgi_format_group_len(parts->integer_len, format, group_size);
+    if (parts->fraction_len > 0) {
+        length += 1 + parts->fraction_len;
     }
+    length += strlen(parts->exponent);
 
-    // handle the multipication by zero
-    BigInt *zero = bgi_init("0"); 
-    if (zero == NULL) {
+    char *text = bgi_text_alloc(length + 1);
+    if (text == NULL) {
         return NULL;
     }
 
-    if (zero->status_code != BGI_OK) {
-        return zero;
+    char *out = text;
+    if (sign) {
+        *out++ = parts->negative ? '-' : '+';
     }
-
-    int cmp1 = bgi_cmp(zero, bi1);
-    if (bi1->status_code != BGI_OK) {
-        return bi1;
+    for (size_t i = 0; i < parts->integer_len; i++) {
+        // a separator goes before every group but the first
+        if (format->group != 0 && i > 0 && (parts->integer_len - i) % group_size == 0) {
+            *out++ = format->group;
+        }
+        *out++ = parts->integer[i];
     }
-    if (zero->status_code != BGI_OK) {
-        return zero;
+    if (parts->fraction_len > 0) {
+        *out++ = '.';
+        memcpy(out, parts->fraction, parts->fraction_len);
+        out += parts->fraction_len;
     }
+    strcpy(out, parts->exponent);
+    return text;
+}
 
-    int cmp2 = bgi_cmp(zero, bi2);
-    if (bi2->status_code != BGI_OK) {
-        return bi2;
-    }
-    if (zero->status_code != BGI_OK) {
-        return zero;
+// the value is negative in the text only when one of its digits is not zero
+static bool bgi_format_any_non_zero(const char *digits, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        if (digits[i] != '0') {
+            return true;
+        }
     }
+    return false;
+}
 
-    if (cmp1 == 0 || cmp2 == 0) {
-        return zero;
+// adds one to the last digit of digits, true when it carries out of the first
+static bool bgi_format_round_up(char *digits, size_t len) {
+    for (size_t i = len; i-- > 0;) {
+        if (digits[i] != '9') {
+            digits[i]++;
+            return false;
+        }
+        digits[i] = '0';
     }
+    return true;
+}
 
-    bgi_free(zero);
-
-    // handle non zero multipication
-    size_t decimal_points = list_len(bi1->decimal) + list_len(bi2->decimal);
+// magnitude of an integer in base, converted through binary limbs that are
+// divided by the largest power of base that fits in a limb
+static char *bgi_format_base(const BigInt *bi, unsigned base, size_t *len) {
+    static const char symbols[] = "0123456789abcdefghijklmnopqrstuvwxyz";
 
-    BigInt *bi1_copy = bgi_init("0");
-    if (bi1_copy == NULL) {
+    size_t limbs_len = 0;
+    uint32_t *limbs = bgi_to_limbs(bi, bgi_limbs_width(bi), &limbs_len);
+    char *digits = (char*)bgi_scratch_alloc(32 * limbs_len + 1);
+    if (limbs == NULL || digits == NULL) {
         return NULL;
     }
 
-    if (bi1_copy->status_code != BGI_OK) {
-        return bi1_copy;
+    uint32_t chunk = base;
+    size_t chunk_digits = 1;
+    while ((uint64_t)chunk * base <= UINT32_MAX) {
+        chunk *= base;
+        chunk_digits++;
     }
 
-    bi1_copy->sign    = bi1->sign;
-    bi1_copy->numeric = list_clone(bi1->numeric);
-
-    if (bi1_copy->numeric == NULL || bi1_copy->numeric->status_code != LIST_OK) {
-        bi1_copy->status_code = BGI_NUMERIC_FAIL;
-        return bi1_copy;
-    }
-
-    for (size_t i = 0; i < list_len(bi1->decimal); i++) {
-        int8 value = list_get(bi1->decimal, i);
-        if (bi1->decimal->status_code != LIST_OK) {
-            return NULL;
+    size_t n = 0;
+    while (limbs_len > 0) {
+        uint64_t rem = 0;
+        for (size_t i = limbs_len; i-- > 0;) {
+            uint64_t value = rem << 32 | limbs[i];
+            limbs[i] = (uint32_t)(value / chunk);
+            rem = value % chunk;
         }
-        list_append(bi1_copy->numeric, value);
-        if (bi1_copy->numeric->status_code != LIST_OK) {
-            bi1_copy->status_code = BGI_NUMERIC_FAIL;
-            return bi1_copy;
+        while (limbs_len > 0 && limbs[limbs_len-1] == 0) {
+            limbs_len--;
+        }
+        for (size_t j = 0; j < chunk_digits && (limbs_len > 0 || rem > 0); j++) {
+            digits[n++] = symbols[rem % base];
+            rem /= base;
         }
     }
-
-    BigInt *result = bgi_init("0");
-    if (result == NULL) {
-        return NULL;
-    }
-    if (result->status_code != BGI_OK) {
-        bgi_free(bi1_copy);
-        return result;
+    if (n == 0) {
+        digits[n++] = '0';
     }
 
-    List *lists[2] = {bi2->decimal, bi2->numeric};
-    int8 carrier = 0;
-    for (size_t li = 0; li < 2; li++) {
-        for (size_t i = 0; i < list_len(lists[li]); i++) {
-            BigInt *temp = bgi_clone(bi1_copy);
-            if (temp == NULL) {
-                bgi_free(bi1_copy);
-                return NULL;
-            }
-            if (temp->status_code != BGI_OK) {
-                bgi_free(bi1_copy);
-                bgi_free(result);
-                return temp;
-            }
-            list_reverse(temp->numeric);
-            if  (temp->numeric->status_code != LIST_OK) {
-                temp->status_code = BGI_NUMERIC_FAIL;
-                bgi_free(bi1_copy);
-                bgi_free(result);
-                return temp;
-            }
-            int8 multiplier = list_get(lists[li], list_len(lists[li])-i-1);
-            if (bi2->decimal->status_code != LIST_OK) {
-                bgi_free(bi1_copy);
-                bgi_free(temp);
-                bgi_free(result);
-                return NULL;
-            }
-
-            for (size_t j = 0; j < list_len(temp->numeric); j++) {
-                int8 n1 = list_get(temp->numeric, j);
-                if (temp->numeric->status_code != LIST_OK) {
-                    temp->status_code = BGI_NUMERIC_FAIL;
-                    bgi_free(bi1_copy);
-                    bgi_free(result);
-                    return temp;
-                }
-
-                int8 value = carrier + (n1 * multiplier);
-                carrier = value/10;
-
-                list_set(temp->numeric, j, value%10);
-                if (temp->numeric->status_code != LIST_OK) {
-                    temp->status_code = BGI_NUMERIC_FAIL;
-                    bgi_free(bi1_copy);
-                    bgi_free(result);
-                    return temp;
-                }
-            }
-            if (carrier != 0) {
-                list_append(temp->numeric, carrier);
-                if (temp->numeric->status_code != LIST_OK) {
-                    temp->status_code = BGI_NUMERIC_FAIL;
-                    bgi_free(result);
-                    bgi_free(bi1_copy);
-                    return temp;
-                }
-                carrier = 0;
-            }
-
-            list_reverse(temp->numeric);
-            if (temp->numeric->status_code != LIST_OK) {
-                bgi_free(bi1_copy);
-                bgi_free(result);
-                return temp;
-            }
+    for (size_t i = 0; i < n/2; i++) {
+        char value = digits[i];
+        digits[i] = digits[n-1-i];
+        digits[n-1-i] = value;
+    }
+    *len = n;
+    return digits;
+}
 
-            size_t limit = i;
-            if (li == 1 && list_len(bi2->decimal) > 0) {
-                limit = i + list_len(bi2->decimal);
-            }
-            for (size_t j = 0; j < limit; j++) {
-                list_append(temp->numeric, 0);
-                if (temp->numeric->status_code != LIST_OK) {
-                    bgi_free(bi1_copy);
-                    bgi_free(result);
-                    return temp;
-                }
-            }
+// all integer digits, then the first precision fraction digits rounded
+static bool bgi_format_fixed(const BigInt *bi, size_t precision, BgiFormatParts *parts) {
+    ListSpan numeric = list_span(bi->numeric);
+    ListSpan decimal = list_span(bi->decimal);
 
-            BigInt* new_result = bgi_add(result, temp);
-            if (new_result == NULL) {
-                bgi_free(bi1_copy);
-                bgi_free(result);
-                bgi_free(temp);
-                return NULL;
-            }
+    // one digit in front for the carry, and a 0 integer digit when there is none
+    size_t integer_len = numeric.len > 0 ? numeric.len : 1;
+    char *digits = (char*)bgi_scratch_alloc(1 + integer_len + precision);
+    if (digits == NULL) {
+        return false;
+    }
 
-            bgi_free(result);
-            bgi_free(temp);
-            result = new_result;
-        }
+    char *out = digits + 1;
+    if (numeric.len == 0) {
+        *out++ = '0';
+    }
+    for (size_t i = 0; i < numeric.len; i++) {
+        *out++ = numeric.data[numeric.len-1-i] + '0';
+    }
+    for (size_t i = 0; i < precision; i++) {
+        *out++ = i < decimal.len ? decimal.data[i] + '0' : '0';
     }
 
-    // set correct numeric and decimal values 
-    BigInt *bi3 = bgi_init("0");
-    if (bi3 == NULL) {
-        bgi_free(bi1_copy);
-        bgi_free(result);
-        return NULL;
+    char *first = digits + 1;
+    if (precision < decimal.len && decimal.data[precision] >= 5 && bgi_format_round_up(first, integer_len + precision)) {
+        *--first = '1';
+        integer_len++;
     }
 
-    if (bi3->status_code != BGI_OK) {
-        bgi_free(bi1_copy);
-        bgi_free(result);
-        return bi3;
+    parts->integer      = first;
+    parts->integer_len  = integer_len;
+    parts->fraction     = first + integer_len;
+    parts->fraction_len = precision;
+    return true;
+}
+
+// precision significant digits rounded, and the power of ten of the first
+static bool bgi_format_scientific(const BigInt *bi, size_t precision, BgiFormatParts *parts) {
+    ListSpan numeric = list_span(bi->numeric);
+    ListSpan decimal = list_span(bi->decimal);
+
+    char *digits = (char*)bgi_scratch_alloc(precision);
+    if (digits == NULL) {
+        return false;
     }
 
-    // set numeric digits
-    if (list_len(result->numeric) >= decimal_points) {
-        for (size_t i = 0; i < list_len(result->numeric) - decimal_points; i++) {
-            int8 value = list_get(result->numeric, i);
-            if (result->numeric->status_code != LIST_OK) {
-                result->status_code = BGI_NUMERIC_FAIL;
-                bgi_free(bi3);
-                bgi_free(bi1_copy);
-                return result;
-            }
-            list_append(bi3->numeric, value);
-            if (bi3->numeric->status_code != LIST_OK) {
-                bi3->status_code = BGI_NUMERIC_FAIL;
-                bgi_free(result);
-                bgi_free(bi1_copy);
-                return bi3;
-            }
+    // digits are counted from the first one that is not zero, the integer
+    // digits are trimmed so only the fraction can start with zeros
+    size_t skip = 0;
+    int64_t exponent = 0;
+    if (numeric.len > 0) {
+        exponent = (int64_t)numeric.len - 1;
+    } else {
+        while (skip < decimal.len && decimal.data[skip] == 0) {
+            skip++;
         }
+        exponent = skip < decimal.len ? -(int64_t)skip - 1 : 0;
+        skip = skip < decimal.len ? skip : 0;
+    }
 
-        // set decimal digits
-        for (size_t i = list_len(result->numeric) - decimal_points; i < list_len(result->numeric); i++) {
-            int8 value = list_get(result->numeric, i);
-            if (result->numeric->status_code != LIST_OK) {
-                result->status_code = BGI_NUMERIC_FAIL;
-                bgi_free(bi3);
-                bgi_free(bi1_copy);
-                return result;
-            }
-            list_append(bi3->decimal, value);
-            if (bi3->numeric->status_code != LIST_OK) {
-                bi3->status_code = BGI_DECIMAL_FAIL;
-                bgi_free(result);
-                bgi_free(bi1_copy);
-                return bi3;
-            }
+    size_t total = numeric.len + decimal.len;
+    for (size_t i = 0; i <= precision; i++) {
+        size_t at = skip + i;
+        int8 digit = 0;
+        if (at < numeric.len) {
+            digit = numeric.data[numeric.len-1-at];
+        } else if (at < total) {
+            digit = decimal.data[at - numeric.len];
         }
 
-        // remove unnecessary zeros from end of the decimal digits
-        int first_non_zero_index = -1;
-        for (int i = list_len(bi3->decimal)-1; i >= 0; i--) {
-            int8 value = list_get(bi3->decimal, i);
-            if (bi3->decimal->status_code != LIST_OK) {
-                bi3->status_code = BGI_DECIMAL_FAIL;
-                bgi_free(result);
-                bgi_free(bi1_copy);
-                return bi3;
-            }
-            if (value != 0) {
-                first_non_zero_index = i;
-                break;
-            }
+        if (i < precision) {
+            digits[i] = digit + '0';
+        } else if (digit >= 5 && bgi_format_round_up(digits, precision)) {
+            // 9.99 -> 10.0, the digits are zeros after the carry
+            digits[0] = '1';
+            exponent++;
         }
+    }
 
-        if (first_non_zero_index != -1) {
-            bi3->decimal->index = first_non_zero_index+1;
-        } else {
-            free(bi3->decimal);
-            bi3->decimal = list_init();
-            if (bi3->decimal == NULL) {
-                bgi_free(result);
-                bgi_free(bi1_copy);
-                bgi_free(bi3);
-                return NULL;
-            }
+    parts->integer      = digits;
+    parts->integer_len  = 1;
+    parts->fraction     = digits + 1;
+    parts->fraction_len = precision - 1;
+    snprintf(parts->exponent, sizeof(parts->exponent), "e%+lld", (long long)exponent);
+    return true;
+}
 
-            if (bi3->decimal->status_code != LIST_OK) {
-                bi3->status_code = BGI_DECIMAL_FAIL;
-                bgi_free(bi1_copy);
-                bgi_free(result);
-                return bi3;
-            }
-        }
-    } else {
-        for (size_t i = 0; i < decimal_points-list_len(result->numeric); i++) {
-            list_append(bi3->decimal, 0);
-            if (bi3->decimal->status_code != LIST_OK) {
-                bi3->status_code = BGI_DECIMAL_FAIL;
-                bgi_free(result);
-                bgi_free(bi1_copy);
-                return bi3;
-            }
-        }
+const char *bgi_format(const BigInt *bi, const BgiFormat *format) {
+    bgi_assert(bi != NULL, "bi cannot be NULL");
+    bgi_assert(format != NULL, "format cannot be NULL");
 
-        for (size_t i = 0; i < list_len(result->numeric); i++) {
-            int8 value = list_get(result->numeric, i);
-            if (result->numeric->status_code != LIST_OK) {
-                result->status_code = BGI_NUMERIC_FAIL;
-                bgi_free(bi1_copy);
-                bgi_free(bi3);
-                return result;
-            }
-            list_append(bi3->decimal, value);
-            if (bi3->decimal->status_code != LIST_OK) {
-                bi3->status_code = BGI_DECIMAL_FAIL;
-                bgi_free(result);
-                bgi_free(bi1_copy);
-                return bi3;
-            }
-        }
+    if (bi == NULL || bi->numeric == NULL || bi->decimal == NULL || format == NULL) {
+        return NULL;
     }
 
-    // set the sign
-    bi3->sign = true;
-    if (bi1->sign != bi2->sign) {
-        bi3->sign = false;
+    if (bi->status_code != BGI_OK || bi->numeric->status_code != LIST_OK || bi->decimal->status_code != LIST_OK) {
+        return NULL;
     }
 
-    bgi_free(result);
-    bgi_free(bi1_copy);
-    return bi3;
-}
+    unsigned base = format->base > 0 ? format->base : 10;
+    bgi_assert(base >= 2 && base <= 36, "base should be between 2 and 36");
+    if (base < 2 || base > 36 || (base != 10 && (format->style != BGI_FORMAT_PLAIN || !bgi_is_integer(bi)))) {
+        return NULL;
+    }
 
-void bgi_free(BigInt *bi) {
-    if (bi == NULL) return;
-    if (bi->numeric) {
-        list_free(bi->numeric);
+    BgiFormatParts parts = {0};
+    BgiScratchMark mark = bgi_scratch_mark();
+    bool ok = true;
+
+    if (base != 10) {
+        char *digits = bgi_format_base(bi, base, &parts.integer_len);
+        parts.integer = digits;
+        ok = digits != NULL;
+    } else if (format->style == BGI_FORMAT_FIXED) {
+        ok = bgi_format_fixed(bi, format->precision, &parts);
+    } else if (format->style == BGI_FORMAT_SCIENTIFIC) {
+        ok = bgi_format_scientific(bi, format->precision > 0 ? format->precision : 1, &parts);
+    } else {
+        // plain is fixed with every fraction digit, nothing is rounded away
+        ok = bgi_format_fixed(bi, list_len(bi->decimal), &parts);
     }
-    if (bi->decimal) {
-        list_free(bi->decimal);
+
+    const char *text = NULL;
+    if (ok) {
+        parts.negative = !bi->sign && (bgi_format_any_non_zero(parts.integer, parts.integer_len) || bgi_format_any_non_zero(parts.fraction, parts.fraction_len));
+        text = bgi_format_write(&parts, format);
     }
-    free(bi);
+    bgi_scratch_release(mark);
+    return text;
 }
 
 #endif
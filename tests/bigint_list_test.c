@@ -1,6 +1,6 @@
 #define BIGINT_ASSERT_ENABLED
-#include <time.h>
 #include "../bigint.h"
+#include <time.h>
 
 size_t sizes[] = {
     1,
@@ -254,6 +254,94 @@ void list_clone_test() {
     printf("(TESTING) list_clone_test (COMPLETED)\n\n");
 }
 
+void list_reserve_and_list_resize_test() {
+    printf("(TESTING) list_reserve_and_list_resize_test (STARTED)\n");
+    char msg[200];
+    for (size_t i = 0; i < sizeof(sizes)/sizeof(size_t); i++) {
+        List *l = list_init();
+        sprintf(msg, "TESTCASE FAIL (list_reserve_and_list_resize_test): index (%zu): list cannot be NULL", i);
+        bgi_assert(l != NULL, msg);
+
+        list_reserve(l, sizes[i]);
+        sprintf(msg, "TESTCASE FAIL (list_reserve_and_list_resize_test): index (%zu): %s", i, list_get_status_msg(l));
+        bgi_assert(l->status_code == LIST_OK, msg);
+        sprintf(msg, "TESTCASE FAIL (list_reserve_and_list_resize_test): index (%zu): bufsize should be at least %zu", i, sizes[i]);
+        bgi_assert(l->bufsize >= sizes[i], msg);
+        sprintf(msg, "TESTCASE FAIL (list_reserve_and_list_resize_test): index (%zu): reserve should not change the length", i);
+        bgi_assert(list_len(l) == 0, msg);
+
+        // appending within the reserved capacity should not move the buffer
+        void *buf = l->buf;
+        for (size_t j = 0; j < sizes[i]; j++) {
+            list_append(l, (int8)(j % CHAR_MAX));
+        }
+        sprintf(msg, "TESTCASE FAIL (list_reserve_and_list_resize_test): index (%zu): buffer should not be reallocated", i);
+        bgi_assert(l->buf == buf, msg);
+
+        // grow with zeros, then shrink back
+        list_resize(l, sizes[i] * 2);
+        sprintf(msg, "TESTCASE FAIL (list_reserve_and_list_resize_test): index (%zu): %s", i, list_get_status_msg(l));
+        bgi_assert(l->status_code == LIST_OK, msg);
+        sprintf(msg, "TESTCASE FAIL (list_reserve_and_list_resize_test): index (%zu): list_len(l) should be %zu", i, sizes[i] * 2);
+        bgi_assert(list_len(l) == sizes[i] * 2, msg);
+
+        sprintf(msg, "TESTCASE FAIL (list_reserve_and_list_resize_test): index (%zu): values are not equal", i);
+        for (size_t j = 0; j < sizes[i] * 2; j++) {
+            int8 expect = j < sizes[i] ? (int8)(j % CHAR_MAX) : 0;
+            bgi_assert(list_get(l, j) == expect, msg);
+        }
+
+        list_resize(l, sizes[i] / 2);
+        list_shrink_to_fit(l);
+        sprintf(msg, "TESTCASE FAIL (list_reserve_and_list_resize_test): index (%zu): %s", i, list_get_status_msg(l));
+        bgi_assert(l->status_code == LIST_OK, msg);
+        sprintf(msg, "TESTCASE FAIL (list_reserve_and_list_resize_test): index (%zu): bufsize should be shrunk", i);
+        bgi_assert(l->bufsize == (sizes[i] / 2 > 0 ? sizes[i] / 2 : 1), msg);
+
+        list_free(l);
+        printf("TESTCASE (%zu) passed...\n", i);
+    }
+    printf("(TESTING) list_reserve_and_list_resize_test (COMPLETED)\n\n");
+}
+
+void list_append_n_and_list_fill_test() {
+    printf("(TESTING) list_append_n_and_list_fill_test (STARTED)\n");
+    char msg[200];
+    for (size_t i = 0; i < sizeof(sizes)/sizeof(size_t); i++) {
+        List *l = list_init();
+        sprintf(msg, "TESTCASE FAIL (list_append_n_and_list_fill_test): index (%zu): list cannot be NULL", i);
+        bgi_assert(l != NULL, msg);
+
+        int8 *values = (int8*)malloc(sizeof(int8) * sizes[i]);
+        sprintf(msg, "TESTCASE FAIL (list_append_n_and_list_fill_test): index (%zu): values cannot be NULL", i);
+        bgi_assert(values != NULL, msg);
+        for (size_t j = 0; j < sizes[i]; j++) {
+            values[j] = (int8)(rand() % CHAR_MAX);
+        }
+
+        list_append(l, 1);
+        list_append_n(l, values, sizes[i]);
+        list_fill(l, 7, sizes[i]);
+        sprintf(msg, "TESTCASE FAIL (list_append_n_and_list_fill_test): index (%zu): %s", i, list_get_status_msg(l));
+        bgi_assert(l->status_code == LIST_OK, msg);
+        sprintf(msg, "TESTCASE FAIL (list_append_n_and_list_fill_test): index (%zu): list_len(l) should be %zu", i, 1 + sizes[i] * 2);
+        bgi_assert(list_len(l) == 1 + sizes[i] * 2, msg);
+
+        // compare
+        sprintf(msg, "TESTCASE FAIL (list_append_n_and_list_fill_test): index (%zu): values are not equal", i);
+        bgi_assert(list_get(l, 0) == 1, msg);
+        for (size_t j = 0; j < sizes[i]; j++) {
+            bgi_assert(list_get(l, 1 + j) == values[j], msg);
+            bgi_assert(list_get(l, 1 + sizes[i] + j) == 7, msg);
+        }
+
+        free(values);
+        list_free(l);
+        printf("TESTCASE (%zu) passed...\n", i);
+    }
+    printf("(TESTING) list_append_n_and_list_fill_test (COMPLETED)\n\n");
+}
+
 int main(void) {
     srand(time(NULL));
     list_init_and_list_free_test();
@@ -263,5 +351,7 @@ int main(void) {
     list_set_test();
     list_reverse_test();
     list_clone_test();
+    list_reserve_and_list_resize_test();
+    list_append_n_and_list_fill_test();
     return 0;
 }
@@ -1,7 +1,6 @@
-#include <stdio.h>
-
 #define BIGINT_ASSERT_ENABLED
 #include "../bigint.h"
+#include <stdio.h>
 
 void bgi_init_and_bgi_free_test() {
     char msg[200] = {0};
@@ -281,6 +280,9 @@ void bgi_add_test() {
         (Testcase){.n1="-200.34"     , .n2="-2000.234"       , .expect="-2200.574"},
         (Testcase){.n1="-23423.25252", .n2="6893245459.99999", .expect="6893222036.74747"},
         (Testcase){.n1="20927268"    , .n2="209272680"       , .expect="230199948"},
+        (Testcase){.n1="0.95"        , .n2="0.07"            , .expect="1.02"},
+        (Testcase){.n1="9.99"        , .n2="0.01"            , .expect="10"},
+        (Testcase){.n1="-0.5"        , .n2="0.5"             , .expect="0"},
         (Testcase){
             .n1    ="6893245459.999998080234234234234234",
             .n2    ="23423.252520000000000000000000",
@@ -352,6 +354,8 @@ void bgi_sub_test() {
         (Testcase){.n1="+200"        , .n2="+2000.234"       , .expect="-1800.234"},
         (Testcase){.n1="-200"        , .n2="+2000.234"       , .expect="-2200.234"},
         (Testcase){.n1="-200.34"     , .n2="-2000.234"       , .expect="1799.894"},
+        (Testcase){.n1="1"           , .n2="0.001"           , .expect="0.999"},
+        (Testcase){.n1="10.05"       , .n2="0.06"            , .expect="9.99"},
         (Testcase){.n1="-23423.25252", .n2="6893245459.99999", .expect="-6893268883.25251"},
         (Testcase){
             .n1    ="6893245459.999998080234234234234234",
@@ -492,7 +496,2243 @@ void bgi_mult_test() {
         printf("TESTCASES (%zu) PASSED...\n", i);
     }
 
-    printf("(TESTING) bgi_mult_test (COMPLETED)\n");
+    printf("(TESTING) bgi_mult_test (COMPLETED)\n\n");
+}
+
+void bgi_bitwise_test() {
+    printf("(TESTING) bgi_bitwise_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        const char *n1;
+        const char *n2;
+        char op;
+        const char *expect;
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.n1="12"  , .n2="10" , .op='&', .expect="8"},
+        (Testcase){.n1="12"  , .n2="10" , .op='|', .expect="14"},
+        (Testcase){.n1="12"  , .n2="10" , .op='^', .expect="6"},
+        (Testcase){.n1="-5"  , .n2="3"  , .op='&', .expect="3"},
+        (Testcase){.n1="-5"  , .n2="3"  , .op='|', .expect="-5"},
+        (Testcase){.n1="-5"  , .n2="-3" , .op='^', .expect="6"},
+        (Testcase){.n1="255" , .n2="-256", .op='&', .expect="0"},
+        (Testcase){.n1="0"   , .n2="-1" , .op='|', .expect="-1"},
+        (Testcase){.n1="12"  , .n2="0"  , .op='~', .expect="-13"},
+        (Testcase){.n1="-1"  , .n2="0"  , .op='~', .expect="0"},
+        (Testcase){
+            .n1    ="-123456789012345678901234567890",
+            .n2    ="987654321098765432109876543210",
+            .op    ='&',
+            .expect="985710360914275162674813760554",
+        },
+        (Testcase){
+            .n1    ="-123456789012345678901234567890",
+            .n2    ="987654321098765432109876543210",
+            .op    ='|',
+            .expect="-121512828827855409466171785234",
+        },
+        (Testcase){
+            .n1    ="-123456789012345678901234567890",
+            .n2    ="987654321098765432109876543210",
+            .op    ='^',
+            .expect="-1107223189742130572140985545788",
+        },
+        (Testcase){
+            .n1    ="-123456789012345678901234567890",
+            .n2    ="0",
+            .op    ='~',
+            .expect="123456789012345678901234567889",
+        },
+    };
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        BigInt *bi1 = bgi_init(tc.n1);
+        sprintf(msg, "TESTCASE FAIL: index %zu: bi1 cannot be NULL", i);
+        bgi_assert(bi1 != NULL, msg);
+        sprintf(msg, "TESTCASE FAIL: index %zu: %s", i, bgi_get_status_msg(bi1));
+        bgi_assert(bi1->status_code == BGI_OK, msg);
+
+        BigInt *bi2 = bgi_init(tc.n2);
+        sprintf(msg, "TESTCASE FAIL: index %zu: bi2 cannot be NULL", i);
+        bgi_assert(bi2 != NULL, msg);
+        sprintf(msg, "TESTCASE FAIL: index %zu: %s", i, bgi_get_status_msg(bi2));
+        bgi_assert(bi2->status_code == BGI_OK, msg);
+
+        BigInt *expect = bgi_init(tc.expect);
+        sprintf(msg, "TESTCASE FAIL: index %zu: 'expect' cannot be NULL", i);
+        bgi_assert(expect != NULL, msg);
+
+        BigInt *result = NULL;
+        switch (tc.op) {
+            case '&': result = bgi_and(bi1, bi2); break;
+            case '|': result = bgi_or(bi1, bi2);  break;
+            case '^': result = bgi_xor(bi1, bi2); break;
+            case '~': result = bgi_not(bi1);      break;
+        }
+        sprintf(msg, "TESTCASE FAIL: index %zu: result cannot be NULL", i);
+        bgi_assert(result != NULL, msg);
+        sprintf(msg, "TESTCASE FAIL: index %zu: %s", i, bgi_get_status_msg(result));
+        bgi_assert(result->status_code == BGI_OK, msg);
+
+        int val = bgi_cmp(expect, result);
+        sprintf(msg, "TESTCASE FAIL: n1 %s: n2 %s: op %c: expect %s: real %s: cmp %d", tc.n1, tc.n2, tc.op, tc.expect, bgi_get_text(result), val);
+        bgi_assert(val == 0, msg);
+
+        bgi_free(bi1);
+        bgi_free(bi2);
+        bgi_free(expect);
+        bgi_free(result);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    BigInt *fraction = bgi_init("1.5");
+    BigInt *result   = bgi_and(fraction, fraction);
+    bgi_assert(result != NULL && result->status_code == BGI_NOT_INTEGER, "TESTCASE FAIL: bgi_and should reject non integers");
+    bgi_free(fraction);
+    bgi_free(result);
+
+    printf("(TESTING) bgi_bitwise_test (COMPLETED)\n\n");
+}
+
+void bgi_shift_test() {
+    printf("(TESTING) bgi_shift_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        const char *n;
+        bool left;
+        size_t bits;
+        const char *expect;
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.n="1"    , .left=true , .bits=0  , .expect="1"},
+        (Testcase){.n="1"    , .left=true , .bits=64 , .expect="18446744073709551616"},
+        (Testcase){.n="-3"   , .left=true , .bits=33 , .expect="-25769803776"},
+        (Testcase){.n="0"    , .left=true , .bits=100, .expect="0"},
+        (Testcase){.n="18446744073709551616", .left=false, .bits=64, .expect="1"},
+        (Testcase){.n="-1"   , .left=false, .bits=10 , .expect="-1"},
+        (Testcase){.n="-7"   , .left=false, .bits=1  , .expect="-4"},
+        (Testcase){.n="7"    , .left=false, .bits=1  , .expect="3"},
+        (Testcase){.n="7"    , .left=false, .bits=100, .expect="0"},
+        (Testcase){
+            .n     ="-123456789012345678901234567890",
+            .left  =true,
+            .bits  =70,
+            .expect="-145752050628652680975897013633443949312730317455360",
+        },
+        (Testcase){
+            .n     ="-123456789012345678901234567890",
+            .left  =false,
+            .bits  =70,
+            .expect="-104571968",
+        },
+    };
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        BigInt *bi = bgi_init(tc.n);
+        sprintf(msg, "TESTCASE FAIL: index %zu: bi cannot be NULL", i);
+        bgi_assert(bi != NULL, msg);
+        sprintf(msg, "TESTCASE FAIL: index %zu: %s", i, bgi_get_status_msg(bi));
+        bgi_assert(bi->status_code == BGI_OK, msg);
+
+        BigInt *expect = bgi_init(tc.expect);
+        sprintf(msg, "TESTCASE FAIL: index %zu: 'expect' cannot be NULL", i);
+        bgi_assert(expect != NULL, msg);
+
+        BigInt *result = tc.left ? bgi_shl(bi, tc.bits) : bgi_shr(bi, tc.bits);
+        sprintf(msg, "TESTCASE FAIL: index %zu: result cannot be NULL", i);
+        bgi_assert(result != NULL, msg);
+        sprintf(msg, "TESTCASE FAIL: index %zu: %s", i, bgi_get_status_msg(result));
+        bgi_assert(result->status_code == BGI_OK, msg);
+
+        int val = bgi_cmp(expect, result);
+        sprintf(msg, "TESTCASE FAIL: n %s: bits %zu: expect %s: real %s: cmp %d", tc.n, tc.bits, tc.expect, bgi_get_text(result), val);
+        bgi_assert(val == 0, msg);
+
+        bgi_free(bi);
+        bgi_free(expect);
+        bgi_free(result);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    printf("(TESTING) bgi_shift_test (COMPLETED)\n\n");
+}
+
+void bgi_popcount_and_test_bit_test() {
+    printf("(TESTING) bgi_popcount_and_test_bit_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        const char *n;
+        size_t popcount;
+        size_t bit;
+        bool is_set;
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.n="0"   , .popcount=0       , .bit=0  , .is_set=false},
+        (Testcase){.n="255" , .popcount=8       , .bit=7  , .is_set=true},
+        (Testcase){.n="256" , .popcount=1       , .bit=7  , .is_set=false},
+        (Testcase){.n="-1"  , .popcount=SIZE_MAX, .bit=500, .is_set=true},
+        (Testcase){.n="-256", .popcount=SIZE_MAX, .bit=7  , .is_set=false},
+        (Testcase){.n="-256", .popcount=SIZE_MAX, .bit=8  , .is_set=true},
+        (Testcase){.n="987654321098765432109876543210", .popcount=54, .bit=0, .is_set=false},
+        (Testcase){.n="-123456789012345678901234567890", .popcount=SIZE_MAX, .bit=100, .is_set=true},
+    };
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        BigInt *bi = bgi_init(tc.n);
+        sprintf(msg, "TESTCASE FAIL: index %zu: bi cannot be NULL", i);
+        bgi_assert(bi != NULL, msg);
+        sprintf(msg, "TESTCASE FAIL: index %zu: %s", i, bgi_get_status_msg(bi));
+        bgi_assert(bi->status_code == BGI_OK, msg);
+
+        size_t popcount = bgi_popcount(bi);
+        sprintf(msg, "TESTCASE FAIL: n %s: popcount: expect %zu: real %zu", tc.n, tc.popcount, popcount);
+        bgi_assert(popcount == tc.popcount, msg);
+
+        bool is_set = bgi_test_bit(bi, tc.bit);
+        sprintf(msg, "TESTCASE FAIL: n %s: bit %zu: expect %d: real %d", tc.n, tc.bit, tc.is_set, is_set);
+        bgi_assert(is_set == tc.is_set, msg);
+
+        bgi_free(bi);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    printf("(TESTING) bgi_popcount_and_test_bit_test (COMPLETED)\n\n");
+}
+
+void bgi_shift10_test() {
+    printf("(TESTING) bgi_shift10_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        const char *n;
+        int64_t k;
+        const char *expect;
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.n="1"         , .k=3  , .expect="1000"},
+        (Testcase){.n="1"         , .k=-3 , .expect="0.001"},
+        (Testcase){.n="-12.345"   , .k=2  , .expect="-1234.5"},
+        (Testcase){.n="-12.345"   , .k=3  , .expect="-12345"},
+        (Testcase){.n="-12.345"   , .k=5  , .expect="-1234500"},
+        (Testcase){.n="12.345"    , .k=-1 , .expect="1.2345"},
+        (Testcase){.n="12.345"    , .k=-4 , .expect="0.0012345"},
+        (Testcase){.n="0.05"      , .k=1  , .expect="0.5"},
+        (Testcase){.n="0.05"      , .k=2  , .expect="5"},
+        (Testcase){.n="1200"      , .k=-2 , .expect="12"},
+        (Testcase){.n="1200"      , .k=-5 , .expect="0.012"},
+        (Testcase){.n="0"         , .k=10 , .expect="0"},
+        (Testcase){.n="-0.000"    , .k=-10, .expect="0"},
+        (Testcase){.n="98765.4321", .k=0  , .expect="98765.4321"},
+    };
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        BigInt *bi = bgi_init(tc.n);
+        sprintf(msg, "TESTCASE FAIL: index %zu: bi cannot be NULL", i);
+        bgi_assert(bi != NULL, msg);
+        sprintf(msg, "TESTCASE FAIL: index %zu: %s", i, bgi_get_status_msg(bi));
+        bgi_assert(bi->status_code == BGI_OK, msg);
+
+        BigInt *expect = bgi_init(tc.expect);
+        sprintf(msg, "TESTCASE FAIL: index %zu: 'expect' cannot be NULL", i);
+        bgi_assert(expect != NULL, msg);
+
+        BigInt *result = tc.k >= 0 ? bgi_mul_pow10(bi, tc.k) : bgi_div_pow10(bi, -tc.k);
+        sprintf(msg, "TESTCASE FAIL: index %zu: result cannot be NULL", i);
+        bgi_assert(result != NULL, msg);
+        sprintf(msg, "TESTCASE FAIL: index %zu: %s", i, bgi_get_status_msg(result));
+        bgi_assert(result->status_code == BGI_OK, msg);
+
+        int val = bgi_cmp(expect, result);
+        sprintf(msg, "TESTCASE FAIL: n %s: k %lld: expect %s: real %s: cmp %d", tc.n, (long long)tc.k, tc.expect, bgi_get_text(result), val);
+        bgi_assert(val == 0, msg);
+
+        sprintf(msg, "TESTCASE FAIL: n %s: k %lld: digits are not normalized", tc.n, (long long)tc.k);
+        bgi_assert(list_len(result->numeric) == list_len(expect->numeric) && list_len(result->decimal) == list_len(expect->decimal), msg);
+
+        bgi_free(bi);
+        bgi_free(expect);
+        bgi_free(result);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    printf("(TESTING) bgi_shift10_test (COMPLETED)\n\n");
+}
+
+void bgi_shift10_limits_test() {
+    printf("(TESTING) bgi_shift10_limits_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        const char *n;
+        char op; // '*' bgi_mul_pow10, '/' bgi_div_pow10, 's' bgi_shift10
+        uint64_t k;
+        BigIntStatusCode code;
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.n="1"  , .op='*', .k=SIZE_MAX                , .code=BGI_OUT_OF_RANGE},
+        (Testcase){.n="1"  , .op='/', .k=SIZE_MAX                , .code=BGI_OUT_OF_RANGE},
+        (Testcase){.n="1"  , .op='/', .k=(uint64_t)INT64_MAX + 1 , .code=BGI_OUT_OF_RANGE},
+        (Testcase){.n="12" , .op='*', .k=INT64_MAX               , .code=BGI_OUT_OF_RANGE},
+        (Testcase){.n="12" , .op='*', .k=INT64_MAX - 1           , .code=BGI_OUT_OF_RANGE},
+        (Testcase){.n="0.5", .op='/', .k=INT64_MAX               , .code=BGI_OUT_OF_RANGE},
+        (Testcase){.n="12" , .op='s', .k=(uint64_t)INT64_MIN     , .code=BGI_OUT_OF_RANGE},
+        (Testcase){.n="12" , .op='s', .k=INT64_MAX               , .code=BGI_OUT_OF_RANGE},
+        (Testcase){.n="0"  , .op='*', .k=SIZE_MAX                , .code=BGI_OK},
+        (Testcase){.n="0"  , .op='s', .k=(uint64_t)INT64_MIN     , .code=BGI_OK},
+    };
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        BigInt *bi = bgi_init(tc.n);
+        sprintf(msg, "TESTCASE FAIL: index %zu: bi cannot be NULL", i);
+        bgi_assert(bi != NULL, msg);
+
+        BigInt *result = NULL;
+        switch (tc.op) {
+            case '*': result = bgi_mul_pow10(bi, (size_t)tc.k); break;
+            case '/': result = bgi_div_pow10(bi, (size_t)tc.k); break;
+            default:  result = bgi_shift10(bi, (int64_t)tc.k); break;
+        }
+        sprintf(msg, "TESTCASE FAIL: index %zu: result cannot be NULL", i);
+        bgi_assert(result != NULL, msg);
+        sprintf(msg, "TESTCASE FAIL: index %zu: expect status %d, got %s", i, tc.code, bgi_get_status_msg(result));
+        bgi_assert(result->status_code == tc.code, msg);
+
+        bgi_free(bi);
+        bgi_free(result);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    printf("(TESTING) bgi_shift10_limits_test (COMPLETED)\n\n");
+}
+
+void bgi_get_text_test() {
+    printf("(TESTING) bgi_get_text_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        const char *n;
+        const char *expect;
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.n="0"          , .expect="+0"},
+        (Testcase){.n="-0.000"     , .expect="+0"},
+        (Testcase){.n="123"        , .expect="+123"},
+        (Testcase){.n="-0.0625"    , .expect="-0.0625"},
+        (Testcase){.n="0.123456789", .expect="+0.123456789"},
+        (Testcase){.n="-12.5"      , .expect="-12.5"},
+        (Testcase){.n="007.50"     , .expect="+7.50"},
+        (Testcase){.n="-0001000"   , .expect="-1000"},
+    };
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        BigInt *bi = bgi_init(tc.n);
+        sprintf(msg, "TESTCASE FAIL: index %zu: bi cannot be NULL", i);
+        bgi_assert(bi != NULL, msg);
+        sprintf(msg, "TESTCASE FAIL: index %zu: %s", i, bgi_get_status_msg(bi));
+        bgi_assert(bi->status_code == BGI_OK, msg);
+
+        const char *text = bgi_get_text(bi);
+        sprintf(msg, "TESTCASE FAIL: index %zu: text cannot be NULL", i);
+        bgi_assert(text != NULL, msg);
+
+        sprintf(msg, "TESTCASE FAIL: n %s: expect %s: real %s", tc.n, tc.expect, text);
+        bgi_assert(strcmp(text, tc.expect) == 0, msg);
+
+        bgi_free_text(text);
+        bgi_free(bi);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    printf("(TESTING) bgi_get_text_test (COMPLETED)\n\n");
+}
+
+void bgi_add_ui_and_bgi_mul_ui_test() {
+    printf("(TESTING) bgi_add_ui_and_bgi_mul_ui_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        const char *n;
+        char op;
+        int64_t value;
+        const char *expect;
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.n="0"           , .op='+', .value=1         , .expect="1"},
+        (Testcase){.n="999"         , .op='+', .value=1         , .expect="1000"},
+        (Testcase){.n="12.75"       , .op='+', .value=-20       , .expect="-7.25"},
+        (Testcase){.n="-12.75"      , .op='+', .value=20        , .expect="7.25"},
+        (Testcase){.n="-12.75"      , .op='+', .value=12        , .expect="-0.75"},
+        (Testcase){.n="-12"         , .op='+', .value=12        , .expect="0"},
+        (Testcase){.n="-1000"       , .op='+', .value=1         , .expect="-999"},
+        (Testcase){.n="18446744073709551615", .op='+', .value=INT64_MAX, .expect="27670116110564327422"},
+        (Testcase){.n="-5"          , .op='+', .value=INT64_MIN , .expect="-9223372036854775813"},
+        (Testcase){.n="12.5"        , .op='*', .value=3         , .expect="37.5"},
+        (Testcase){.n="0.25"        , .op='*', .value=4         , .expect="1"},
+        (Testcase){.n="-0.001"      , .op='*', .value=1000      , .expect="-1"},
+        (Testcase){.n="123456789123456789", .op='*', .value=-1000, .expect="-123456789123456789000"},
+        (Testcase){.n="-7"          , .op='*', .value=0         , .expect="0"},
+        (Testcase){.n="2"           , .op='*', .value=INT64_MIN , .expect="-18446744073709551616"},
+    };
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        BigInt *bi = bgi_init(tc.n);
+        sprintf(msg, "TESTCASE FAIL: index %zu: bi cannot be NULL", i);
+        bgi_assert(bi != NULL, msg);
+        sprintf(msg, "TESTCASE FAIL: index %zu: %s", i, bgi_get_status_msg(bi));
+        bgi_assert(bi->status_code == BGI_OK, msg);
+
+        BigInt *expect = bgi_init(tc.expect);
+        sprintf(msg, "TESTCASE FAIL: index %zu: 'expect' cannot be NULL", i);
+        bgi_assert(expect != NULL, msg);
+
+        BigInt *result = tc.op == '+' ? bgi_add_si(bi, tc.value) : bgi_mul_si(bi, tc.value);
+        sprintf(msg, "TESTCASE FAIL: index %zu: result cannot be NULL", i);
+        bgi_assert(result != NULL, msg);
+        sprintf(msg, "TESTCASE FAIL: index %zu: %s", i, bgi_get_status_msg(result));
+        bgi_assert(result->status_code == BGI_OK, msg);
+
+        int val = bgi_cmp(expect, result);
+        sprintf(msg, "TESTCASE FAIL: n %s: op %c: value %lld: expect %s: real %s: cmp %d", tc.n, tc.op, (long long)tc.value, tc.expect, bgi_get_text(result), val);
+        bgi_assert(val == 0, msg);
+
+        bgi_free(bi);
+        bgi_free(expect);
+        bgi_free(result);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    printf("(TESTING) bgi_add_ui_and_bgi_mul_ui_test (COMPLETED)\n\n");
+}
+
+void bgi_divmod_ui_test() {
+    printf("(TESTING) bgi_divmod_ui_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        const char *n;
+        int64_t divisor;
+        const char *expect;
+        int64_t rem;
+        BigIntStatusCode code;
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.n="100"   , .divisor=7   , .expect="14"  , .rem=2  , .code=BGI_OK},
+        (Testcase){.n="-100"  , .divisor=7   , .expect="-14" , .rem=-2 , .code=BGI_OK},
+        (Testcase){.n="100"   , .divisor=-7  , .expect="-14" , .rem=2  , .code=BGI_OK},
+        (Testcase){.n="6"     , .divisor=7   , .expect="0"   , .rem=6  , .code=BGI_OK},
+        (Testcase){.n="3214282912345698765432161182", .divisor=97, .expect="33136937240677306860125373", .rem=1, .code=BGI_OK},
+        (Testcase){.n="123456789012345678901234567890", .divisor=INT64_MAX, .expect="13385211885", .rem=4860475750367701695, .code=BGI_OK},
+        (Testcase){.n="1.5"   , .divisor=7   , .expect="0"   , .rem=0  , .code=BGI_NOT_INTEGER},
+        (Testcase){.n="15"    , .divisor=0   , .expect="0"   , .rem=0  , .code=BGI_DIVISION_BY_ZERO},
+    };
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        BigInt *bi = bgi_init(tc.n);
+        sprintf(msg, "TESTCASE FAIL: index %zu: bi cannot be NULL", i);
+        bgi_assert(bi != NULL, msg);
+        sprintf(msg, "TESTCASE FAIL: index %zu: %s", i, bgi_get_status_msg(bi));
+        bgi_assert(bi->status_code == BGI_OK, msg);
+
+        int64_t rem = 0;
+        BigInt *result = bgi_divmod_si(bi, tc.divisor, &rem);
+        sprintf(msg, "TESTCASE FAIL: index %zu: result cannot be NULL", i);
+        bgi_assert(result != NULL, msg);
+        sprintf(msg, "TESTCASE FAIL: index %zu: status_codes are not equal, expect: %d, real: %d", i, tc.code, result->status_code);
+        bgi_assert(result->status_code == tc.code, msg);
+
+        if (tc.code == BGI_OK) {
+            BigInt *expect = bgi_init(tc.expect);
+            sprintf(msg, "TESTCASE FAIL: index %zu: 'expect' cannot be NULL", i);
+            bgi_assert(expect != NULL, msg);
+
+            int val = bgi_cmp(expect, result);
+            sprintf(msg, "TESTCASE FAIL: n %s: divisor %lld: expect %s: real %s: cmp %d", tc.n, (long long)tc.divisor, tc.expect, bgi_get_text(result), val);
+            bgi_assert(val == 0, msg);
+
+            sprintf(msg, "TESTCASE FAIL: n %s: divisor %lld: rem: expect %lld: real %lld", tc.n, (long long)tc.divisor, (long long)tc.rem, (long long)rem);
+            bgi_assert(rem == tc.rem, msg);
+
+            bgi_free(expect);
+        }
+
+        bgi_free(bi);
+        bgi_free(result);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    printf("(TESTING) bgi_divmod_ui_test (COMPLETED)\n\n");
+}
+
+void bgi_fac_binomial_primorial_test() {
+    printf("(TESTING) bgi_fac_binomial_primorial_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        char fn;
+        uint32_t n;
+        uint32_t k;
+        const char *expect;
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.fn='!', .n=0   , .k=0 , .expect="1"},
+        (Testcase){.fn='!', .n=1   , .k=0 , .expect="1"},
+        (Testcase){.fn='!', .n=5   , .k=0 , .expect="120"},
+        (Testcase){.fn='!', .n=25  , .k=0 , .expect="15511210043330985984000000"},
+        (Testcase){.fn='!', .n=60  , .k=0 , .expect="8320987112741390144276341183223364380754172606361245952449277696409600000000000000"},
+        (Testcase){.fn='C', .n=0   , .k=0 , .expect="1"},
+        (Testcase){.fn='C', .n=5   , .k=7 , .expect="0"},
+        (Testcase){.fn='C', .n=10  , .k=3 , .expect="120"},
+        (Testcase){.fn='C', .n=100 , .k=50, .expect="100891344545564193334812497256"},
+        (Testcase){.fn='C', .n=1000, .k=10, .expect="263409560461970212832400"},
+        (Testcase){.fn='#', .n=1   , .k=0 , .expect="1"},
+        (Testcase){.fn='#', .n=30  , .k=0 , .expect="6469693230"},
+        (Testcase){.fn='#', .n=100 , .k=0 , .expect="2305567963945518424753102147331756070"},
+    };
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        BigInt *expect = bgi_init(tc.expect);
+        sprintf(msg, "TESTCASE FAIL: index %zu: 'expect' cannot be NULL", i);
+        bgi_assert(expect != NULL, msg);
+
+        for (size_t nthreads = 1; nthreads <= 4; nthreads *= 4) {
+            BigInt *result = NULL;
+            switch (tc.fn) {
+                case '!': result = bgi_fac_mt(tc.n, nthreads);             break;
+                case 'C': result = bgi_binomial_mt(tc.n, tc.k, nthreads);  break;
+                case '#': result = bgi_primorial_mt(tc.n, nthreads);       break;
+            }
+            sprintf(msg, "TESTCASE FAIL: index %zu: result cannot be NULL", i);
+            bgi_assert(result != NULL, msg);
+            sprintf(msg, "TESTCASE FAIL: index %zu: %s", i, bgi_get_status_msg(result));
+            bgi_assert(result->status_code == BGI_OK, msg);
+
+            int val = bgi_cmp(expect, result);
+            sprintf(msg, "TESTCASE FAIL: fn %c: n %u: k %u: nthreads %zu: expect %s: real %s: cmp %d", tc.fn, tc.n, tc.k, nthreads, tc.expect, bgi_get_text(result), val);
+            bgi_assert(val == 0, msg);
+
+            bgi_free(result);
+        }
+
+        bgi_free(expect);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    printf("(TESTING) bgi_fac_binomial_primorial_test (COMPLETED)\n\n");
+}
+
+void bgi_div_test() {
+    printf("(TESTING) bgi_div_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        const char *n1;
+        const char *n2;
+        size_t digits;
+        const char *expect;
+        BigIntStatusCode code;
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.n1="22"     , .n2="7"     , .digits=30, .expect="3.142857142857142857142857142857", .code=BGI_OK},
+        (Testcase){.n1="1"      , .n2="3"     , .digits=0 , .expect="0"            , .code=BGI_OK},
+        (Testcase){.n1="-1.5"   , .n2="0.0003", .digits=5 , .expect="-5000"        , .code=BGI_OK},
+        (Testcase){.n1="0.0001" , .n2="300"   , .digits=10, .expect="0.0000003333" , .code=BGI_OK},
+        (Testcase){.n1="0.0001" , .n2="300"   , .digits=5 , .expect="0"            , .code=BGI_OK},
+        (Testcase){.n1="-100"   , .n2="-8"    , .digits=2 , .expect="12.5"         , .code=BGI_OK},
+        (Testcase){.n1="123456789123456789", .n2="-987654321", .digits=4, .expect="-124999998.9859", .code=BGI_OK},
+        (Testcase){.n1="10000000000000000000", .n2="9999999999", .digits=12, .expect="1000000000.10000000001", .code=BGI_OK},
+        (Testcase){.n1="1"      , .n2="0.999999999999", .digits=24, .expect="1.000000000001000000000001", .code=BGI_OK},
+        (Testcase){.n1="5"      , .n2="-0.000", .digits=5 , .expect="0"            , .code=BGI_DIVISION_BY_ZERO},
+    };
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        BigInt *bi1 = bgi_init(tc.n1);
+        sprintf(msg, "TESTCASE FAIL: index %zu: bi1 cannot be NULL", i);
+        bgi_assert(bi1 != NULL, msg);
+        sprintf(msg, "TESTCASE FAIL: index %zu: %s", i, bgi_get_status_msg(bi1));
+        bgi_assert(bi1->status_code == BGI_OK, msg);
+
+        BigInt *bi2 = bgi_init(tc.n2);
+        sprintf(msg, "TESTCASE FAIL: index %zu: bi2 cannot be NULL", i);
+        bgi_assert(bi2 != NULL, msg);
+        sprintf(msg, "TESTCASE FAIL: index %zu: %s", i, bgi_get_status_msg(bi2));
+        bgi_assert(bi2->status_code == BGI_OK, msg);
+
+        BigInt *result = bgi_div(bi1, bi2, tc.digits);
+        sprintf(msg, "TESTCASE FAIL: index %zu: result cannot be NULL", i);
+        bgi_assert(result != NULL, msg);
+        sprintf(msg, "TESTCASE FAIL: index %zu: status_codes are not equal, expect: %d, real: %d", i, tc.code, result->status_code);
+        bgi_assert(result->status_code == tc.code, msg);
+
+        if (tc.code == BGI_OK) {
+            BigInt *expect = bgi_init(tc.expect);
+            sprintf(msg, "TESTCASE FAIL: index %zu: 'expect' cannot be NULL", i);
+            bgi_assert(expect != NULL, msg);
+
+            int val = bgi_cmp(expect, result);
+            sprintf(msg, "TESTCASE FAIL: n1 %s: n2 %s: digits %zu: expect %s: real %s: cmp %d", tc.n1, tc.n2, tc.digits, tc.expect, bgi_get_text(result), val);
+            bgi_assert(val == 0, msg);
+
+            bgi_free(expect);
+        }
+
+        bgi_free(bi1);
+        bgi_free(bi2);
+        bgi_free(result);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    printf("(TESTING) bgi_div_test (COMPLETED)\n\n");
+}
+
+static BigInt *harmonic_b(uint64_t n, void *data) {
+    (void)data;
+    return bgi_init_ui(n + 1);
+}
+
+void bgi_series_sum_test() {
+    printf("(TESTING) bgi_series_sum_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        char name;
+        size_t digits;
+        const char *expect;
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.name='e', .digits=50, .expect="2.71828182845904523536028747135266249775724709369995"},
+        (Testcase){.name='l', .digits=50, .expect="0.69314718055994530941723212145817656807550013436025"},
+        (Testcase){.name='p', .digits=50, .expect="3.1415926535897932384626433832795028841971693993751"},
+        (Testcase){.name='h', .digits=20, .expect="2.59285714285714285714"},
+    };
+
+    // 1 + 1/2 + ... + 1/7, p = q = 1
+    BgiSeries harmonic = {.a=NULL, .b=harmonic_b, .p=NULL, .q=NULL, .data=NULL};
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        BigInt *expect = bgi_init(tc.expect);
+        sprintf(msg, "TESTCASE FAIL: index %zu: 'expect' cannot be NULL", i);
+        bgi_assert(expect != NULL, msg);
+
+        BigInt *result = NULL;
+        switch (tc.name) {
+            case 'e': result = bgi_const_e(tc.digits);                          break;
+            case 'l': result = bgi_const_log2(tc.digits);                       break;
+            case 'p': result = bgi_const_pi(tc.digits);                         break;
+            case 'h': result = bgi_series_sum_mt(&harmonic, 7, tc.digits, 4);   break;
+        }
+        sprintf(msg, "TESTCASE FAIL: index %zu: result cannot be NULL", i);
+        bgi_assert(result != NULL, msg);
+        sprintf(msg, "TESTCASE FAIL: index %zu: %s", i, bgi_get_status_msg(result));
+        bgi_assert(result->status_code == BGI_OK, msg);
+
+        int val = bgi_cmp(expect, result);
+        sprintf(msg, "TESTCASE FAIL: name %c: digits %zu: expect %s: real %s: cmp %d", tc.name, tc.digits, tc.expect, bgi_get_text(result), val);
+        bgi_assert(val == 0, msg);
+
+        bgi_free(expect);
+        bgi_free(result);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    printf("(TESTING) bgi_series_sum_test (COMPLETED)\n\n");
+}
+
+void bgi_clone_and_bgi_unshare_test() {
+    printf("(TESTING) bgi_clone_and_bgi_unshare_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    const char *testcases[] = {
+        "0",
+        "-1",
+        "123456789123456789.987654321",
+        "-0.000001",
+    };
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(const char*); i++) {
+        BigInt *bi = bgi_init(testcases[i]);
+        sprintf(msg, "TESTCASE FAIL: index %zu: bi cannot be NULL", i);
+        bgi_assert(bi != NULL, msg);
+
+        // clones share the digits of bi
+        BigInt *copy = bgi_clone(bi);
+        sprintf(msg, "TESTCASE FAIL: index %zu: copy should share the digits of bi", i);
+        bgi_assert(copy != NULL && copy->numeric == bi->numeric && copy->decimal == bi->decimal, msg);
+        bgi_assert(bi->numeric->refcount == 2 && bi->decimal->refcount == 2, msg);
+
+        // the copy keeps the digits alive after bi is freed
+        const char *text = bgi_get_text(bi);
+        bgi_free(bi);
+        const char *copy_text = bgi_get_text(copy);
+        sprintf(msg, "TESTCASE FAIL: index %zu: expect %s: real %s", i, text, copy_text);
+        bgi_assert(strcmp(text, copy_text) == 0, msg);
+
+        // unshare copies the digits only when they have another owner
+        BigInt *copy2 = bgi_clone(copy);
+        bgi_unshare(copy2);
+        sprintf(msg, "TESTCASE FAIL: index %zu: copy2 should own its digits", i);
+        bgi_assert(copy2->status_code == BGI_OK && copy2->numeric != copy->numeric && copy2->decimal != copy->decimal, msg);
+        bgi_assert(copy->numeric->refcount == 1 && copy2->numeric->refcount == 1, msg);
+
+        List *numeric = copy->numeric;
+        bgi_unshare(copy);
+        sprintf(msg, "TESTCASE FAIL: index %zu: unshare should not copy digits with a single owner", i);
+        bgi_assert(copy->numeric == numeric, msg);
+
+        list_append(copy2->numeric, 1);
+        sprintf(msg, "TESTCASE FAIL: index %zu: modifying copy2 should not change copy", i);
+        bgi_assert(list_len(copy2->numeric) == list_len(copy->numeric) + 1, msg);
+
+        bgi_free_text(text);
+        bgi_free_text(copy_text);
+        bgi_free(copy);
+        bgi_free(copy2);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    printf("(TESTING) bgi_clone_and_bgi_unshare_test (COMPLETED)\n\n");
+}
+
+typedef struct {
+    const BigInt *bi1;
+    const BigInt *bi2;
+    const char *expect;
+    bool ok;
+} SharedOperandsTask;
+
+static void *shared_operands_worker(void *arg) {
+    SharedOperandsTask *task = (SharedOperandsTask*)arg;
+    task->ok = true;
+    for (int i = 0; i < 200; i++) {
+        BigInt *sum     = bgi_add(task->bi1, task->bi2);
+        BigInt *product = bgi_mult(sum, task->bi2);
+        BigInt *result  = bgi_sub(product, task->bi1);
+        const char *text = bgi_get_text(result);
+        if (text == NULL || strcmp(text, task->expect) != 0) {
+            task->ok = false;
+        }
+        bgi_free_text(text);
+        bgi_free(sum);
+        bgi_free(product);
+        bgi_free(result);
+    }
+    return NULL;
+}
+
+void bgi_shared_operands_test() {
+    printf("(TESTING) bgi_shared_operands_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        const char *n1;
+        const char *n2;
+        const char *expect; // (n1 + n2) * n2 - n1
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.n1="-123456789.5", .n2="987654321"      , .expect="+853528426306965401"},
+        (Testcase){.n1="2"           , .n2="-3.25"          , .expect="+2.0625"},
+        (Testcase){.n1="-1"          , .n2="-1"             , .expect="+3"},
+    };
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        BigInt *bi1 = bgi_init(tc.n1);
+        BigInt *bi2 = bgi_init(tc.n2);
+        sprintf(msg, "TESTCASE FAIL: index %zu: operands cannot be NULL", i);
+        bgi_assert(bi1 != NULL && bi2 != NULL, msg);
+
+        const char *text1 = bgi_get_text(bi1);
+        const char *text2 = bgi_get_text(bi2);
+
+        // the same operands are read by every task at once
+        SharedOperandsTask tasks[4];
+        for (size_t j = 0; j < 4; j++) {
+            tasks[j] = (SharedOperandsTask){.bi1=bi1, .bi2=bi2, .expect=tc.expect};
+        }
+#ifdef BIGINT_THREADS_ENABLED
+        pthread_t threads[4];
+        for (size_t j = 0; j < 4; j++) {
+            pthread_create(&threads[j], NULL, shared_operands_worker, &tasks[j]);
+        }
+        for (size_t j = 0; j < 4; j++) {
+            pthread_join(threads[j], NULL);
+        }
+#else
+        for (size_t j = 0; j < 4; j++) {
+            shared_operands_worker(&tasks[j]);
+        }
+#endif
+
+        for (size_t j = 0; j < 4; j++) {
+            sprintf(msg, "TESTCASE FAIL: index %zu: task %zu: expect %s", i, j, tc.expect);
+            bgi_assert(tasks[j].ok, msg);
+        }
+
+        const char *after1 = bgi_get_text(bi1);
+        const char *after2 = bgi_get_text(bi2);
+        sprintf(msg, "TESTCASE FAIL: index %zu: operands should not change: %s %s -> %s %s", i, text1, text2, after1, after2);
+        bgi_assert(strcmp(text1, after1) == 0 && strcmp(text2, after2) == 0, msg);
+
+        bgi_free_text(text1);
+        bgi_free_text(text2);
+        bgi_free_text(after1);
+        bgi_free_text(after2);
+        bgi_free(bi1);
+        bgi_free(bi2);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    printf("(TESTING) bgi_shared_operands_test (COMPLETED)\n\n");
+}
+
+void bgi_scratch_test() {
+    printf("(TESTING) bgi_scratch_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        const char *n1;
+        const char *n2;
+        const char *i1; // integer operands for the bitwise kernels
+        const char *i2;
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.n1="123456789012345678901234567890.123", .n2="-98765432109876543210.5", .i1="123456789012345678901234567890", .i2="-98765432109876543210"},
+        (Testcase){.n1="-7"                                , .n2="3"                     , .i1="-7"                            , .i2="3"},
+        (Testcase){.n1="0.000001"                          , .n2="1000000000000"         , .i1="0"                             , .i2="1000000000000"},
+    };
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        BigInt *bi1 = bgi_init(tc.n1);
+        BigInt *bi2 = bgi_init(tc.n2);
+        BigInt *int1 = bgi_init(tc.i1);
+        BigInt *int2 = bgi_init(tc.i2);
+
+        // the first round grows the scratch blocks, later rounds reuse them
+        size_t size = 0;
+        for (size_t round = 0; round < 3; round++) {
+            BigInt *results[] = {
+                bgi_mult(bi1, bi2),
+                bgi_div(bi1, bi2, 50),
+                bgi_add_ui(bi1, 99),
+                bgi_xor(int1, int2),
+                bgi_shl(int1, 100),
+            };
+            for (size_t j = 0; j < sizeof(results)/sizeof(BigInt*); j++) {
+                sprintf(msg, "TESTCASE FAIL: index %zu: result %zu cannot be NULL", i, j);
+                bgi_assert(results[j] != NULL && results[j]->status_code == BGI_OK, msg);
+                bgi_free(results[j]);
+            }
+
+            sprintf(msg, "TESTCASE FAIL: index %zu: round %zu: scratch size changed from %zu to %zu", i, round, size, bgi_scratch_size());
+            bgi_assert(round == 0 || bgi_scratch_size() == size, msg);
+            size = bgi_scratch_size();
+        }
+
+        sprintf(msg, "TESTCASE FAIL: index %zu: scratch size should not be 0", i);
+        bgi_assert(size > 0, msg);
+
+        bgi_scratch_free();
+        sprintf(msg, "TESTCASE FAIL: index %zu: scratch size should be 0 after bgi_scratch_free", i);
+        bgi_assert(bgi_scratch_size() == 0, msg);
+
+        bgi_free(bi1);
+        bgi_free(bi2);
+        bgi_free(int1);
+        bgi_free(int2);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    printf("(TESTING) bgi_scratch_test (COMPLETED)\n\n");
+}
+
+typedef struct {
+    BgiAccumulator *acc;
+    const char **values;
+    size_t values_len;
+    bool subtract;
+} AccumulatorTask;
+
+static void *accumulator_worker(void *arg) {
+    AccumulatorTask *task = (AccumulatorTask*)arg;
+    BigInt *values[8];
+    for (size_t j = 0; j < task->values_len; j++) {
+        values[j] = bgi_init(task->values[j]);
+    }
+    for (size_t round = 0; round < 25; round++) {
+        for (size_t j = 0; j < task->values_len; j++) {
+            if (task->subtract) {
+                bgi_accumulator_sub(task->acc, values[j]);
+            } else {
+                bgi_accumulator_add(task->acc, values[j]);
+            }
+        }
+    }
+    for (size_t j = 0; j < task->values_len; j++) {
+        bgi_free(values[j]);
+    }
+    return NULL;
+}
+
+void bgi_accumulator_test() {
+    printf("(TESTING) bgi_accumulator_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        const char *values[8];
+        size_t values_len;
+        size_t stripes;
+        bool subtract;
+        const char *expect; // 4 tasks x 25 rounds over the values
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.values={"1.5", "-2.25", "100"}     , .values_len=3, .stripes=0, .subtract=false, .expect="+9925"},
+        (Testcase){.values={"-0.001", "-999999999999"} , .values_len=2, .stripes=2, .subtract=false, .expect="-99999999999900.1"},
+        (Testcase){.values={"5", "-5"}                 , .values_len=2, .stripes=1, .subtract=false, .expect="+0"},
+        (Testcase){.values={"0.75", "-0.5", "9.99"}    , .values_len=3, .stripes=3, .subtract=true , .expect="-1024"},
+    };
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        BgiAccumulator *acc = bgi_accumulator_init(tc.stripes);
+        sprintf(msg, "TESTCASE FAIL: index %zu: accumulator cannot be NULL", i);
+        bgi_assert(acc != NULL && acc->status_code == BGI_OK, msg);
+
+        AccumulatorTask tasks[4];
+        for (size_t j = 0; j < 4; j++) {
+            tasks[j] = (AccumulatorTask){.acc=acc, .values=tc.values, .values_len=tc.values_len, .subtract=tc.subtract};
+        }
+#ifdef BIGINT_THREADS_ENABLED
+        pthread_t threads[4];
+        for (size_t j = 0; j < 4; j++) {
+            pthread_create(&threads[j], NULL, accumulator_worker, &tasks[j]);
+        }
+        for (size_t j = 0; j < 4; j++) {
+            pthread_join(threads[j], NULL);
+        }
+#else
+        for (size_t j = 0; j < 4; j++) {
+            accumulator_worker(&tasks[j]);
+        }
+#endif
+
+        BigInt *total = bgi_accumulator_snapshot(acc);
+        const char *text = bgi_get_text(total);
+        sprintf(msg, "TESTCASE FAIL: index %zu: expect %s, got %s", i, tc.expect, text);
+        bgi_assert(text != NULL && strcmp(text, tc.expect) == 0, msg);
+
+        bgi_free_text(text);
+        bgi_free(total);
+        bgi_accumulator_free(acc);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    printf("(TESTING) bgi_accumulator_test (COMPLETED)\n\n");
+}
+
+void bgi_parse_many_and_bgi_format_many_test() {
+    printf("(TESTING) bgi_parse_many_and_bgi_format_many_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    const char *texts[] = {
+        "123456789012345678901234567890", "-0.50", "0001", "", "12a", "+7.25",
+        "-99999999999999999999.000000001", "0", "-0", "3.", "42", "-1",
+    };
+    const char *expects[] = {
+        "+123456789012345678901234567890", "-0.50", "+1", NULL, NULL, "+7.25",
+        "-99999999999999999999.000000001", "+0", "+0", NULL, "+42", "-1",
+    };
+    size_t n = sizeof(texts)/sizeof(char*);
+
+    typedef struct {
+        size_t nthreads;
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.nthreads=0},
+        (Testcase){.nthreads=1},
+        (Testcase){.nthreads=3},
+        (Testcase){.nthreads=64},
+    };
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        BigInt *parsed[sizeof(texts)/sizeof(char*)];
+        const char *formatted[sizeof(texts)/sizeof(char*)];
+
+        size_t ok = bgi_parse_many(texts, n, parsed, tc.nthreads);
+        sprintf(msg, "TESTCASE FAIL: index %zu: expect 9 parsed values, got %zu", i, ok);
+        bgi_assert(ok == 9, msg);
+
+        char *arena = bgi_format_many(parsed, n, formatted, tc.nthreads);
+        sprintf(msg, "TESTCASE FAIL: index %zu: arena cannot be NULL", i);
+        bgi_assert(arena != NULL, msg);
+
+        for (size_t j = 0; j < n; j++) {
+            sprintf(msg, "TESTCASE FAIL: index %zu: text '%s': expect %s, got %s", i, texts[j],
+                expects[j] ? expects[j] : "NULL", formatted[j] ? formatted[j] : "NULL");
+            if (expects[j] == NULL) {
+                bgi_assert(formatted[j] == NULL && parsed[j]->status_code == BGI_INVALID_TEXT_VALUE, msg);
+            } else {
+                bgi_assert(formatted[j] != NULL && strcmp(formatted[j], expects[j]) == 0, msg);
+            }
+            bgi_free(parsed[j]);
+        }
+
+        free(arena);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    printf("(TESTING) bgi_parse_many_and_bgi_format_many_test (COMPLETED)\n\n");
+}
+
+void bgi_async_test() {
+    printf("(TESTING) bgi_async_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        const char *n1;
+        const char *n2;
+        bool div;
+        size_t digits;
+        const char *expect;
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.n1="123456789", .n2="-987654321"     , .div=false, .digits=0 , .expect="-121932631112635269"},
+        (Testcase){.n1="-1.5"     , .n2="0.0003"         , .div=true , .digits=5 , .expect="-5000"},
+        (Testcase){.n1="22"       , .n2="7"              , .div=true , .digits=10, .expect="+3.1428571428"},
+        (Testcase){.n1="0"        , .n2="12345.678"      , .div=false, .digits=0 , .expect="+0"},
+    };
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        BigInt *bi1 = bgi_init(tc.n1);
+        BigInt *bi2 = bgi_init(tc.n2);
+        BgiTask *task = tc.div ? bgi_async_div(bi1, bi2, tc.digits) : bgi_async_mult(bi1, bi2);
+
+        // the task keeps its own references to the operands
+        bgi_free(bi1);
+        bgi_free(bi2);
+
+        sprintf(msg, "TESTCASE FAIL: index %zu: task cannot be NULL", i);
+        bgi_assert(task != NULL, msg);
+
+        BigInt *result = bgi_task_wait(task);
+        const char *text = bgi_get_text(result);
+        sprintf(msg, "TESTCASE FAIL: index %zu: expect %s, got %s", i, tc.expect, text);
+        bgi_assert(text != NULL && strcmp(text, tc.expect) == 0, msg);
+
+        sprintf(msg, "TESTCASE FAIL: index %zu: finished task should be done with full progress", i);
+        bgi_assert(bgi_task_poll(task) && bgi_task_timed_wait(task, 0) && bgi_task_progress(task) == 1.0, msg);
+
+        sprintf(msg, "TESTCASE FAIL: index %zu: result is only handed out once", i);
+        bgi_assert(bgi_task_wait(task) == NULL, msg);
+
+        bgi_free_text(text);
+        bgi_free(result);
+        bgi_task_free(task);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    // a cancelled task either stops at a checkpoint or had already finished
+    char *digits = (char*)malloc(30001);
+    memset(digits, '7', 30000);
+    digits[30000] = '\0';
+    BigInt *big = bgi_init(digits);
+    BgiTask *task = bgi_async_mult(big, big);
+    bgi_task_cancel(task);
+    BigInt *result = bgi_task_wait(task);
+    sprintf(msg, "TESTCASE FAIL: cancelled task should be cancelled or ok, got %s", bgi_get_status_msg(result));
+    bgi_assert(result != NULL && (result->status_code == BGI_CANCELLED || result->status_code == BGI_OK), msg);
+    bgi_free(result);
+    bgi_task_free(task);
+    bgi_free(big);
+    free(digits);
+    printf("TESTCASES (%zu) PASSED...\n", sizeof(testcases)/sizeof(Testcase));
+
+#ifdef BIGINT_THREADS_ENABLED
+    // a karatsuba sized multiplication reports progress before it is done
+    char *digits1 = (char*)malloc(200001);
+    char *digits2 = (char*)malloc(200001);
+    for (size_t i = 0; i < 200000; i++) {
+        digits1[i] = '1' + (char)(i % 9);
+        digits2[i] = '9' - (char)(i % 7);
+    }
+    digits1[200000] = digits2[200000] = '\0';
+    BigInt *big1 = bgi_init(digits1);
+    BigInt *big2 = bgi_init(digits2);
+    task = bgi_async_mult(big1, big2);
+    // only values below 1 count, a finished task reports 1 anyway
+    double seen = 0;
+    while (!bgi_task_timed_wait(task, 1)) {
+        double progress = bgi_task_progress(task);
+        if (progress < 1 && progress > seen) {
+            seen = progress;
+        }
+    }
+    sprintf(msg, "TESTCASE FAIL: running karatsuba task should report progress, saw %f", seen);
+    bgi_assert(seen > 0, msg);
+    result = bgi_task_wait(task);
+    sprintf(msg, "TESTCASE FAIL: karatsuba task failed: %s", bgi_get_status_msg(result));
+    bgi_assert(result != NULL && result->status_code == BGI_OK, msg);
+    bgi_free(result);
+    bgi_task_free(task);
+    bgi_free(big1);
+    bgi_free(big2);
+    free(digits1);
+    free(digits2);
+    printf("TESTCASES (%zu) PASSED...\n", sizeof(testcases)/sizeof(Testcase) + 1);
+#endif
+
+    bgi_executor_shutdown();
+
+    printf("(TESTING) bgi_async_test (COMPLETED)\n\n");
+}
+
+void bgi_expr_test() {
+    printf("(TESTING) bgi_expr_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        const char *a;
+        const char *b;
+        const char *c;
+        const char *d;
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.a="12.5"                 , .b="-3"         , .c="7.25"  , .d="100"},
+        (Testcase){.a="-999999999999.999"    , .b="0.001"      , .c="-0.001", .d="-0.000001"},
+        (Testcase){.a="0"                    , .b="123"        , .c="456"   , .d="0"},
+        (Testcase){.a="98765432109876543210" , .b="1.50"       , .c="2"     , .d="-12345678901234567890.5"},
+    };
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        BigInt *a = bgi_init(tc.a);
+        BigInt *b = bgi_init(tc.b);
+        BigInt *c = bgi_init(tc.c);
+        BigInt *d = bgi_init(tc.d);
+
+        BgiExpr *expr = bgi_expr_init();
+        size_t ea = bgi_expr_value(expr, a);
+        size_t eb = bgi_expr_value(expr, b);
+        size_t ec = bgi_expr_value(expr, c);
+        size_t ed = bgi_expr_value(expr, d);
+
+        // a*b + a*c - d, rewritten to a*(b+c) - d
+        size_t ab = bgi_expr_mult(expr, ea, eb);
+        size_t f1 = bgi_expr_sub(expr, bgi_expr_add(expr, ab, bgi_expr_mult(expr, ea, ec)), ed);
+
+        // (a*b - d) - (c + a*b) + (d - c), a chain of sums over a shared product
+        size_t ab2 = bgi_expr_mult(expr, eb, ea);
+        size_t f2 = bgi_expr_add(expr, bgi_expr_sub(expr, bgi_expr_sub(expr, ab2, ed), bgi_expr_add(expr, ec, ab2)), bgi_expr_sub(expr, ed, ec));
+
+        sprintf(msg, "TESTCASE FAIL: index %zu: a*b should be stored once", i);
+        bgi_assert(ab == ab2, msg);
+
+        BigInt *ab_e  = bgi_mult(a, b);
+        BigInt *ac_e  = bgi_mult(a, c);
+        BigInt *s1_e  = bgi_add(ab_e, ac_e);
+        BigInt *f1_e  = bgi_sub(s1_e, d);
+        BigInt *t1_e  = bgi_sub(ab_e, d);
+        BigInt *t2_e  = bgi_add(c, ab_e);
+        BigInt *t3_e  = bgi_sub(d, c);
+        BigInt *t4_e  = bgi_sub(t1_e, t2_e);
+        BigInt *f2_e  = bgi_add(t4_e, t3_e);
+
+        size_t roots[]    = {f1, f2, ab, ea};
+        BigInt *eagers[]  = {f1_e, f2_e, ab_e, a};
+        for (size_t j = 0; j < sizeof(roots)/sizeof(size_t); j++) {
+            BigInt *lazy = bgi_expr_eval(expr, roots[j]);
+            const char *lazy_text  = bgi_get_text(lazy);
+            const char *eager_text = bgi_get_text(eagers[j]);
+            sprintf(msg, "TESTCASE FAIL: index %zu: root %zu: expect %s, got %s", i, j, eager_text, lazy_text);
+            bgi_assert(lazy_text != NULL && strcmp(lazy_text, eager_text) == 0, msg);
+            bgi_free_text(lazy_text);
+            bgi_free_text(eager_text);
+            bgi_free(lazy);
+        }
+
+        bgi_expr_free(expr);
+        BigInt *all[] = {a, b, c, d, ab_e, ac_e, s1_e, f1_e, t1_e, t2_e, t3_e, t4_e, f2_e};
+        for (size_t j = 0; j < sizeof(all)/sizeof(BigInt*); j++) {
+            bgi_free(all[j]);
+        }
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    printf("(TESTING) bgi_expr_test (COMPLETED)\n\n");
+}
+
+void bgi_threshold_test() {
+    printf("(TESTING) bgi_threshold_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        size_t int1;
+        size_t dec1;
+        size_t int2;
+        size_t dec2;
+        bool negative;
+        bool square;
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.int1=40 , .dec1=0 , .int2=40 , .dec2=0 , .negative=false, .square=false},
+        (Testcase){.int1=97 , .dec1=13, .int2=61 , .dec2=5 , .negative=true , .square=false},
+        (Testcase){.int1=300, .dec1=0 , .int2=9  , .dec2=0 , .negative=false, .square=false},
+        (Testcase){.int1=11 , .dec1=4 , .int2=250, .dec2=50, .negative=true , .square=false},
+        (Testcase){.int1=128, .dec1=0 , .int2=0  , .dec2=0 , .negative=false, .square=true},
+        (Testcase){.int1=77 , .dec1=33, .int2=0  , .dec2=0 , .negative=true , .square=true},
+    };
+
+    size_t thresholds[] = {4, 5, 7, 16, 33};
+    uint64_t seed = 12345;
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        // digits of 9s and random digits, 9s give the largest column sums
+        char text1[1000] = {0};
+        char text2[1000] = {0};
+        char *texts[]   = {text1, text2};
+        size_t ints[]   = {tc.int1, tc.int2};
+        size_t decs[]   = {tc.dec1, tc.dec2};
+        for (size_t t = 0; t < 2; t++) {
+            char *p = texts[t];
+            if (t == 0 && tc.negative) {
+                *p++ = '-';
+            }
+            for (size_t j = 0; j < ints[t] + decs[t]; j++) {
+                if (j == ints[t]) {
+                    *p++ = '.';
+                }
+                seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+                *p++ = (i % 2 == 0 && j < 20) ? '9' : '0' + (char)((seed >> 33) % 10);
+            }
+        }
+
+        BigInt *bi1 = bgi_init(text1);
+        BigInt *bi2 = tc.square ? bgi_clone(bi1) : bgi_init(text2);
+
+        bgi_set_threshold(BGI_THRESHOLD_MULT_KARATSUBA, SIZE_MAX);
+        bgi_set_threshold(BGI_THRESHOLD_SQR_KARATSUBA, SIZE_MAX);
+        BigInt *expect = bgi_mult(bi1, bi2);
+        const char *expect_text = bgi_get_text(expect);
+
+        for (size_t j = 0; j < sizeof(thresholds)/sizeof(size_t); j++) {
+            bgi_set_threshold(BGI_THRESHOLD_MULT_KARATSUBA, thresholds[j]);
+            bgi_set_threshold(BGI_THRESHOLD_SQR_KARATSUBA, thresholds[j]);
+
+            sprintf(msg, "TESTCASE FAIL: index %zu: threshold should be %zu, got %zu", i, thresholds[j], bgi_get_threshold(BGI_THRESHOLD_MULT_KARATSUBA));
+            bgi_assert(bgi_get_threshold(BGI_THRESHOLD_MULT_KARATSUBA) == thresholds[j], msg);
+
+            BigInt *bi3 = bgi_mult(bi1, bi2);
+            const char *text = bgi_get_text(bi3);
+            sprintf(msg, "TESTCASE FAIL: index %zu: threshold %zu: results differ", i, thresholds[j]);
+            bgi_assert(text != NULL && strcmp(text, expect_text) == 0, msg);
+            bgi_free_text(text);
+            bgi_free(bi3);
+        }
+
+        bgi_free_text(expect_text);
+        bgi_free(expect);
+        bgi_free(bi1);
+        bgi_free(bi2);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    // 0 restores the compiled in values, too small values are raised
+    bgi_set_threshold(BGI_THRESHOLD_MULT_KARATSUBA, 0);
+    bgi_set_threshold(BGI_THRESHOLD_SQR_KARATSUBA, 1);
+    sprintf(msg, "TESTCASE FAIL: threshold should be %d after reset", BGI_MULT_KARATSUBA_THRESHOLD);
+    bgi_assert(bgi_get_threshold(BGI_THRESHOLD_MULT_KARATSUBA) == BGI_MULT_KARATSUBA_THRESHOLD, msg);
+    sprintf(msg, "TESTCASE FAIL: threshold should be raised above 1");
+    bgi_assert(bgi_get_threshold(BGI_THRESHOLD_SQR_KARATSUBA) > 1, msg);
+    bgi_set_threshold(BGI_THRESHOLD_SQR_KARATSUBA, 0);
+
+    printf("(TESTING) bgi_threshold_test (COMPLETED)\n\n");
+}
+
+void bgi_div_newton_test() {
+    printf("(TESTING) bgi_div_newton_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        const char *n1; // NULL gives int1.dec1 random digits
+        const char *n2; // NULL gives int2.dec2 random digits
+        size_t int1;
+        size_t dec1;
+        size_t int2;
+        size_t dec2;
+        size_t digits;
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.n1="1"  , .n2="0.999999999999", .digits=40},
+        (Testcase){.n1="1000000000000000000000000000000", .n2="99999999", .digits=5},
+        (Testcase){.n1="9999999999999999999800000000000000000001", .n2="99999999999999999999", .digits=0},
+        (Testcase){.n1="9999999999999999999800000000000000000000", .n2="99999999999999999999", .digits=0},
+        (Testcase){.n1="-22", .n2="7.000000000000000000001", .digits=60},
+        (Testcase){.n1=NULL , .n2=NULL, .int1=300, .dec1=0 , .int2=150, .dec2=0 , .digits=0},
+        (Testcase){.n1=NULL , .n2=NULL, .int1=257, .dec1=31, .int2=64 , .dec2=17, .digits=100},
+        (Testcase){.n1=NULL , .n2=NULL, .int1=40 , .dec1=0 , .int2=120, .dec2=5 , .digits=200},
+        (Testcase){.n1=NULL , .n2=NULL, .int1=500, .dec1=0 , .int2=499, .dec2=0 , .digits=3},
+    };
+
+    uint64_t seed = 54321;
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        char text1[1000] = {0};
+        char text2[1000] = {0};
+        char *texts[]   = {text1, text2};
+        size_t ints[]   = {tc.int1, tc.int2};
+        size_t decs[]   = {tc.dec1, tc.dec2};
+        for (size_t t = 0; t < 2; t++) {
+            char *p = texts[t];
+            for (size_t j = 0; j < ints[t] + decs[t]; j++) {
+                if (j == ints[t]) {
+                    *p++ = '.';
+                }
+                seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+                *p++ = j == 0 ? '1' + (char)((seed >> 33) % 9) : '0' + (char)((seed >> 33) % 10);
+            }
+        }
+
+        BigInt *bi1 = bgi_init(tc.n1 != NULL ? tc.n1 : text1);
+        BigInt *bi2 = bgi_init(tc.n2 != NULL ? tc.n2 : text2);
+        sprintf(msg, "TESTCASE FAIL: index %zu: operands should be valid", i);
+        bgi_assert(bi1 != NULL && bi2 != NULL && bi1->status_code == BGI_OK && bi2->status_code == BGI_OK, msg);
+
+        bgi_set_threshold(BGI_THRESHOLD_DIV_NEWTON, SIZE_MAX);
+        BigInt *expect = bgi_div(bi1, bi2, tc.digits);
+        const char *expect_text = bgi_get_text(expect);
+
+        bgi_set_threshold(BGI_THRESHOLD_DIV_NEWTON, 4);
+        BigInt *bi3 = bgi_div(bi1, bi2, tc.digits);
+        const char *text = bgi_get_text(bi3);
+        sprintf(msg, "TESTCASE FAIL: index %zu: expect %.60s, got %.60s", i, expect_text, text);
+        bgi_assert(text != NULL && expect_text != NULL && strcmp(text, expect_text) == 0, msg);
+
+        bgi_free_text(text);
+        bgi_free_text(expect_text);
+        bgi_free(bi3);
+        bgi_free(expect);
+        bgi_free(bi1);
+        bgi_free(bi2);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    bgi_set_threshold(BGI_THRESHOLD_DIV_NEWTON, 0);
+    sprintf(msg, "TESTCASE FAIL: threshold should be %d after reset", BGI_DIV_NEWTON_THRESHOLD);
+    bgi_assert(bgi_get_threshold(BGI_THRESHOLD_DIV_NEWTON) == BGI_DIV_NEWTON_THRESHOLD, msg);
+
+    printf("(TESTING) bgi_div_newton_test (COMPLETED)\n\n");
+}
+
+void bgi_stats_test() {
+    printf("(TESTING) bgi_stats_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        BgiStatsOp op;
+        uint64_t calls;
+        size_t bucket;   // histogram bucket that holds all calls
+    } Testcase;
+
+    // texts of 5, 50 and 500 digits, then 8 parses of 50 digits on worker threads
+    Testcase testcases[] = {
+        (Testcase){.op=BGI_STATS_INIT   , .calls=11, .bucket=1},
+        (Testcase){.op=BGI_STATS_MULT   , .calls=1 , .bucket=2},
+        (Testcase){.op=BGI_STATS_CLONE  , .calls=2 , .bucket=2},
+        (Testcase){.op=BGI_STATS_GET_TEXT, .calls=1, .bucket=2},
+        (Testcase){.op=BGI_STATS_DIV    , .calls=0 , .bucket=0},
+    };
+
+    char text[501] = {0};
+    memset(text, '7', 500);
+
+    bgi_stats_reset();
+
+    BigInt *small  = bgi_init("12345");
+    BigInt *middle = bgi_init(text + 450);
+    BigInt *large  = bgi_init(text);
+    BigInt *sq     = bgi_mult(large, middle);
+    BigInt *copy1  = bgi_clone(sq);
+    BigInt *copy2  = bgi_clone(large);
+    bgi_free_text(bgi_get_text(large));
+
+    const char *texts[8];
+    BigInt *parsed[8];
+    for (size_t i = 0; i < 8; i++) {
+        texts[i] = text + 450;
+    }
+    bgi_parse_many(texts, 8, parsed, 4);
+
+    BgiStats stats;
+    bgi_stats_snapshot(&stats);
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+#ifdef BIGINT_STATS_ENABLED
+        BgiStatsOpCounters counters = stats.ops[tc.op];
+        sprintf(msg, "TESTCASE FAIL: index %zu: %s calls should be %llu, got %llu", i, bgi_stats_op_name(tc.op), (unsigned long long)tc.calls, (unsigned long long)counters.calls);
+        bgi_assert(counters.calls == tc.calls, msg);
+
+        uint64_t histogram = 0;
+        for (size_t j = 0; j < BGI_STATS_BUCKETS; j++) {
+            histogram += counters.digits[j];
+        }
+        sprintf(msg, "TESTCASE FAIL: index %zu: %s histogram should hold every call", i, bgi_stats_op_name(tc.op));
+        bgi_assert(histogram == tc.calls && (tc.calls == 0 || counters.digits[tc.bucket] > 0), msg);
+
+        if (tc.op == BGI_STATS_INIT) {
+            sprintf(msg, "TESTCASE FAIL: index %zu: bgi_init should have one call per size", i);
+            bgi_assert(counters.digits[0] == 1 && counters.digits[1] == 9 && counters.digits[2] == 1, msg);
+        }
+#else
+        sprintf(msg, "TESTCASE FAIL: index %zu: %s should not be counted", i, bgi_stats_op_name(tc.op));
+        bgi_assert(stats.ops[tc.op].calls == 0, msg);
+#endif
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+#ifdef BIGINT_STATS_ENABLED
+    sprintf(msg, "TESTCASE FAIL: allocations should be counted, got %llu allocs %llu bytes %llu reallocs", (unsigned long long)stats.allocs, (unsigned long long)stats.bytes_allocated, (unsigned long long)stats.list_reallocs);
+    bgi_assert(stats.allocs > 0 && stats.bytes_allocated >= 500 && stats.list_reallocs > 0, msg);
+#endif
+
+    // a reset starts the counters from zero again
+    bgi_stats_reset();
+    bgi_stats_snapshot(&stats);
+    sprintf(msg, "TESTCASE FAIL: counters should be zero after reset");
+    bgi_assert(stats.ops[BGI_STATS_INIT].calls == 0 && stats.allocs == 0, msg);
+
+    BigInt *all[] = {small, middle, large, sq, copy1, copy2};
+    for (size_t i = 0; i < sizeof(all)/sizeof(BigInt*); i++) {
+        bgi_free(all[i]);
+    }
+    for (size_t i = 0; i < 8; i++) {
+        bgi_free(parsed[i]);
+    }
+
+    printf("(TESTING) bgi_stats_test (COMPLETED)\n\n");
+}
+
+typedef struct {
+    BgiTraceEvent events[16];
+    size_t len;
+} TraceLog;
+
+void trace_log_hook(const BgiTraceEvent *event, void *data) {
+    TraceLog *log = (TraceLog*)data;
+    if (log->len < sizeof(log->events)/sizeof(BgiTraceEvent)) {
+        log->events[log->len++] = *event;
+    }
+}
+
+void bgi_trace_test() {
+    printf("(TESTING) bgi_trace_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        const char *a;
+        const char *b;
+        bool square;
+        BgiTraceTier tier;
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.a="12.5"        , .b="-3"         , .square=false, .tier=BGI_TRACE_TIER_SCHOOLBOOK},
+        (Testcase){.a="123456789012", .b="98765432109", .square=false, .tier=BGI_TRACE_TIER_KARATSUBA},
+        (Testcase){.a="-1234567.891", .b=NULL         , .square=true , .tier=BGI_TRACE_TIER_KARATSUBA_SQR},
+    };
+
+    bgi_set_threshold(BGI_THRESHOLD_MULT_KARATSUBA, 8);
+    bgi_set_threshold(BGI_THRESHOLD_SQR_KARATSUBA, 8);
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        BigInt *bi1 = bgi_init(tc.a);
+        BigInt *bi2 = tc.square ? bgi_clone(bi1) : bgi_init(tc.b);
+
+        TraceLog log = {0};
+        bgi_trace_set_hook(trace_log_hook, &log);
+        BigInt *bi3 = bgi_mult(bi1, bi2);
+        bgi_trace_set_hook(NULL, NULL);
+
+#ifdef BIGINT_TRACE_ENABLED
+        sprintf(msg, "TESTCASE FAIL: index %zu: expect 2 events, got %zu", i, log.len);
+        bgi_assert(log.len == 2, msg);
+
+        BgiTraceEvent begin = log.events[0];
+        BgiTraceEvent end   = log.events[1];
+        sprintf(msg, "TESTCASE FAIL: index %zu: events should be the begin and end of bgi_mult", i);
+        bgi_assert(begin.op == BGI_STATS_MULT && begin.phase == BGI_TRACE_BEGIN && end.op == BGI_STATS_MULT && end.phase == BGI_TRACE_END, msg);
+
+        sprintf(msg, "TESTCASE FAIL: index %zu: lengths should be %zu and %zu, got %zu and %zu", i, bgi_probe_len(bi1), bgi_probe_len(bi2), begin.len1, begin.len2);
+        bgi_assert(begin.len1 == bgi_probe_len(bi1) && begin.len2 == bgi_probe_len(bi2) && end.time_ns >= begin.time_ns, msg);
+
+        sprintf(msg, "TESTCASE FAIL: index %zu: tier should be %s, got %s", i, bgi_trace_tier_name(tc.tier), bgi_trace_tier_name(end.tier));
+        bgi_assert(end.tier == tc.tier, msg);
+#else
+        sprintf(msg, "TESTCASE FAIL: index %zu: hook should not be called without BIGINT_TRACE_ENABLED", i);
+        bgi_assert(log.len == 0, msg);
+#endif
+
+        bgi_free(bi1);
+        bgi_free(bi2);
+        bgi_free(bi3);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    bgi_set_threshold(BGI_THRESHOLD_MULT_KARATSUBA, 0);
+    bgi_set_threshold(BGI_THRESHOLD_SQR_KARATSUBA, 0);
+
+    // replacing only the data sends the following events to the new data
+    TraceLog first = {0};
+    TraceLog second = {0};
+    BigInt *one = bgi_init("1");
+    bgi_trace_set_hook(trace_log_hook, &first);
+    bgi_free(bgi_add(one, one));
+    bgi_trace_set_hook(trace_log_hook, &second);
+    bgi_free(bgi_add(one, one));
+    bgi_trace_set_hook(trace_log_hook, &first);
+    bgi_free(bgi_add(one, one));
+    bgi_trace_set_hook(NULL, NULL);
+    bgi_free(one);
+#ifdef BIGINT_TRACE_ENABLED
+    sprintf(msg, "TESTCASE FAIL: events should follow the data set with the hook, got %zu and %zu", first.len, second.len);
+    bgi_assert(first.len == 4 && second.len == 2, msg);
+#endif
+
+    // the chrome trace file is a json array of begin and end events
+    const char *path = "bigint_trace_test.json";
+    bool opened = bgi_trace_chrome_open(path);
+#ifdef BIGINT_TRACE_ENABLED
+    sprintf(msg, "TESTCASE FAIL: %s should be opened", path);
+    bgi_assert(opened, msg);
+
+    BigInt *bi = bgi_init("123.45");
+    bgi_free_text(bgi_get_text(bi));
+    bgi_free(bi);
+    bgi_trace_chrome_close();
+
+    char json[4096] = {0};
+    FILE *file = fopen(path, "r");
+    size_t len = file != NULL ? fread(json, 1, sizeof(json) - 1, file) : 0;
+    if (file != NULL) {
+        fclose(file);
+    }
+    remove(path);
+
+    sprintf(msg, "TESTCASE FAIL: trace should be a json array with both operations, got %s", json);
+    bgi_assert(len > 0 && json[0] == '[' && strstr(json, "\n]\n") != NULL && strstr(json, "\"name\":\"bgi_init\",\"cat\":\"bigint\",\"ph\":\"B\"") != NULL && strstr(json, "\"name\":\"bgi_get_text\"") != NULL, msg);
+#else
+    sprintf(msg, "TESTCASE FAIL: %s should not be opened without BIGINT_TRACE_ENABLED", path);
+    bgi_assert(!opened, msg);
+#endif
+
+    printf("(TESTING) bgi_trace_test (COMPLETED)\n\n");
+}
+
+typedef struct {
+    size_t allocs;
+    size_t frees;
+    size_t live_bytes;
+} CountingHeap;
+
+void *counting_alloc(size_t size, void *data) {
+    CountingHeap *heap = (CountingHeap*)data;
+    heap->allocs++;
+    heap->live_bytes += size;
+    return malloc(size);
+}
+
+void *counting_realloc(void *ptr, size_t old_size, size_t new_size, void *data) {
+    CountingHeap *heap = (CountingHeap*)data;
+    heap->live_bytes += new_size - old_size;
+    return realloc(ptr, new_size);
+}
+
+void counting_free(void *ptr, size_t size, void *data) {
+    CountingHeap *heap = (CountingHeap*)data;
+    heap->frees++;
+    heap->live_bytes -= size;
+    free(ptr);
+}
+
+void bgi_set_allocator_test() {
+    printf("(TESTING) bgi_set_allocator_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        const char *a;
+        const char *b;
+        const char *expect;
+        bool thread; // installed as the thread allocator instead of the global one
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.a="12.5"                  , .b="-3"                    , .expect="-37.5"                                     , .thread=false},
+        (Testcase){.a="99999999999999999999"  , .b="99999999999999999999"  , .expect="+9999999999999999999800000000000000000001", .thread=false},
+        (Testcase){.a="-0.000123"             , .b="456789.1"              , .expect="-56.1850593"                               , .thread=true},
+    };
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        // scratch blocks made earlier came from the C allocator
+        bgi_scratch_free();
+
+        CountingHeap heap = {0};
+        BgiAllocator allocator = {.alloc=counting_alloc, .realloc=counting_realloc, .free=counting_free, .data=&heap};
+        if (tc.thread) {
+            bgi_set_thread_allocator(&allocator);
+        } else {
+            bgi_set_allocator(&allocator);
+        }
+
+        sprintf(msg, "TESTCASE FAIL: index %zu: bgi_get_allocator should return the installed allocator", i);
+        bgi_assert(bgi_get_allocator() == &allocator, msg);
+
+        BigInt *bi1 = bgi_init(tc.a);
+        BigInt *bi2 = bgi_init(tc.b);
+        BigInt *bi3 = bgi_mult(bi1, bi2);
+        BigInt *bi4 = bgi_clone(bi3);
+        const char *text = bgi_get_text(bi4);
+        const char *formatted = bgi_format(bi4, &(BgiFormat){.style=BGI_FORMAT_PLAIN, .plus=true});
+
+        sprintf(msg, "TESTCASE FAIL: index %zu: expect %s, got %s", i, tc.expect, text);
+        bgi_assert(text != NULL && strcmp(text, tc.expect) == 0, msg);
+        sprintf(msg, "TESTCASE FAIL: index %zu: expect formatted %s, got %s", i, tc.expect, formatted);
+        bgi_assert(formatted != NULL && strcmp(formatted, tc.expect) == 0, msg);
+
+        // objects go back to their own allocator after it is replaced
+        bgi_set_allocator(NULL);
+        bgi_set_thread_allocator(NULL);
+
+        sprintf(msg, "TESTCASE FAIL: index %zu: allocations should go through the allocator", i);
+        bgi_assert(heap.allocs > 0 && heap.live_bytes > 0, msg);
+
+        bgi_free(bi1);
+        bgi_free(bi2);
+        bgi_free(bi3);
+        bgi_free(bi4);
+        bgi_free_text(text);
+        bgi_free_text(formatted);
+        bgi_scratch_free();
+
+        sprintf(msg, "TESTCASE FAIL: index %zu: %zu allocs, %zu frees, %zu bytes still live", i, heap.allocs, heap.frees, heap.live_bytes);
+        bgi_assert(heap.allocs == heap.frees && heap.live_bytes == 0, msg);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    printf("(TESTING) bgi_set_allocator_test (COMPLETED)\n\n");
+}
+
+void bgi_export_and_bgi_import_test() {
+    printf("(TESTING) bgi_export_and_bgi_import_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        const char *text;
+        const char *expect;
+        size_t size;
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.text="0"                                   , .expect="+0"                                  , .size=4},
+        (Testcase){.text="-0.000"                              , .expect="+0"                                  , .size=4},
+        (Testcase){.text="7"                                   , .expect="+7"                                  , .size=8},
+        (Testcase){.text="-12.50"                              , .expect="-12.5"                               , .size=8},
+        (Testcase){.text="0.000000000123"                      , .expect="+0.000000000123"                     , .size=12},
+        (Testcase){.text="00999999999"                         , .expect="+999999999"                          , .size=8},
+        (Testcase){.text="1000000000"                          , .expect="+1000000000"                         , .size=12},
+        (Testcase){.text="-98765432109876543210.0123456789"    , .expect="-98765432109876543210.0123456789"    , .size=20},
+    };
+
+    BigInt *bis[sizeof(testcases)/sizeof(Testcase)];
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        bis[i] = bgi_init(tc.text);
+        size_t size = bgi_export(bis[i], NULL, 0);
+        sprintf(msg, "TESTCASE FAIL: index %zu: size should be %zu, got %zu", i, tc.size, size);
+        bgi_assert(size == tc.size, msg);
+
+        uint8_t buf[64] = {0};
+        sprintf(msg, "TESTCASE FAIL: index %zu: a buffer that is too small should be refused", i);
+        bgi_assert(bgi_export(bis[i], buf, size - 1) == 0, msg);
+        bgi_assert(bgi_export(bis[i], buf, sizeof(buf)) == size, msg);
+
+        size_t used = 0;
+        BigInt *bi = bgi_import(buf, size, &used);
+        const char *text = bgi_get_text(bi);
+        sprintf(msg, "TESTCASE FAIL: index %zu: expect %s (%zu bytes), got %s (%zu bytes)", i, tc.expect, size, text, used);
+        bgi_assert(text != NULL && strcmp(text, tc.expect) == 0 && used == size, msg);
+        bgi_free_text(text);
+        bgi_free(bi);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    // all values back to back
+    size_t n = sizeof(testcases)/sizeof(Testcase);
+    size_t total = bgi_export_many(bis, n, NULL, 0);
+    uint8_t *buf = (uint8_t*)malloc(total);
+    sprintf(msg, "TESTCASE FAIL: bgi_export_many should write %zu bytes", total);
+    bgi_assert(buf != NULL && bgi_export_many(bis, n, buf, total) == total, msg);
+
+    BigInt *out[sizeof(testcases)/sizeof(Testcase)];
+    size_t count = bgi_import_many(buf, total, out, n);
+    sprintf(msg, "TESTCASE FAIL: bgi_import_many should import %zu values, got %zu", n, count);
+    bgi_assert(count == n, msg);
+    for (size_t i = 0; i < n; i++) {
+        const char *text = bgi_get_text(out[i]);
+        sprintf(msg, "TESTCASE FAIL: index %zu: bulk import should be %s, got %s", i, testcases[i].expect, text);
+        bgi_assert(text != NULL && strcmp(text, testcases[i].expect) == 0, msg);
+        bgi_free_text(text);
+        bgi_free(out[i]);
+    }
+
+    // a cut off buffer keeps the values before the cut
+    count = bgi_import_many(buf, total - 1, out, n);
+    sprintf(msg, "TESTCASE FAIL: a cut off buffer should import %zu values, got %zu", n - 1, count);
+    bgi_assert(count == n - 1 && out[n-1]->status_code == BGI_INVALID_BINARY, msg);
+    for (size_t i = 0; i < n; i++) {
+        bgi_free(out[i]);
+    }
+    free(buf);
+
+    for (size_t i = 0; i < n; i++) {
+        bgi_free(bis[i]);
+    }
+
+    // version, flags, limb range, scale above the limb digits and cut off varints
+    uint8_t invalid[][8] = {
+        {2, 0, 0, 0},
+        {1, 2, 0, 0},
+        {1, 0, 0, 1, 0x00, 0xca, 0x9a, 0x3b},
+        {1, 0, 10, 1, 7, 0, 0, 0},
+        {1, 0, 0x80, 0x80},
+    };
+    size_t lens[] = {4, 4, 8, 8, 4};
+    for (size_t i = 0; i < sizeof(lens)/sizeof(size_t); i++) {
+        size_t used = 1;
+        BigInt *bi = bgi_import(invalid[i], lens[i], &used);
+        sprintf(msg, "TESTCASE FAIL: invalid index %zu: should give BGI_INVALID_BINARY", i);
+        bgi_assert(bi != NULL && bi->status_code == BGI_INVALID_BINARY && used == 0, msg);
+        bgi_free(bi);
+    }
+
+    printf("(TESTING) bgi_export_and_bgi_import_test (COMPLETED)\n\n");
+}
+
+void bgi_save_and_bgi_map_test() {
+    printf("(TESTING) bgi_save_and_bgi_map_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        const char *text;
+        const char *other;
+        const char *product;
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.text="0"                          , .other="12"     , .product="+0"},
+        (Testcase){.text="-12.5"                      , .other="4"      , .product="-50"},
+        (Testcase){.text="98765432109876543210.0625"  , .other="-0.5"   , .product="-49382716054938271605.03125"},
+        (Testcase){.text="0.000001"                   , .other="1000000", .product="+1"},
+    };
+
+    const char *path = "bigint_map_test.bgim";
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        BigInt *bi = bgi_init(tc.text);
+        sprintf(msg, "TESTCASE FAIL: index %zu: bgi_save should write %s", i, path);
+        bgi_assert(bgi_save(bi, path), msg);
+
+        BigInt *mapped   = bgi_map(path);
+        BigInt *unshared = bgi_map(path);
+        remove(path); // the mapping keeps the data alive
+        sprintf(msg, "TESTCASE FAIL: index %zu: bgi_map should succeed, got %s", i, mapped != NULL ? bgi_get_status_msg(mapped) : "NULL");
+        bgi_assert(mapped != NULL && mapped->status_code == BGI_OK, msg);
+
+        sprintf(msg, "TESTCASE FAIL: index %zu: mapped value should equal %s", i, tc.text);
+        bgi_assert(bgi_cmp(mapped, bi) == 0, msg);
+
+        // operand of an operation, then outliving its clone
+        BigInt *clone   = bgi_clone(mapped);
+        BigInt *other   = bgi_init(tc.other);
+        BigInt *product = bgi_mult(clone, other);
+        const char *text = bgi_get_text(product);
+        sprintf(msg, "TESTCASE FAIL: index %zu: expect %s, got %s", i, tc.product, text);
+        bgi_assert(text != NULL && strcmp(text, tc.product) == 0, msg);
+        bgi_free_text(text);
+        bgi_free(clone);
+
+        // the mapping is read only, bgi_unshare copies the digits before they
+        // are modified in place
+        bgi_unshare(unshared);
+        sprintf(msg, "TESTCASE FAIL: index %zu: bgi_unshare should copy mapped digits, got %s", i, bgi_get_status_msg(unshared));
+        bgi_assert(unshared->status_code == BGI_OK && !list_is_mapped(unshared->numeric) && !list_is_mapped(unshared->decimal), msg);
+        list_reverse(unshared->numeric);
+        list_append(unshared->decimal, 1);
+        sprintf(msg, "TESTCASE FAIL: index %zu: the mapped value should still be %s", i, tc.text);
+        bgi_assert(bgi_cmp(mapped, bi) == 0 && bgi_cmp(unshared, bi) != 0, msg);
+        bgi_free(unshared);
+
+        // growing a mapped list moves it to the heap, the file is never written
+        list_append(mapped->numeric, 7);
+        list_append(mapped->decimal, 3);
+        sprintf(msg, "TESTCASE FAIL: index %zu: mapped lists should grow", i);
+        bgi_assert(mapped->numeric->status_code == LIST_OK && list_get(mapped->numeric, list_len(mapped->numeric) - 1) == 7, msg);
+
+        bgi_free(mapped);
+        bgi_free(bi);
+        bgi_free(other);
+        bgi_free(product);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    // a file that bgi_save did not write
+    FILE *file = fopen(path, "wb");
+    fputs("12345678901234567890123456789", file);
+    fclose(file);
+    BigInt *bi = bgi_map(path);
+    remove(path);
+    sprintf(msg, "TESTCASE FAIL: a text file should give BGI_MAP_FAIL");
+    bgi_assert(bi != NULL && bi->status_code == BGI_MAP_FAIL, msg);
+    bgi_free(bi);
+
+    // headers that are right but digits bgi_save never writes
+    typedef struct {
+        const char *digits;
+        size_t numeric_len;
+        size_t decimal_len;
+        unsigned char sign;
+    } Foreign;
+
+    Foreign foreign[] = {
+        (Foreign){.digits="\x01\x00"    , .numeric_len=2, .decimal_len=0, .sign=1}, // leading zero
+        (Foreign){.digits="\x01\x05\x00", .numeric_len=1, .decimal_len=2, .sign=1}, // trailing zero
+        (Foreign){.digits="1"           , .numeric_len=1, .decimal_len=0, .sign=1}, // text digit
+        (Foreign){.digits="\x05\x0c"    , .numeric_len=0, .decimal_len=2, .sign=0}, // digit above 9
+        (Foreign){.digits=""            , .numeric_len=0, .decimal_len=0, .sign=0}, // negative zero
+    };
+
+    for (size_t i = 0; i < sizeof(foreign)/sizeof(Foreign); i++) {
+        unsigned char header[24] = {'B', 'G', 'I', 'M', 1, foreign[i].sign};
+        header[8]  = (unsigned char)foreign[i].numeric_len;
+        header[16] = (unsigned char)foreign[i].decimal_len;
+        file = fopen(path, "wb");
+        fwrite(header, 1, sizeof(header), file);
+        fwrite(foreign[i].digits, 1, foreign[i].numeric_len + foreign[i].decimal_len, file);
+        fclose(file);
+
+        bi = bgi_map(path);
+        remove(path);
+        sprintf(msg, "TESTCASE FAIL: index %zu: a file with non canonical digits should give BGI_MAP_FAIL", i);
+        bgi_assert(bi != NULL && bi->status_code == BGI_MAP_FAIL, msg);
+        bgi_free(bi);
+    }
+
+    bi = bgi_map("bigint_map_test_missing.bgim");
+    sprintf(msg, "TESTCASE FAIL: a missing file should give BGI_MAP_FAIL");
+    bgi_assert(bi != NULL && bi->status_code == BGI_MAP_FAIL, msg);
+    bgi_free(bi);
+
+    printf("(TESTING) bgi_save_and_bgi_map_test (COMPLETED)\n\n");
+}
+
+void bgi_file_arithmetic_test() {
+    printf("(TESTING) bgi_file_arithmetic_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        size_t int1;
+        size_t dec1;
+        bool neg1;
+        size_t int2;
+        size_t dec2;
+        bool neg2;
+        size_t budget;
+    } Testcase;
+
+    // small budgets split the operands in many blocks
+    Testcase testcases[] = {
+        (Testcase){.int1=0  , .dec1=0  , .neg1=false, .int2=5  , .dec2=0  , .neg2=true , .budget=0},
+        (Testcase){.int1=300, .dec1=0  , .neg1=false, .int2=290, .dec2=0  , .neg2=false, .budget=0},
+        (Testcase){.int1=250, .dec1=70 , .neg1=true , .int2=31 , .dec2=133, .neg2=false, .budget=0},
+        (Testcase){.int1=9  , .dec1=400, .neg1=false, .int2=200, .dec2=3  , .neg2=true , .budget=100},
+        (Testcase){.int1=700, .dec1=20 , .neg1=true , .int2=700, .dec2=20 , .neg2=true , .budget=1 << 20},
+    };
+
+    const char *path1 = "bigint_file_test_1.bgim";
+    const char *path2 = "bigint_file_test_2.bgim";
+    const char *out   = "bigint_file_test_out.bgim";
+    uint64_t seed = 777;
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        // runs of 9s make long carries, the last testcase compares equal values
+        char text1[1200] = {0};
+        char text2[1200] = {0};
+        char *texts[] = {text1, text2};
+        size_t ints[] = {tc.int1, tc.int2};
+        size_t decs[] = {tc.dec1, tc.dec2};
+        bool negs[]   = {tc.neg1, tc.neg2};
+        for (size_t t = 0; t < 2; t++) {
+            char *p = texts[t];
+            *p++ = negs[t] ? '-' : '+';
+            if (ints[t] == 0) {
+                *p++ = '0';
+            }
+            uint64_t digit_seed = i == 4 ? 99 : seed + t;
+            for (size_t j = 0; j < ints[t] + decs[t]; j++) {
+                if (j == ints[t]) {
+                    *p++ = '.';
+                }
+                digit_seed = digit_seed * 6364136223846793005ull + 1442695040888963407ull;
+                *p++ = (j % 50 < 20) ? '9' : '0' + (char)((digit_seed >> 33) % 10);
+            }
+        }
+        seed += 2;
+
+        BigInt *bi1 = bgi_init(text1);
+        BigInt *bi2 = bgi_init(text2);
+        bgi_save(bi1, path1);
+        bgi_save(bi2, path2);
+
+        int cmp = 2;
+        sprintf(msg, "TESTCASE FAIL: index %zu: bgi_file_cmp should be %d, got %d", i, bgi_cmp(bi1, bi2), cmp);
+        bgi_assert(bgi_file_cmp(path1, path2, tc.budget, &cmp) == BGI_OK, msg);
+        sprintf(msg, "TESTCASE FAIL: index %zu: bgi_file_cmp should be %d, got %d", i, bgi_cmp(bi1, bi2), cmp);
+        bgi_assert(cmp == bgi_cmp(bi1, bi2), msg);
+
+        BigIntStatusCode (*file_ops[])(const char*, const char*, const char*, size_t) = {bgi_file_add, bgi_file_sub, bgi_file_mult};
+        BigInt *(*memory_ops[])(const BigInt*, const BigInt*) = {bgi_add, bgi_sub, bgi_mult};
+        const char *names[] = {"add", "sub", "mult"};
+        for (size_t op = 0; op < 3; op++) {
+            sprintf(msg, "TESTCASE FAIL: index %zu: bgi_file_%s should succeed", i, names[op]);
+            bgi_assert(file_ops[op](path1, path2, out, tc.budget) == BGI_OK, msg);
+
+            BigInt *mapped = bgi_map(out);
+            BigInt *expect = memory_ops[op](bi1, bi2);
+            const char *mapped_text = bgi_get_text(mapped);
+            const char *expect_text = bgi_get_text(expect);
+            sprintf(msg, "TESTCASE FAIL: index %zu: bgi_file_%s differs from bgi_%s", i, names[op], names[op]);
+            bgi_assert(mapped_text != NULL && expect_text != NULL && strcmp(mapped_text, expect_text) == 0, msg);
+            bgi_free_text(mapped_text);
+            bgi_free_text(expect_text);
+            bgi_free(mapped);
+            bgi_free(expect);
+        }
+
+        // an output that is one of the inputs is refused before it is truncated
+        for (size_t op = 0; op < 3; op++) {
+            const char *outs[] = {path1, "./bigint_file_test_2.bgim"};
+            for (size_t t = 0; t < 2; t++) {
+                sprintf(msg, "TESTCASE FAIL: index %zu: bgi_file_%s into %s should give BGI_FILE_FAIL", i, names[op], outs[t]);
+                bgi_assert(file_ops[op](path1, path2, outs[t], tc.budget) == BGI_FILE_FAIL, msg);
+            }
+        }
+        BigInt *kept = bgi_map(path1);
+        sprintf(msg, "TESTCASE FAIL: index %zu: %s should keep its value", i, path1);
+        bgi_assert(kept->status_code == BGI_OK && bgi_cmp(kept, bi1) == 0, msg);
+        bgi_free(kept);
+
+        bgi_free(bi1);
+        bgi_free(bi2);
+
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    // only 9s give the largest ntt coefficients, the budget is below one row of
+    // the transform, so every pass works on its smallest panels
+    size_t nines_len = 30000;
+    char *nines = (char*)malloc(nines_len + 3);
+    nines[0] = '-';
+    memset(nines + 1, '9', nines_len);
+    nines[nines_len - 99] = '.';
+    nines[nines_len + 1] = '\0';
+    BigInt *bi1 = bgi_init(nines);
+    BigInt *bi2 = bgi_init(nines + 1);
+    bgi_save(bi1, path1);
+    bgi_save(bi2, path2);
+    sprintf(msg, "TESTCASE FAIL: bgi_file_mult of %zu nines should succeed", nines_len);
+    bgi_assert(bgi_file_mult(path1, path2, out, 0) == BGI_OK, msg);
+    BigInt *mapped = bgi_map(out);
+    BigInt *expect = bgi_mult(bi1, bi2);
+    sprintf(msg, "TESTCASE FAIL: bgi_file_mult of %zu nines differs from bgi_mult", nines_len);
+    bgi_assert(mapped->status_code == BGI_OK && bgi_cmp(mapped, expect) == 0, msg);
+    bgi_free(bi1);
+    bgi_free(bi2);
+    bgi_free(mapped);
+    bgi_free(expect);
+    free(nines);
+
+    remove(path1);
+    remove(path2);
+    remove(out);
+
+    int cmp = 0;
+    sprintf(msg, "TESTCASE FAIL: a missing file should give BGI_FILE_FAIL");
+    bgi_assert(bgi_file_cmp("bigint_file_test_missing.bgim", path1, 0, &cmp) == BGI_FILE_FAIL, msg);
+
+    printf("(TESTING) bgi_file_arithmetic_test (COMPLETED)\n\n");
+}
+
+void bgi_parser_test() {
+    printf("(TESTING) bgi_parser_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    const char *testcases[] = {
+        "0",
+        "-0",
+        "+000.000",
+        "007",
+        "-12.500",
+        "98765432109876543210.0000000001",
+        "-00000000000000000000000000000123456789012345678901234567890.5",
+        "-",
+        "12.",
+        ".5",
+        "-.5",
+        "1.2.3",
+        "12a4",
+        "+-1",
+        " 1",
+    };
+
+    size_t chunks[] = {1, 2, 3, 7, 1000};
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(const char*); i++) {
+        const char *text = testcases[i];
+        size_t len = strlen(text);
+
+        BigInt *expect = bgi_init(text);
+        const char *expect_text = bgi_get_text(expect);
+
+        for (size_t c = 0; c < sizeof(chunks)/sizeof(size_t); c++) {
+            BgiParser *parser = bgi_parser_new();
+            for (size_t start = 0; start < len; start += chunks[c]) {
+                size_t n = len - start < chunks[c] ? len - start : chunks[c];
+                bgi_parser_feed(parser, text + start, n);
+                bgi_parser_feed(parser, text + start, 0);
+            }
+            BigInt *bi = bgi_parser_finish(parser);
+
+            sprintf(msg, "TESTCASE FAIL: index %zu, chunk %zu: status should be %s, got %s", i, chunks[c], bgi_get_status_msg(expect), bgi_get_status_msg(bi));
+            bgi_assert(bi != NULL && bi->status_code == expect->status_code, msg);
+
+            if (expect->status_code == BGI_OK) {
+                const char *got = bgi_get_text(bi);
+                sprintf(msg, "TESTCASE FAIL: index %zu, chunk %zu: expect %s, got %s", i, chunks[c], expect_text, got);
+                bgi_assert(got != NULL && strcmp(got, expect_text) == 0, msg);
+                bgi_free_text(got);
+            }
+            bgi_free(bi);
+        }
+
+        bgi_free_text(expect_text);
+        bgi_free(expect);
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    // nothing fed is an empty text
+    BigInt *bi = bgi_parser_finish(bgi_parser_new());
+    sprintf(msg, "TESTCASE FAIL: an empty text should give BGI_INVALID_TEXT_VALUE");
+    bgi_assert(bi != NULL && bi->status_code == BGI_INVALID_TEXT_VALUE, msg);
+    bgi_free(bi);
+
+    // the first invalid character sticks, later chunks are ignored
+    BgiParser *parser = bgi_parser_new();
+    bgi_parser_feed(parser, "12", 2);
+    sprintf(msg, "TESTCASE FAIL: feed should report BGI_INVALID_TEXT_VALUE for 12x");
+    bgi_assert(bgi_parser_feed(parser, "x", 1) == BGI_INVALID_TEXT_VALUE, msg);
+    bgi_assert(bgi_parser_feed(parser, "34", 2) == BGI_INVALID_TEXT_VALUE, msg);
+    bgi_parser_free(parser);
+
+    printf("(TESTING) bgi_parser_test (COMPLETED)\n\n");
+}
+
+void bgi_format_test() {
+    printf("(TESTING) bgi_format_test (STARTED)\n");
+
+    char msg[1000] = {0};
+
+    typedef struct {
+        const char *text;
+        BgiFormat format;
+        const char *expect;
+    } Testcase;
+
+    Testcase testcases[] = {
+        (Testcase){.text="-12.5"                , .format={0}                                                  , .expect="-12.5"},
+        (Testcase){.text="0"                    , .format={.plus=true}                                         , .expect="+0"},
+        (Testcase){.text="1234567.891"          , .format={.group=','}                                         , .expect="1,234,567.891"},
+        (Testcase){.text="-123456"              , .format={.group=' ', .group_size=4}                          , .expect="-12 3456"},
+        (Testcase){.text="123"                  , .format={.group=','}                                         , .expect="123"},
+        (Testcase){.text="2.675"                , .format={.style=BGI_FORMAT_FIXED, .precision=2}              , .expect="2.68"},
+        (Testcase){.text="-2.674"               , .format={.style=BGI_FORMAT_FIXED, .precision=2}              , .expect="-2.67"},
+        (Testcase){.text="999.995"              , .format={.style=BGI_FORMAT_FIXED, .precision=2, .group=','}  , .expect="1,000.00"},
+        (Testcase){.text="-0.004"               , .format={.style=BGI_FORMAT_FIXED, .precision=2}              , .expect="0.00"},
+        (Testcase){.text="-0.5"                 , .format={.style=BGI_FORMAT_FIXED, .precision=0}              , .expect="-1"},
+        (Testcase){.text="7"                    , .format={.style=BGI_FORMAT_FIXED, .precision=3, .plus=true}  , .expect="+7.000"},
+        (Testcase){.text="123456789"            , .format={.style=BGI_FORMAT_SCIENTIFIC, .precision=5}         , .expect="1.2346e+8"},
+        (Testcase){.text="-0.000123"            , .format={.style=BGI_FORMAT_SCIENTIFIC, .precision=2}         , .expect="-1.2e-4"},
+        (Testcase){.text="99.96"                , .format={.style=BGI_FORMAT_SCIENTIFIC, .precision=3}         , .expect="1.00e+2"},
+        (Testcase){.text="0"                    , .format={.style=BGI_FORMAT_SCIENTIFIC, .precision=3}         , .expect="0.00e+0"},
+        (Testcase){.text="5"                    , .format={.style=BGI_FORMAT_SCIENTIFIC}                       , .expect="5e+0"},
+        (Testcase){.text="12.5"                 , .format={.style=BGI_FORMAT_SCIENTIFIC, .precision=6}         , .expect="1.25000e+1"},
+        (Testcase){.text="255"                  , .format={.base=16}                                           , .expect="ff"},
+        (Testcase){.text="-10"                  , .format={.base=2, .group='_', .group_size=4}                 , .expect="-1010"},
+        (Testcase){.text="18446744073709551616" , .format={.base=16, .group='_', .group_size=4}                , .expect="1_0000_0000_0000_0000"},
+        (Testcase){.text="123456789012345678901", .format={.base=36}                                           , .expect="q1ysz911ih2d1"},
+        (Testcase){.text="0"                    , .format={.base=7}                                            , .expect="0"},
+    };
+
+    for (size_t i = 0; i < sizeof(testcases)/sizeof(Testcase); i++) {
+        Testcase tc = testcases[i];
+
+        BigInt *bi = bgi_init(tc.text);
+        const char *text = bgi_format(bi, &tc.format);
+        sprintf(msg, "TESTCASE FAIL: index %zu: expect %s, got %s", i, tc.expect, text != NULL ? text : "NULL");
+        bgi_assert(text != NULL && strcmp(text, tc.expect) == 0, msg);
+
+        bgi_free_text(text);
+        bgi_free(bi);
+        printf("TESTCASES (%zu) PASSED...\n", i);
+    }
+
+    // other bases need an integer and the plain style
+    BigInt *bi = bgi_init("1.5");
+    BgiFormat hex = {.base=16};
+    sprintf(msg, "TESTCASE FAIL: a fraction in base 16 should give NULL");
+    bgi_assert(bgi_format(bi, &hex) == NULL, msg);
+    bgi_free(bi);
+
+    // a million digit value is summarized from its leading digits
+    char *digits = (char*)malloc(1000001);
+    memset(digits, '9', 1000000);
+    digits[0] = '1';
+    digits[1] = '2';
+    digits[1000000] = '\0';
+    bi = bgi_init(digits);
+    BgiFormat scientific = {.style=BGI_FORMAT_SCIENTIFIC, .precision=5};
+    const char *text = bgi_format(bi, &scientific);
+    sprintf(msg, "TESTCASE FAIL: expect 1.3000e+999999, got %s", text != NULL ? text : "NULL");
+    bgi_assert(text != NULL && strcmp(text, "1.3000e+999999") == 0, msg);
+    bgi_free_text(text);
+    bgi_free(bi);
+    free(digits);
+
+    printf("(TESTING) bgi_format_test (COMPLETED)\n\n");
 }
 
 int main(void) {
@@ -502,5 +2742,33 @@ int main(void) {
     bgi_add_test();
     bgi_sub_test();
     bgi_mult_test();
+    bgi_bitwise_test();
+    bgi_shift_test();
+    bgi_popcount_and_test_bit_test();
+    bgi_shift10_test();
+    bgi_shift10_limits_test();
+    bgi_get_text_test();
+    bgi_add_ui_and_bgi_mul_ui_test();
+    bgi_divmod_ui_test();
+    bgi_fac_binomial_primorial_test();
+    bgi_div_test();
+    bgi_series_sum_test();
+    bgi_clone_and_bgi_unshare_test();
+    bgi_shared_operands_test();
+    bgi_scratch_test();
+    bgi_accumulator_test();
+    bgi_parse_many_and_bgi_format_many_test();
+    bgi_async_test();
+    bgi_expr_test();
+    bgi_threshold_test();
+    bgi_div_newton_test();
+    bgi_stats_test();
+    bgi_trace_test();
+    bgi_set_allocator_test();
+    bgi_export_and_bgi_import_test();
+    bgi_save_and_bgi_map_test();
+    bgi_file_arithmetic_test();
+    bgi_parser_test();
+    bgi_format_test();
     return 0;
 }